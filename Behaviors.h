@@ -9,27 +9,203 @@
 // Includes & Forward Declarations
 //-----------------------------------------------------------------
 #include "EBehaviorTree.h"
+#include "EBehaviorCoroutine.h"
+#include "EBatchBehaviorTree.h"
+#include "EStaticBehaviorTree.h"
 #include "SteeringBehaviors.h"
 #include "IExamInterface.h"
 
+//-----------------------------------------------------------------
+// Blackboard Keys
+//-----------------------------------------------------------------
+// Resolved once in Plugin::Initialize, the behaviors below index the blackboard through these
+// instead of looking every entry up by name each tick.
+namespace BlackboardKeys
+{
+	Elite::BlackboardKey<AgentInfo> Agent;
+	Elite::BlackboardKey<IExamInterface*> Interface;
+	Elite::BlackboardKey<vector<HouseInfo>> Houses;
+	Elite::BlackboardKey<vector<EntityInfo>> Entities;
+	Elite::BlackboardKey<unsigned int> InventoryRevision; //Bumped whenever an action changes the inventory
+	Elite::BlackboardKey<Elite::Vector2> Target;
+	Elite::BlackboardKey<Elite::Vector2> FleeTarget;
+	Elite::BlackboardKey<EntityInfo> ItemTarget; //Written by SeekItems, the item GrabItem grabs
+	Elite::BlackboardKey<EntityInfo> EnemyTarget; //Written by FaceToClosestEnemy
+	Elite::BlackboardKey<HouseInfo> HouseTarget; //Nothing writes it since InsideHouse only reads
+	Elite::BlackboardKey<const HouseInfo*> ClosestHouse;
+	Elite::BlackboardKey<Seek*> Seek;
+	Elite::BlackboardKey<Wander*> Wander;
+	Elite::BlackboardKey<Flee*> Flee;
+	Elite::BlackboardKey<Arrive*> Arrive;
+	Elite::BlackboardKey<Face*> Face;
+	Elite::BlackboardKey<Scout*> Scout;
+	Elite::BlackboardKey<ISteeringBehavior*> Scouting;
+	Elite::BlackboardKey<ISteeringBehavior**> Steering;
+	Elite::BlackboardKey<ISteeringBehavior**> Angular;
+	Elite::BlackboardKey<Elite::BehaviorConditionCache*> ConditionCache;
+}
+
+void ResolveBlackboardKeys(Elite::Blackboard* pBlackboard)
+{
+	BlackboardKeys::Agent = pBlackboard->GetKey<AgentInfo>("Agent");
+	BlackboardKeys::Interface = pBlackboard->GetKey<IExamInterface*>("Interface");
+	BlackboardKeys::Houses = pBlackboard->GetKey<vector<HouseInfo>>("Houses");
+	BlackboardKeys::Entities = pBlackboard->GetKey<vector<EntityInfo>>("Entities");
+	BlackboardKeys::InventoryRevision = pBlackboard->GetKey<unsigned int>("InventoryRevision");
+	BlackboardKeys::Target = pBlackboard->GetKey<Elite::Vector2>("Target");
+	BlackboardKeys::FleeTarget = pBlackboard->GetKey<Elite::Vector2>("fleeTarget");
+	BlackboardKeys::ItemTarget = pBlackboard->GetKey<EntityInfo>("ItemTarget");
+	BlackboardKeys::EnemyTarget = pBlackboard->GetKey<EntityInfo>("EnemyTarget");
+	BlackboardKeys::HouseTarget = pBlackboard->GetKey<HouseInfo>("houseTarget");
+	BlackboardKeys::ClosestHouse = pBlackboard->GetKey<const HouseInfo*>("ClosestHouse");
+	BlackboardKeys::Seek = pBlackboard->GetKey<Seek*>("Seek");
+	BlackboardKeys::Wander = pBlackboard->GetKey<Wander*>("Wander");
+	BlackboardKeys::Flee = pBlackboard->GetKey<Flee*>("Flee");
+	BlackboardKeys::Arrive = pBlackboard->GetKey<Arrive*>("Arrive");
+	BlackboardKeys::Face = pBlackboard->GetKey<Face*>("Face");
+	BlackboardKeys::Scout = pBlackboard->GetKey<Scout*>("Scout");
+	BlackboardKeys::Scouting = pBlackboard->GetKey<ISteeringBehavior*>("Scouting");
+	BlackboardKeys::Steering = pBlackboard->GetKey<ISteeringBehavior**>("Steering");
+	BlackboardKeys::Angular = pBlackboard->GetKey<ISteeringBehavior**>("Angular");
+	BlackboardKeys::ConditionCache = pBlackboard->GetKey<Elite::BehaviorConditionCache*>("ConditionCache");
+}
+
+//-----------------------------------------------------------------
+// Condition Cache
+//-----------------------------------------------------------------
+// Checks that several behaviors share, evaluated at most once per tick through the tree's condition cache
+enum class eConditionTag : unsigned int
+{
+	HasMedkit,
+	HasFood,
+	HasPistol,
+	InventoryFull,
+	EnemyInFov,
+	ItemInFov
+};
+
+template<typename TCondition>
+bool EvaluateCachedCondition(Elite::Blackboard* pBlackboard, eConditionTag tag, TCondition condition)
+{
+	Elite::BehaviorConditionCache* pCache{};
+	if (!pBlackboard->TryGetData(BlackboardKeys::ConditionCache, pCache))
+		return condition();
+
+	return pCache->Evaluate(static_cast<unsigned int>(tag), condition);
+}
+
+void InvalidateCachedCondition(Elite::Blackboard* pBlackboard, eConditionTag tag)
+{
+	Elite::BehaviorConditionCache* pCache{};
+	if (pBlackboard->TryGetData(BlackboardKeys::ConditionCache, pCache))
+		pCache->Invalidate(static_cast<unsigned int>(tag));
+}
+
+// has to be called by every action that adds, uses or removes items
+void InvalidateInventoryConditions(Elite::Blackboard* pBlackboard)
+{
+	InvalidateCachedCondition(pBlackboard, eConditionTag::HasMedkit);
+	InvalidateCachedCondition(pBlackboard, eConditionTag::HasFood);
+	InvalidateCachedCondition(pBlackboard, eConditionTag::HasPistol);
+	InvalidateCachedCondition(pBlackboard, eConditionTag::InventoryFull);
+
+	// conditionals observing the inventory re-evaluate on the next tick
+	unsigned int revision{};
+	if (pBlackboard->TryGetData(BlackboardKeys::InventoryRevision, revision))
+		pBlackboard->TryChangeData(BlackboardKeys::InventoryRevision, revision + 1);
+}
+
+bool HasInventoryItem(Elite::Blackboard* pBlackboard, IExamInterface* pInterface, eItemType type, eConditionTag tag)
+{
+	return EvaluateCachedCondition(pBlackboard, tag, [pInterface, type]()
+	{
+		for (UINT i = 0; i < pInterface->Inventory_GetCapacity(); i++)
+		{
+			ItemInfo item{};
+			if (pInterface->Inventory_GetItem(i, item) && item.Type == type)
+			{
+				return true;
+			}
+		}
+		return false;
+	});
+}
+
 //-----------------------------------------------------------------
 // Behaviors
 //-----------------------------------------------------------------
 
+// TARGETS
+//--------
+// The conditionals observing the perception only read it, the actions that steer towards or away from
+// something look it up again and write the target themselves.
+
+// purge zone the agent stands in, the last one in the FOV
+bool FindSurroundingPurgeZone(Elite::Blackboard* pBlackboard, PurgeZoneInfo& zoneInfo)
+{
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
+	IExamInterface* pInterface{};
+
+	auto dataAvailable = pVEntetyInfo != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface) &&
+		pAgent != nullptr;
+
+	if (!dataAvailable)
+	{
+		return false;
+	}
+
+	for (auto& e : *pVEntetyInfo)
+	{
+		if (e.Type == eEntityType::PURGEZONE)
+		{
+			pInterface->PurgeZone_GetInfo(e, zoneInfo);
+		}
+	}
+
+	const float DangerRadius{ zoneInfo.Radius };
+	return DistanceSquared(pAgent->Position, zoneInfo.Center) < (DangerRadius * DangerRadius);
+}
+
+// closest entity of a type in the FOV, nullptr when there is none
+const EntityInfo* FindClosestEntityInFOV(Elite::Blackboard* pBlackboard, eEntityType type)
+{
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
+	if (pVEntetyInfo == nullptr || pAgent == nullptr)
+	{
+		return nullptr;
+	}
+
+	const EntityInfo* pClosest = nullptr;
+	float closestDistanceSquared = FLT_MAX;
+	for (const EntityInfo& entity : *pVEntetyInfo)
+	{
+		const float distanceSquared = DistanceSquared(pAgent->Position, entity.Location);
+		if (entity.Type == type && distanceSquared < closestDistanceSquared)
+		{
+			closestDistanceSquared = distanceSquared;
+			pClosest = &entity;
+		}
+	}
+	return pClosest;
+}
+
 // CONDITIONALS
 //-------------
 
 bool IsHouseInsideFOV(Elite::Blackboard* pBlackboard)
 {
-	vector<HouseInfo>* pVHouseInfo{};
+	const vector<HouseInfo>* pVHouseInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Houses);
 	IExamInterface* pInterface{};
 	Elite::Vector2 target{};
-	AgentInfo* pAgent{};
-	HouseInfo* currentHouse{};
-	auto dataAvailable = pBlackboard->GetData("Houses", pVHouseInfo) &&
-		pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("Target", target) &&
-		pBlackboard->GetData("Agent", pAgent);
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	const HouseInfo* currentHouse{};
+	auto dataAvailable = pVHouseInfo != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface) &&
+		pBlackboard->TryGetData(BlackboardKeys::Target, target) &&
+		pAgent != nullptr;
 	if (!dataAvailable)
 		return false;
 
@@ -38,7 +214,7 @@ bool IsHouseInsideFOV(Elite::Blackboard* pBlackboard)
 
 	// looking for the closed house
 	float distance = FLT_MAX;
-	for (HouseInfo& info : *pVHouseInfo)
+	for (const HouseInfo& info : *pVHouseInfo)
 	{
 		float houseDistance = Distance(pAgent->Position, info.Center);
 
@@ -53,8 +229,8 @@ bool IsHouseInsideFOV(Elite::Blackboard* pBlackboard)
 	// if there is a house around set it to the target value
 	if (distance != FLT_MAX)
 	{
-		pBlackboard->ChangeData("Target", target);
-		pBlackboard->ChangeData("ClosestHouse", currentHouse);
+		pBlackboard->TryChangeData(BlackboardKeys::Target, target);
+		pBlackboard->TryChangeData(BlackboardKeys::ClosestHouse, currentHouse);
 		return true;
 	}
 	return false;
@@ -62,15 +238,15 @@ bool IsHouseInsideFOV(Elite::Blackboard* pBlackboard)
 
 bool EntitieInsiteFOV(Elite::Blackboard* pBlackboard)
 {
-	vector<EntityInfo>* pVEntetyInfo{};
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
 	IExamInterface* pInterface{};
 	Elite::Vector2 target{};
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 	EntityInfo currentEntity{};
-	auto dataAvailable = pBlackboard->GetData("Entities", pVEntetyInfo) &&
-		pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("Target", target) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pVEntetyInfo != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface) &&
+		pBlackboard->TryGetData(BlackboardKeys::Target, target) &&
+		pAgent != nullptr;
 	if (!dataAvailable)
 		return false;
 
@@ -102,21 +278,21 @@ bool EntitieInsiteFOV(Elite::Blackboard* pBlackboard)
 		{
 		case eEntityType::PURGEZONE:
 			pInterface->PurgeZone_GetInfo(currentEntity, ClosestPurgeZone);
-			pBlackboard->ChangeData("ClosestPurgeZone", static_cast<PurgeZoneInfo>(ClosestPurgeZone));
+			pBlackboard->TryChangeData("ClosestPurgeZone", static_cast<PurgeZoneInfo>(ClosestPurgeZone));
 			break;
 		case eEntityType::ENEMY:
 			pInterface->Enemy_GetInfo(currentEntity, ClosestEnemy);
-			pBlackboard->ChangeData("ClosestEnemy", static_cast<EnemyInfo>(ClosestEnemy));
+			pBlackboard->TryChangeData("ClosestEnemy", static_cast<EnemyInfo>(ClosestEnemy));
 			break;
 		case eEntityType::ITEM:
 			pInterface->Item_GetInfo(currentEntity, ClosestItem);
-			pBlackboard->ChangeData("ClosestItem", static_cast<ItemInfo>(ClosestItem));
+			pBlackboard->TryChangeData("ClosestItem", static_cast<ItemInfo>(ClosestItem));
 			break;
 		default:
 			std::cout << "Unown entity" << std::endl;
 			break;
 		}
-		pBlackboard->ChangeData("Target", target);
+		pBlackboard->TryChangeData(BlackboardKeys::Target, target);
 		return true;
 	}
 	return false;
@@ -125,11 +301,11 @@ bool EntitieInsiteFOV(Elite::Blackboard* pBlackboard)
 bool IsEnemyClose(Elite::Blackboard* pBlackboard)
 {
 	Elite::Vector2 target{};
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 	EnemyInfo closestEnemy{};
-	auto dataAvailable = pBlackboard->GetData("ClosestEnemy", closestEnemy) &&
-		pBlackboard->GetData("Target", target) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pBlackboard->TryGetData("ClosestEnemy", closestEnemy) &&
+		pBlackboard->TryGetData(BlackboardKeys::Target, target) &&
+		pAgent != nullptr;
 	if (!dataAvailable)
 		return false;
 
@@ -140,7 +316,7 @@ bool IsEnemyClose(Elite::Blackboard* pBlackboard)
 	if (DistanceSquared(pAgent->Position, closestEnemy.Location) < (DangerRadius * DangerRadius) &&
 		(closestEnemy.Size / 2.f) > (pAgent->AgentSize / 2.f))
 	{
-		pBlackboard->ChangeData("Target", closestEnemy.Location);
+		pBlackboard->TryChangeData(BlackboardKeys::Target, closestEnemy.Location);
 		return true;
 	}
 
@@ -150,11 +326,11 @@ bool IsEnemyClose(Elite::Blackboard* pBlackboard)
 bool IsItemClose(Elite::Blackboard* pBlackboard)
 {
 	Elite::Vector2 target{};
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 	ItemInfo closestItem{};
-	auto dataAvailable = pBlackboard->GetData("ClosestItem", closestItem) &&
-		pBlackboard->GetData("Target", target) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pBlackboard->TryGetData("ClosestItem", closestItem) &&
+		pBlackboard->TryGetData(BlackboardKeys::Target, target) &&
+		pAgent != nullptr;
 	if (!dataAvailable)
 		return false;
 
@@ -164,7 +340,7 @@ bool IsItemClose(Elite::Blackboard* pBlackboard)
 	const float DangerRadius{ 10.f };
 	if (DistanceSquared(pAgent->Position, closestItem.Location) < (DangerRadius * DangerRadius))
 	{
-		pBlackboard->ChangeData("Target", closestItem.Location);
+		pBlackboard->TryChangeData(BlackboardKeys::Target, closestItem.Location);
 		return true;
 	}
 
@@ -174,11 +350,11 @@ bool IsItemClose(Elite::Blackboard* pBlackboard)
 // use items
 bool shouldUseMedkit(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Agent", pAgent) &&
-		pBlackboard->GetData("Interface", pInterface);
+	auto dataAvailable = pAgent != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface);
 
 	if (!dataAvailable)
 	{
@@ -191,28 +367,16 @@ bool shouldUseMedkit(Elite::Blackboard* pBlackboard)
 	}
 
 	// search for a medkit in inverntory
-	for (UINT i = 0; i < pInterface->Inventory_GetCapacity(); i++)
-	{
-		ItemInfo item{};
-		if (pInterface->Inventory_GetItem(i, item))
-		{
-			if (item.Type == eItemType::MEDKIT)
-			{
-				return Elite::BehaviorState::Success;
-			}
-		}
-	}
-
-	return Elite::BehaviorState::Failure;
+	return HasInventoryItem(pBlackboard, pInterface, eItemType::MEDKIT, eConditionTag::HasMedkit);
 }
 
 bool shouldUseFood(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Agent", pAgent) &&
-		pBlackboard->GetData("Interface", pInterface);
+	auto dataAvailable = pAgent != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface);
 
 	if (!dataAvailable)
 	{
@@ -224,63 +388,23 @@ bool shouldUseFood(Elite::Blackboard* pBlackboard)
 		return Elite::BehaviorState::Failure;
 	}
 
-	// search for a medkit in inverntory
-	for (UINT i = 0; i < pInterface->Inventory_GetCapacity(); i++)
-	{
-		ItemInfo item{};
-		if (pInterface->Inventory_GetItem(i, item))
-		{
-			if (item.Type == eItemType::FOOD)
-			{
-				return Elite::BehaviorState::Success;
-			}
-		}
-	}
-
-	return Elite::BehaviorState::Failure;
+	// search for food in inverntory
+	return HasInventoryItem(pBlackboard, pInterface, eItemType::FOOD, eConditionTag::HasFood);
 }
 
 // purgeZone
 bool InPurgeZone(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
-	vector<EntityInfo>* pVEntetyInfo{};
-	IExamInterface* pInterface{};
-
-	auto dataAvailable = pBlackboard->GetData("Entities", pVEntetyInfo) &&
-		pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("Agent", pAgent);
-
-	if (!dataAvailable)
-	{
-		return Elite::BehaviorState::Failure;
-	}
-
-	PurgeZoneInfo zoneInfo;
-	for (auto& e : *pVEntetyInfo)
-	{
-		if (e.Type == eEntityType::PURGEZONE)
-		{
-			pInterface->PurgeZone_GetInfo(e, zoneInfo);
-		}
-	}
-
-	const float DangerRadius{ zoneInfo.Radius };
-	if (DistanceSquared(pAgent->Position, zoneInfo.Center) < (DangerRadius * DangerRadius))
-	{
-		pBlackboard->ChangeData("fleeTarget", zoneInfo.Center);
-		return Elite::BehaviorState::Success;
-	}
-
-	return Elite::BehaviorState::Failure;
+	PurgeZoneInfo zoneInfo{};
+	return FindSurroundingPurgeZone(pBlackboard, zoneInfo);
 }
 
 // enemy
 bool AgentBittenHasStamina(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 
-	auto dataAvailable = pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pAgent != nullptr;
 
 	if (!dataAvailable)
 	{
@@ -299,61 +423,46 @@ bool AgentBittenHasStamina(Elite::Blackboard* pBlackboard)
 	return Elite::BehaviorState::Success;
 }
 
+// the closest enemy, the one FaceToClosestEnemy then faces and writes to EnemyTarget.
+// it used to be the first one in the FOV, written here, but an observing conditional only reads:
+// while its keys don't change it isn't evaluated and wouldn't write either
 bool EnemyInFOV(Elite::Blackboard* pBlackboard)
 {
-	vector<EntityInfo>* pVEntetyInfo{};
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
 
-	auto dataAvailable = pBlackboard->GetData("Entities", pVEntetyInfo);
+	auto dataAvailable = pVEntetyInfo != nullptr;
 
 	if (!dataAvailable)
 	{
 		return Elite::BehaviorState::Failure;
 	}
 
-	for (const EntityInfo& entity : *pVEntetyInfo)
+	return EvaluateCachedCondition(pBlackboard, eConditionTag::EnemyInFov, [pBlackboard]()
 	{
-		if (entity.Type == eEntityType::ENEMY)
-		{
-			pBlackboard->ChangeData("EnemyTarget", entity);
-			return Elite::BehaviorState::Success;
-		}
-	}
-
-	return Elite::BehaviorState::Failure;
+		return FindClosestEntityInFOV(pBlackboard, eEntityType::ENEMY) != nullptr;
+	});
 }
 
 bool CanKillEnemy(Elite::Blackboard* pBlackboard)
 {
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Interface", pInterface);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface);
 
 	if (!dataAvailable)
 	{
 		return Elite::BehaviorState::Failure;
 	}
 
-	// search for a medkit in inverntory
-	for (UINT i = 0; i < pInterface->Inventory_GetCapacity(); i++)
-	{
-		ItemInfo item{};
-		if (pInterface->Inventory_GetItem(i, item))
-		{
-			if (item.Type == eItemType::PISTOL)
-			{
-				return Elite::BehaviorState::Success;
-			}
-		}
-	}
-
-	return Elite::BehaviorState::Failure;
+	// search for a pistol in inverntory
+	return HasInventoryItem(pBlackboard, pInterface, eItemType::PISTOL, eConditionTag::HasPistol);
 }
 
 bool HasStamina(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 
-	auto dataAvailable = pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pAgent != nullptr;
 
 	if (!dataAvailable)
 	{
@@ -371,13 +480,13 @@ bool HasStamina(Elite::Blackboard* pBlackboard)
 // not done!!!
 bool canHitEnemy(Elite::Blackboard* pBlackboard)
 {
-	vector<EntityInfo>* pVEntetyInfo{};
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
 	IExamInterface* pInterface{};
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 
-	auto dataAvailable = pBlackboard->GetData("Entities", pVEntetyInfo) &&
-		pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pVEntetyInfo != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface) &&
+		pAgent != nullptr;
 
 	if (!dataAvailable)
 	{
@@ -385,17 +494,9 @@ bool canHitEnemy(Elite::Blackboard* pBlackboard)
 	}
 
 	// search for a pistol in inverntory
-	bool hasGun{};
-	for (UINT i = 0; i < pInterface->Inventory_GetCapacity(); i++)
+	if (!HasInventoryItem(pBlackboard, pInterface, eItemType::PISTOL, eConditionTag::HasPistol))
 	{
-		ItemInfo item{};
-		if (pInterface->Inventory_GetItem(i, item))
-		{
-			if (item.Type == eItemType::PISTOL)
-			{
-				hasGun = true;
-			}
-		}
+		return Elite::BehaviorState::Failure;
 	}
 
 	// facing enemy????
@@ -406,41 +507,43 @@ bool canHitEnemy(Elite::Blackboard* pBlackboard)
 // get items
 bool InventoryFull(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
-	vector<EntityInfo>* pVEntetyInfo{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Entities", pVEntetyInfo) &&
-		pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pVEntetyInfo != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface) &&
+		pAgent != nullptr;
 
 	if (!dataAvailable)
 	{
 		return Elite::BehaviorState::Failure;
 	}
 
-	// search for a pistol in inverntory
-	for (UINT i = 0; i < pInterface->Inventory_GetCapacity(); i++)
+	// look for an empty slot in inverntory
+	return EvaluateCachedCondition(pBlackboard, eConditionTag::InventoryFull, [pInterface]()
 	{
-		ItemInfo item{};
-		if (pInterface->Inventory_GetItem(i, item) == false)
+		for (UINT i = 0; i < pInterface->Inventory_GetCapacity(); i++)
 		{
-			return Elite::BehaviorState::Failure;
+			ItemInfo item{};
+			if (pInterface->Inventory_GetItem(i, item) == false)
+			{
+				return false;
+			}
 		}
-	}
-
-	return Elite::BehaviorState::Success;
+		return true;
+	});
 }
 
 bool InGrabRange(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
-	vector<EntityInfo>* pVEntetyInfo{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Entities", pVEntetyInfo) &&
-		pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pVEntetyInfo != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface) &&
+		pAgent != nullptr;
 
 	if (!dataAvailable)
 	{
@@ -465,45 +568,38 @@ bool InGrabRange(Elite::Blackboard* pBlackboard)
 	return Elite::BehaviorState::Failure;
 }
 
+// the closest item, the one SeekItems then seeks and writes to ItemTarget.
+// it used to be the first one in the FOV, written here, see EnemyInFOV
 bool ItemInFov(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
-	vector<EntityInfo>* pVEntetyInfo{};
-	IExamInterface* pInterface{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
 
-	auto dataAvailable = pBlackboard->GetData("Entities", pVEntetyInfo) &&
-		pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pVEntetyInfo != nullptr &&
+		pAgent != nullptr;
 
 	if (!dataAvailable)
 	{
 		return Elite::BehaviorState::Failure;
 	}
 
-	ItemInfo item;
-	for (auto& e : *pVEntetyInfo)
+	return EvaluateCachedCondition(pBlackboard, eConditionTag::ItemInFov, [pBlackboard]()
 	{
-		if (e.Type == eEntityType::ITEM)
-		{
-			pInterface->Item_GetInfo(e, item);
-			pBlackboard->ChangeData("ItemTarget", item);
-			return Elite::BehaviorState::Success;
-		}
-	}
-
-	return Elite::BehaviorState::Failure;
+		return FindClosestEntityInFOV(pBlackboard, eEntityType::ITEM) != nullptr;
+	});
 }
 
 // inside house
+// doesn't write houseTarget anymore, nothing read it and an observing conditional only reads, see EnemyInFOV
 bool InsideHouse(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
-	vector<HouseInfo>* pVHouseInfo{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	const vector<HouseInfo>* pVHouseInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Houses);
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Houses", pVHouseInfo) &&
-		pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pVHouseInfo != nullptr &&
+		pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface) &&
+		pAgent != nullptr;
 
 	if (!dataAvailable)
 	{
@@ -518,7 +614,6 @@ bool InsideHouse(Elite::Blackboard* pBlackboard)
 		const float distance{ DistanceSquared(pAgent->Position, h.Center) };
 		if (DistanceSquared(pAgent->Position, h.Center) < DangerRadius.x)
 		{
-			pBlackboard->ChangeData("houseTarget", h);
 			return Elite::BehaviorState::Success;
 		}
 	}
@@ -529,9 +624,9 @@ bool InsideHouse(Elite::Blackboard* pBlackboard)
 // standert things
 bool LowStamina(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
 
-	auto dataAvailable = pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pAgent != nullptr;
 
 	if (!dataAvailable)
 	{
@@ -546,6 +641,55 @@ bool LowStamina(Elite::Blackboard* pBlackboard)
 	return Elite::BehaviorState::Success;
 }
 
+// UTILITY INPUTS
+//---------------
+float AgentHealth(Elite::Blackboard* pBlackboard)
+{
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	return pAgent != nullptr ? pAgent->Health : 0.f;
+}
+
+float AgentStamina(Elite::Blackboard* pBlackboard)
+{
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	return pAgent != nullptr ? pAgent->Stamina : 0.f;
+}
+
+// distance to the closest entity of a type in the FOV, the FOV range when there is none
+float ClosestEntityDistance(Elite::Blackboard* pBlackboard, eEntityType type)
+{
+	const AgentInfo* pAgent = pBlackboard->TryGetDataPtr(BlackboardKeys::Agent);
+	const vector<EntityInfo>* pVEntetyInfo = pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
+
+	auto dataAvailable = pVEntetyInfo != nullptr && pAgent != nullptr;
+
+	if (!dataAvailable)
+	{
+		return 0.f;
+	}
+
+	float closestDistanceSquared{ pAgent->FOV_Range * pAgent->FOV_Range };
+	for (const EntityInfo& entity : *pVEntetyInfo)
+	{
+		if (entity.Type == type)
+		{
+			closestDistanceSquared = std::min(closestDistanceSquared, DistanceSquared(pAgent->Position, entity.Location));
+		}
+	}
+
+	return sqrtf(closestDistanceSquared);
+}
+
+float ClosestEnemyDistance(Elite::Blackboard* pBlackboard)
+{
+	return ClosestEntityDistance(pBlackboard, eEntityType::ENEMY);
+}
+
+float ClosestItemDistance(Elite::Blackboard* pBlackboard)
+{
+	return ClosestEntityDistance(pBlackboard, eEntityType::ITEM);
+}
+
 // ACTIONS
 //--------
 
@@ -554,9 +698,9 @@ Elite::BehaviorState ChangeToSeek(Elite::Blackboard* pBlackboard)
 	Seek* pSeek = nullptr;
 	ISteeringBehavior** ppSteering = nullptr;
 	Elite::Vector2 seekTarget{};
-	auto dataAvailable = pBlackboard->GetData("Seek", pSeek) &&
-		pBlackboard->GetData("Steering", ppSteering) &&
-		pBlackboard->GetData("Target", seekTarget);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Seek, pSeek) &&
+		pBlackboard->TryGetData(BlackboardKeys::Steering, ppSteering) &&
+		pBlackboard->TryGetData(BlackboardKeys::Target, seekTarget);
 
 	if (!dataAvailable)
 	{
@@ -575,10 +719,10 @@ Elite::BehaviorState ChangeToWander(Elite::Blackboard* pBlackboard)
 	ISteeringBehavior* pScouting = nullptr;
 	ISteeringBehavior** ppSteering = nullptr;
 	ISteeringBehavior** ppAngular = nullptr;
-	auto dataAvailable = pBlackboard->GetData("Wander", pWander) &&
-		pBlackboard->GetData("Scouting", pScouting) &&
-		pBlackboard->GetData("Steering", ppSteering) &&
-		pBlackboard->GetData("Angular", ppAngular);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Wander, pWander) &&
+		pBlackboard->TryGetData(BlackboardKeys::Scouting, pScouting) &&
+		pBlackboard->TryGetData(BlackboardKeys::Steering, ppSteering) &&
+		pBlackboard->TryGetData(BlackboardKeys::Angular, ppAngular);
 
 	if (!dataAvailable)
 	{
@@ -596,9 +740,9 @@ Elite::BehaviorState ChangeToArrive(Elite::Blackboard* pBlackboard)
 	Arrive* pArrive = nullptr;
 	ISteeringBehavior** ppSteering = nullptr;
 	Elite::Vector2 ArriveTarget{};
-	auto dataAvailable = pBlackboard->GetData("Arrive", pArrive) &&
-		pBlackboard->GetData("Steering", ppSteering) &&
-		pBlackboard->GetData("Target", ArriveTarget);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Arrive, pArrive) &&
+		pBlackboard->TryGetData(BlackboardKeys::Steering, ppSteering) &&
+		pBlackboard->TryGetData(BlackboardKeys::Target, ArriveTarget);
 
 	if (!dataAvailable)
 	{
@@ -616,7 +760,7 @@ Elite::BehaviorState UseMedkit(Elite::Blackboard* pBlackboard)
 {
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Interface", pInterface);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface);
 
 	if (!dataAvailable)
 	{
@@ -632,6 +776,7 @@ Elite::BehaviorState UseMedkit(Elite::Blackboard* pBlackboard)
 			if (item.Type == eItemType::MEDKIT)
 			{
 				pInterface->Inventory_UseItem(i);
+				InvalidateInventoryConditions(pBlackboard);
 				return Elite::BehaviorState::Success;
 			}
 		}
@@ -644,7 +789,7 @@ Elite::BehaviorState UseFood(Elite::Blackboard* pBlackboard)
 {
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Interface", pInterface);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface);
 
 	if (!dataAvailable)
 	{
@@ -660,6 +805,7 @@ Elite::BehaviorState UseFood(Elite::Blackboard* pBlackboard)
 			if (item.Type == eItemType::FOOD)
 			{
 				pInterface->Inventory_UseItem(i);
+				InvalidateInventoryConditions(pBlackboard);
 				return Elite::BehaviorState::Success;
 			}
 		}
@@ -673,17 +819,19 @@ Elite::BehaviorState ChangeToFlee(Elite::Blackboard* pBlackboard)
 {
 	Flee* pFlee = nullptr;
 	ISteeringBehavior** ppSteering = nullptr;
-	Elite::Vector2 FleeTarget{};
-	auto dataAvailable = pBlackboard->GetData("Flee", pFlee) &&
-		pBlackboard->GetData("Steering", ppSteering) &&
-		pBlackboard->GetData("fleeTarget", FleeTarget);
+	PurgeZoneInfo zoneInfo{};
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Flee, pFlee) &&
+		pBlackboard->TryGetData(BlackboardKeys::Steering, ppSteering) &&
+		FindSurroundingPurgeZone(pBlackboard, zoneInfo);
 
 	if (!dataAvailable)
 	{
 		return Elite::BehaviorState::Failure;
 	}
 
-	pFlee->SetTargetPos(FleeTarget);
+	// RunFlee keeps fleeing the last zone
+	pBlackboard->TryChangeData(BlackboardKeys::FleeTarget, zoneInfo.Center);
+	pFlee->SetTargetPos(zoneInfo.Center);
 	*ppSteering = pFlee;
 
 	return Elite::BehaviorState::Success;
@@ -694,13 +842,13 @@ Elite::BehaviorState RunFlee(Elite::Blackboard* pBlackboard)
 {
 	Flee* pFlee = nullptr;
 	ISteeringBehavior** ppSteering = nullptr;
-	AgentInfo* pAgent{};
+	AgentInfo agent{};
 	Elite::Vector2 FleeTarget{};
 
-	auto dataAvailable = pBlackboard->GetData("Flee", pFlee) &&
-		pBlackboard->GetData("Steering", ppSteering) &&
-		pBlackboard->GetData("fleeTarget", FleeTarget) &&
-		pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Flee, pFlee) &&
+		pBlackboard->TryGetData(BlackboardKeys::Steering, ppSteering) &&
+		pBlackboard->TryGetData(BlackboardKeys::FleeTarget, FleeTarget) &&
+		pBlackboard->TryGetData(BlackboardKeys::Agent, agent);
 
 	if (!dataAvailable)
 	{
@@ -712,8 +860,8 @@ Elite::BehaviorState RunFlee(Elite::Blackboard* pBlackboard)
 	*ppSteering = pFlee;
 
 	// run
-	pAgent->RunMode = true;
-	pBlackboard->ChangeData("Agent", pAgent);
+	agent.RunMode = true;
+	pBlackboard->TryChangeData(BlackboardKeys::Agent, agent);
 
 	return Elite::BehaviorState::Success;
 }
@@ -722,17 +870,18 @@ Elite::BehaviorState FaceToClosestEnemy(Elite::Blackboard* pBlackboard)
 {
 	Face* pFace = nullptr;
 	ISteeringBehavior** ppAngular = nullptr;
-	EntityInfo FaceTarget{};
-	auto dataAvailable = pBlackboard->GetData("Face", pFace) &&
-		pBlackboard->GetData("Angular", ppAngular) &&
-		pBlackboard->GetData("EnemyTarget", FaceTarget);
+	const EntityInfo* pFaceTarget = FindClosestEntityInFOV(pBlackboard, eEntityType::ENEMY);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Face, pFace) &&
+		pBlackboard->TryGetData(BlackboardKeys::Angular, ppAngular) &&
+		pFaceTarget != nullptr;
 
 	if (!dataAvailable)
 	{
 		return Elite::BehaviorState::Failure;
 	}
 
-	pFace->SetTargetPos(FaceTarget.Location);
+	pBlackboard->TryChangeData(BlackboardKeys::EnemyTarget, *pFaceTarget);
+	pFace->SetTargetPos(pFaceTarget->Location);
 	*ppAngular = pFace;
 
 	return Elite::BehaviorState::Success;
@@ -742,7 +891,7 @@ Elite::BehaviorState ShootClosestEnemy(Elite::Blackboard* pBlackboard)
 {
 	IExamInterface* pInterface{};
 
-	auto dataAvailable = pBlackboard->GetData("Interface", pInterface);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface);
 
 	if (!dataAvailable)
 	{
@@ -763,7 +912,8 @@ Elite::BehaviorState ShootClosestEnemy(Elite::Blackboard* pBlackboard)
 			if (item.Type == eItemType::PISTOL)
 			{
 				pInterface->Inventory_UseItem(i);
-				Elite::BehaviorState::Success;
+				InvalidateInventoryConditions(pBlackboard);
+				return Elite::BehaviorState::Success;
 			}
 		}
 	}
@@ -776,17 +926,19 @@ Elite::BehaviorState SeekItems(Elite::Blackboard* pBlackboard)
 {
 	Seek* pSeek = nullptr;
 	ISteeringBehavior** ppSteering = nullptr;
-	EntityInfo seekTarget{};
-	auto dataAvailable = pBlackboard->GetData("Seek", pSeek) &&
-		pBlackboard->GetData("Steering", ppSteering) &&
-		pBlackboard->GetData("ItemTarget", seekTarget);
+	const EntityInfo* pSeekTarget = FindClosestEntityInFOV(pBlackboard, eEntityType::ITEM);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Seek, pSeek) &&
+		pBlackboard->TryGetData(BlackboardKeys::Steering, ppSteering) &&
+		pSeekTarget != nullptr;
 
 	if (!dataAvailable)
 	{
 		return Elite::BehaviorState::Failure;
 	}
 
-	pSeek->SetTargetPos(seekTarget.Location);
+	// GrabItem grabs what was sought
+	pBlackboard->TryChangeData(BlackboardKeys::ItemTarget, *pSeekTarget);
+	pSeek->SetTargetPos(pSeekTarget->Location);
 	*ppSteering = pSeek;
 
 	return Elite::BehaviorState::Success;
@@ -795,10 +947,10 @@ Elite::BehaviorState SeekItems(Elite::Blackboard* pBlackboard)
 Elite::BehaviorState GrabItem(Elite::Blackboard* pBlackboard)
 {
 	IExamInterface* pInterface{};
-	EntityInfo target{};
+	const EntityInfo* pTarget = pBlackboard->TryGetDataPtr(BlackboardKeys::ItemTarget);
 
-	auto dataAvailable = pBlackboard->GetData("Interface", pInterface) &&
-		pBlackboard->GetData("ItemTarget", target);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Interface, pInterface) &&
+		pTarget != nullptr;
 
 	if (!dataAvailable)
 	{
@@ -806,8 +958,11 @@ Elite::BehaviorState GrabItem(Elite::Blackboard* pBlackboard)
 	}
 
 	ItemInfo item{};
-	if (pInterface->Item_Grab(target, item))
+	if (pInterface->Item_Grab(*pTarget, item))
 	{
+		InvalidateInventoryConditions(pBlackboard);
+		InvalidateCachedCondition(pBlackboard, eConditionTag::ItemInFov);
+
 		// for now first 3 slots
 		switch (item.Type)
 		{
@@ -835,16 +990,17 @@ Elite::BehaviorState GrabItem(Elite::Blackboard* pBlackboard)
 // standert things
 Elite::BehaviorState StopRunning(Elite::Blackboard* pBlackboard)
 {
-	AgentInfo* pAgent{};
+	AgentInfo agent{};
 
-	auto dataAvailable = pBlackboard->GetData("Agent", pAgent);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Agent, agent);
 
 	if (!dataAvailable)
 	{
 		return Elite::BehaviorState::Failure;
 	}
 
-	pAgent->RunMode = false;
+	agent.RunMode = false;
+	pBlackboard->TryChangeData(BlackboardKeys::Agent, agent);
 
 	return Elite::BehaviorState::Success;
 }
@@ -855,10 +1011,10 @@ Elite::BehaviorState ScoutWander(Elite::Blackboard* pBlackboard)
 	Scout* pScouting = nullptr;
 	ISteeringBehavior** ppSteering = nullptr;
 	ISteeringBehavior** ppAngular = nullptr;
-	auto dataAvailable = pBlackboard->GetData("Wander", pWander) &&
-		pBlackboard->GetData("Scout", pScouting) &&
-		pBlackboard->GetData("Steering", ppSteering) &&
-		pBlackboard->GetData("Angular", ppAngular);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Wander, pWander) &&
+		pBlackboard->TryGetData(BlackboardKeys::Scout, pScouting) &&
+		pBlackboard->TryGetData(BlackboardKeys::Steering, ppSteering) &&
+		pBlackboard->TryGetData(BlackboardKeys::Angular, ppAngular);
 
 	if (!dataAvailable)
 	{
@@ -875,8 +1031,8 @@ Elite::BehaviorState Radar(Elite::Blackboard* pBlackboard)
 {
 	Scout* pScouting = nullptr;
 	ISteeringBehavior** ppAngular = nullptr;
-	auto dataAvailable = pBlackboard->GetData("Scout", pScouting) &&
-		pBlackboard->GetData("Angular", ppAngular);
+	auto dataAvailable = pBlackboard->TryGetData(BlackboardKeys::Scout, pScouting) &&
+		pBlackboard->TryGetData(BlackboardKeys::Angular, ppAngular);
 
 	if (!dataAvailable)
 	{
@@ -887,4 +1043,330 @@ Elite::BehaviorState Radar(Elite::Blackboard* pBlackboard)
 
 	return Elite::BehaviorState::Success;
 }
+
+// COROUTINE ACTIONS
+//------------------
+
+// seeks the item until it's in grab range, then grabs it, continuing where it was every tick the tree gets here
+Elite::BehaviorTask LootItem(Elite::Blackboard* pBlackboard)
+{
+	while (!InGrabRange(pBlackboard))
+	{
+		if (SeekItems(pBlackboard) == Elite::BehaviorState::Failure)
+		{
+			co_return Elite::BehaviorState::Failure;
+		}
+		co_await Elite::NextTick{};
+	}
+
+	co_return co_await Elite::RunAction{ GrabItem };
+}
+
+//-----------------------------------------------------------------
+// Behavior Tree
+//-----------------------------------------------------------------
+// The tree Plugin::Initialize decides with. The conditionals observe the keys ResolveBlackboardKeys resolved, so
+// they have to be resolved first. Compiled, none of its nodes keeps state of its own, so every agent can run one
+// BehaviorTreeDefinition of it.
+Elite::IBehavior* CreateExamBehavior()
+{
+	return new Elite::BehaviorSelector(
+		{
+			new Elite::BehaviorSequence(
+			{
+				new Elite::BehaviorConditional(shouldUseMedkit, Elite::ObserveKeys(BlackboardKeys::Agent, BlackboardKeys::InventoryRevision)),
+				new Elite::BehaviorCooldown(new Elite::BehaviorAction(UseMedkit), 1.f) // one use per second, so the next tick doesn't use another before this one shows
+			}),
+			new Elite::BehaviorSequence(
+			{
+				new Elite::BehaviorConditional(shouldUseFood, Elite::ObserveKeys(BlackboardKeys::Agent, BlackboardKeys::InventoryRevision)),
+				new Elite::BehaviorCooldown(new Elite::BehaviorAction(UseFood), 1.f)
+			}),
+			new Elite::BehaviorSequence(
+			{
+				new Elite::BehaviorConditional(InPurgeZone, Elite::ObserveKeys(BlackboardKeys::Agent, BlackboardKeys::Entities)),
+				new Elite::BehaviorAction(ChangeToFlee)
+			}),
+			new Elite::BehaviorSequence(
+			{
+				new Elite::BehaviorConditional(LowStamina, Elite::ObserveKeys(BlackboardKeys::Agent)),
+				new Elite::BehaviorAction(StopRunning)
+			}),
+			new Elite::BehaviorSequence(
+			{
+				new Elite::BehaviorConditional(AgentBittenHasStamina, Elite::ObserveKeys(BlackboardKeys::Agent)),
+				new Elite::BehaviorAction(RunFlee)
+			}),
+			new Elite::BehaviorSequence(
+			{
+				new Elite::BehaviorConditional(InventoryFull, Elite::ObserveKeys(BlackboardKeys::InventoryRevision)),
+				new Elite::BehaviorCoroutine(LootItem) // add seek to house
+			}),
+			new Elite::BehaviorSequence(
+			{
+				new Elite::BehaviorConditional(InsideHouse, Elite::ObserveKeys(BlackboardKeys::Agent, BlackboardKeys::Houses)),
+				new Elite::BehaviorSelector(
+				{
+					new Elite::BehaviorAction(ScoutWander),
+					new Elite::BehaviorSequence(
+					{
+						new Elite::BehaviorConditional(ItemInFov, Elite::ObserveKeys(BlackboardKeys::Entities)),
+						new Elite::BehaviorAction(SeekItems)
+					}),
+				})
+			}),
+			new Elite::BehaviorSequence(
+			{
+				new Elite::BehaviorConditional(EnemyInFOV, Elite::ObserveKeys(BlackboardKeys::Entities)),
+				new Elite::BehaviorSelector(
+				{
+					new Elite::BehaviorSequence(
+					{
+						new Elite::BehaviorConditional(CanKillEnemy, Elite::ObserveKeys(BlackboardKeys::InventoryRevision)),
+						new Elite::BehaviorSelector(
+						{
+							new Elite::BehaviorSequence(
+							{
+								new Elite::BehaviorConditional(canHitEnemy, Elite::ObserveKeys(BlackboardKeys::Agent, BlackboardKeys::Entities, BlackboardKeys::InventoryRevision)),
+								new Elite::BehaviorCooldown(new Elite::BehaviorAction(ShootClosestEnemy), 0.5f) // every shot costs ammo, no more than two a second
+							}),
+							new Elite::BehaviorAction(FaceToClosestEnemy)
+						})
+					}),
+					new Elite::BehaviorSequence(
+					{
+						new Elite::BehaviorConditional(HasStamina, Elite::ObserveKeys(BlackboardKeys::Agent)),
+						new Elite::BehaviorAction(RunFlee)
+					})
+				})
+			}),
+			new Elite::BehaviorAction(ScoutWander)
+		});
+}
+
+//-----------------------------------------------------------------
+// Static Tree
+//-----------------------------------------------------------------
+// Same tree as CreateExamBehavior builds, as a single template type (see EStaticBehaviorTree.h).
+// LootItem is spelled out as the nodes it replaces there, the cooldowns are the same (in milliseconds).
+namespace ExamStaticTree
+{
+	using namespace Elite::StaticBT;
+
+	using Root = Selector<
+		Sequence<Cond<shouldUseMedkit>, Cooldown<Act<UseMedkit>, 1000>>,
+		Sequence<Cond<shouldUseFood>, Cooldown<Act<UseFood>, 1000>>,
+		Sequence<Cond<InPurgeZone>, Act<ChangeToFlee>>,
+		Sequence<Cond<LowStamina>, Act<StopRunning>>,
+		Sequence<Cond<AgentBittenHasStamina>, Act<RunFlee>>,
+		Sequence<Cond<InventoryFull>,
+			Selector<
+				Sequence<Cond<InGrabRange>, Act<GrabItem>>,
+				Act<SeekItems>>>,
+		Sequence<Cond<InsideHouse>,
+			Selector<
+				Act<ScoutWander>,
+				Sequence<Cond<ItemInFov>, Act<SeekItems>>>>,
+		Sequence<Cond<EnemyInFOV>,
+			Selector<
+				Sequence<Cond<CanKillEnemy>,
+					Selector<
+						Sequence<Cond<canHitEnemy>, Cooldown<Act<ShootClosestEnemy>, 500>>,
+						Act<FaceToClosestEnemy>>>,
+				Sequence<Cond<HasStamina>, Act<RunFlee>>>>,
+		Act<ScoutWander>>;
+
+	using Tree = Elite::StaticBT::Tree<Root>;
+}
+
+//-----------------------------------------------------------------
+// Batch Tree
+//-----------------------------------------------------------------
+// The survival part of the exam tree for many agents at once (see EBatchBehaviorTree.h). Only the checks
+// that need nothing but the agent and its FOV are batched, anything going through the interface
+// (inventory, houses, purge zones) stays with the per agent tree.
+namespace ExamBatchTree
+{
+	enum class eSteering : unsigned char
+	{
+		Wander,
+		Flee,
+		Seek
+	};
+
+	// Inputs and decisions of every agent as structure of arrays. The entities in the FOV of agent i
+	// are [EntityOffsets[i], EntityOffsets[i + 1]) of the entity arrays. The flee target is the per agent
+	// tree's, the purge zone it fled last.
+	struct Agents
+	{
+		std::vector<float> Health = {};
+		std::vector<float> Stamina = {};
+		std::vector<float> PositionX = {};
+		std::vector<float> PositionY = {};
+		std::vector<unsigned char> IsBitten = {};
+		std::vector<float> FleeTargetX = {};
+		std::vector<float> FleeTargetY = {};
+
+		std::vector<unsigned int> EntityOffsets = { 0 };
+		std::vector<eEntityType> EntityTypes = {};
+		std::vector<float> EntityX = {};
+		std::vector<float> EntityY = {};
+
+		// decisions, kept between updates like the blackboard entries they stand for
+		std::vector<eSteering> Steering = {};
+		std::vector<unsigned char> RunMode = {};
+		std::vector<float> TargetX = {};
+		std::vector<float> TargetY = {};
+
+		size_t GetCount() const { return Health.size(); }
+
+		// Inputs only, the decisions of the agents that stay are kept
+		void ClearInputs()
+		{
+			Health.clear();
+			Stamina.clear();
+			PositionX.clear();
+			PositionY.clear();
+			IsBitten.clear();
+			FleeTargetX.clear();
+			FleeTargetY.clear();
+			EntityOffsets.assign(1, 0);
+			EntityTypes.clear();
+			EntityX.clear();
+			EntityY.clear();
+		}
+
+		void AddAgent(const AgentInfo& agent, const vector<EntityInfo>& entities, const Elite::Vector2& fleeTarget)
+		{
+			Health.push_back(agent.Health);
+			Stamina.push_back(agent.Stamina);
+			PositionX.push_back(agent.Position.x);
+			PositionY.push_back(agent.Position.y);
+			IsBitten.push_back(agent.Bitten ? 1 : 0);
+			FleeTargetX.push_back(fleeTarget.x);
+			FleeTargetY.push_back(fleeTarget.y);
+
+			for (const EntityInfo& entity : entities)
+			{
+				EntityTypes.push_back(entity.Type);
+				EntityX.push_back(entity.Location.x);
+				EntityY.push_back(entity.Location.y);
+			}
+			EntityOffsets.push_back(static_cast<unsigned int>(EntityTypes.size()));
+
+			if (Steering.size() < Health.size())
+			{
+				Steering.push_back(eSteering::Wander);
+				RunMode.push_back(agent.RunMode ? 1 : 0);
+				TargetX.push_back(agent.Position.x);
+				TargetY.push_back(agent.Position.y);
+			}
+		}
+
+		// Index in the entity arrays of the closest entity of this type in the agent's FOV
+		unsigned int FindClosestEntity(size_t agent, eEntityType type) const
+		{
+			unsigned int closest = InvalidEntity;
+			float closestDistanceSquared = FLT_MAX;
+			for (unsigned int i = EntityOffsets[agent]; i < EntityOffsets[agent + 1]; ++i)
+			{
+				const float distanceSquared = DistanceSquared(Elite::Vector2{ PositionX[agent], PositionY[agent] }, Elite::Vector2{ EntityX[i], EntityY[i] });
+				if (EntityTypes[i] == type && distanceSquared < closestDistanceSquared)
+				{
+					closestDistanceSquared = distanceSquared;
+					closest = i;
+				}
+			}
+			return closest;
+		}
+
+		static const unsigned int InvalidEntity = 0xFFFFFFFF;
+	};
+
+	// CONDITIONALS
+	//-------------
+	void LowStamina(const Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, size_t wordCount)
+	{
+		const float* pStamina = agents.Stamina.data();
+		Elite::BuildAgentMask(pActive, pSuccess, wordCount, agents.GetCount(), [pStamina](size_t i) { return pStamina[i] <= 0.1f; });
+	}
+
+	void AgentBittenHasStamina(const Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, size_t wordCount)
+	{
+		const float* pStamina = agents.Stamina.data();
+		const unsigned char* pIsBitten = agents.IsBitten.data();
+		Elite::BuildAgentMask(pActive, pSuccess, wordCount, agents.GetCount(), [pStamina, pIsBitten](size_t i) { return pIsBitten[i] != 0 && pStamina[i] >= 0.1f; });
+	}
+
+	void HasStamina(const Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, size_t wordCount)
+	{
+		const float* pStamina = agents.Stamina.data();
+		Elite::BuildAgentMask(pActive, pSuccess, wordCount, agents.GetCount(), [pStamina](size_t i) { return pStamina[i] >= 0.1f; });
+	}
+
+	void EnemyInFOV(const Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, size_t wordCount)
+	{
+		Elite::BuildAgentMask(pActive, pSuccess, wordCount, agents.GetCount(), [&agents](size_t i) { return agents.FindClosestEntity(i, eEntityType::ENEMY) != Agents::InvalidEntity; });
+	}
+
+	void ItemInFov(const Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, size_t wordCount)
+	{
+		Elite::BuildAgentMask(pActive, pSuccess, wordCount, agents.GetCount(), [&agents](size_t i) { return agents.FindClosestEntity(i, eEntityType::ITEM) != Agents::InvalidEntity; });
+	}
+
+	// ACTIONS
+	//--------
+	// Flees from the flee target, like the per agent RunFlee
+	void RunFlee(Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, uint64_t*, size_t wordCount)
+	{
+		Elite::ForEachAgent(pActive, wordCount, [&agents](size_t i)
+		{
+			agents.TargetX[i] = agents.FleeTargetX[i];
+			agents.TargetY[i] = agents.FleeTargetY[i];
+			agents.Steering[i] = eSteering::Flee;
+			agents.RunMode[i] = 1;
+		});
+		std::copy(pActive, pActive + wordCount, pSuccess);
+	}
+
+	void StopRunning(Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, uint64_t*, size_t wordCount)
+	{
+		Elite::ForEachAgent(pActive, wordCount, [&agents](size_t i) { agents.RunMode[i] = 0; });
+		std::copy(pActive, pActive + wordCount, pSuccess);
+	}
+
+	void SeekItems(Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, uint64_t*, size_t wordCount)
+	{
+		Elite::ForEachAgent(pActive, wordCount, [&agents](size_t i)
+		{
+			const unsigned int item = agents.FindClosestEntity(i, eEntityType::ITEM);
+			if (item != Agents::InvalidEntity)
+			{
+				agents.TargetX[i] = agents.EntityX[item];
+				agents.TargetY[i] = agents.EntityY[item];
+			}
+			agents.Steering[i] = eSteering::Seek;
+		});
+		std::copy(pActive, pActive + wordCount, pSuccess);
+	}
+
+	void ScoutWander(Agents& agents, const uint64_t* pActive, uint64_t* pSuccess, uint64_t*, size_t wordCount)
+	{
+		Elite::ForEachAgent(pActive, wordCount, [&agents](size_t i) { agents.Steering[i] = eSteering::Wander; });
+		std::copy(pActive, pActive + wordCount, pSuccess);
+	}
+
+	using Tree = Elite::BatchBehaviorTree<Agents>;
+
+	void Build(Tree& tree)
+	{
+		tree.SetRoot(tree.AddSelector({
+			tree.AddSequence({ tree.AddConditional(LowStamina), tree.AddAction(StopRunning) }),
+			tree.AddSequence({ tree.AddConditional(AgentBittenHasStamina), tree.AddAction(RunFlee) }),
+			tree.AddSequence({ tree.AddConditional(EnemyInFOV),
+				tree.AddSequence({ tree.AddConditional(HasStamina), tree.AddAction(RunFlee) }) }),
+			tree.AddSequence({ tree.AddConditional(ItemInFov), tree.AddAction(SeekItems) }),
+			tree.AddAction(ScoutWander) }));
+	}
+}
 #endif
\ No newline at end of file
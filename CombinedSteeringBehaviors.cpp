@@ -14,8 +14,12 @@ SteeringPlugin_Output BlendedSteering::CalculateSteering(float deltaT, AgentInfo
 	SteeringPlugin_Output blendedSteering = {};
 	auto totalWeight = 0.f;
 
-	for (auto weightedBehavior : m_WeightedBehaviors)
+	for (const auto& weightedBehavior : m_WeightedBehaviors)
 	{
+		//Adds nothing to the blend, so not worth evaluating
+		if (weightedBehavior.weight == 0.f)
+			continue;
+
 		auto steering = weightedBehavior.pBehavior->CalculateSteering(deltaT, pAgent);
 		blendedSteering.LinearVelocity += weightedBehavior.weight * steering.LinearVelocity;
 		blendedSteering.AngularVelocity += weightedBehavior.weight * steering.AngularVelocity;
@@ -34,20 +38,62 @@ SteeringPlugin_Output BlendedSteering::CalculateSteering(float deltaT, AgentInfo
 	return blendedSteering;
 }
 
+unsigned int BlendedSteering::GetOutputChannels() const
+{
+	unsigned int channels = 0;
+	for (const auto& weightedBehavior : m_WeightedBehaviors)
+		channels |= weightedBehavior.pBehavior->GetOutputChannels();
+	return channels;
+}
+
 //*****************
 //PRIORITY STEERING
 SteeringPlugin_Output PrioritySteering::CalculateSteering(float deltaT, AgentInfo* pAgent)
 {
 	SteeringPlugin_Output steering = {};
+	++m_CalculationCount;
 
-	for (auto pBehavior : m_PriorityBehaviors)
+	for (size_t i = 0; i < m_PriorityBehaviors.size(); ++i)
 	{
-		steering = pBehavior->CalculateSteering(deltaT, pAgent);
+		steering = m_PriorityBehaviors[i]->CalculateSteering(deltaT, pAgent);
+		++m_EvaluationCounts[i];
 
-		//if (steering.IsValid)
-		//	break;
+		if (IsValidSteering(steering, m_ValidityThreshold))
+		{
+			m_SkippedCount += static_cast<unsigned int>(m_PriorityBehaviors.size() - i - 1);
+			break;
+		}
 	}
 
 	//If non of the behavior return a valid output, last behavior is returned
 	return steering;
-}
\ No newline at end of file
+}
+
+unsigned int PrioritySteering::GetOutputChannels() const
+{
+	unsigned int channels = 0;
+	for (auto pBehavior : m_PriorityBehaviors)
+		channels |= pBehavior->GetOutputChannels();
+	return channels;
+}
+
+//****************
+//CHANNEL STEERING
+unsigned int CalculateChannelSteering(float deltaT, AgentInfo* pAgent, ISteeringBehavior* pLinearBehavior,
+	ISteeringBehavior* pAngularBehavior, unsigned int consumedChannels, SteeringPlugin_Output& steering)
+{
+	unsigned int evaluationCount = 0;
+	steering.LinearVelocity = {};
+	steering.AngularVelocity = 0.f;
+	if ((consumedChannels & ISteeringBehavior::LinearChannel) && pLinearBehavior->ProducesAny(ISteeringBehavior::LinearChannel))
+	{
+		steering.LinearVelocity = pLinearBehavior->CalculateSteering(deltaT, pAgent).LinearVelocity;
+		++evaluationCount;
+	}
+	if ((consumedChannels & ISteeringBehavior::AngularChannel) && pAngularBehavior->ProducesAny(ISteeringBehavior::AngularChannel))
+	{
+		steering.AngularVelocity = pAngularBehavior->CalculateSteering(deltaT, pAgent).AngularVelocity;
+		++evaluationCount;
+	}
+	return evaluationCount;
+}
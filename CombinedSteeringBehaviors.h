@@ -1,6 +1,9 @@
 #pragma once
 
 #include "SteeringBehaviors.h"
+#include <array>
+#include <tuple>
+#include <utility>
 
 class Flock;
 
@@ -24,6 +27,7 @@ public:
 
 	void AddBehaviour(WeightedBehavior weightedBehavior) { m_WeightedBehaviors.push_back(weightedBehavior); }
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	unsigned int GetOutputChannels() const override;
 
 	// returns a reference to the weighted behaviors, can be used to adjust weighting. Is not intended to alter the behaviors themselves.
 	vector<WeightedBehavior>& GetWeightedBehaviorsRef() { return m_WeightedBehaviors; }
@@ -34,16 +38,115 @@ private:
 
 //*****************
 //PRIORITY STEERING
+//Returns the output of the first behavior whose output is valid (see ISteeringBehavior::IsValidSteering), the ones after
+//it aren't evaluated. When none is valid the last one's output is returned.
 class PrioritySteering final : public ISteeringBehavior
 {
 public:
 	PrioritySteering(vector<ISteeringBehavior*> priorityBehaviors)
-		:m_PriorityBehaviors(priorityBehaviors)
+		:m_PriorityBehaviors(priorityBehaviors),
+		m_EvaluationCounts(priorityBehaviors.size(), 0)
 	{}
 
-	void AddBehaviour(ISteeringBehavior* pBehavior) { m_PriorityBehaviors.push_back(pBehavior); }
+	void AddBehaviour(ISteeringBehavior* pBehavior)
+	{
+		m_PriorityBehaviors.push_back(pBehavior);
+		m_EvaluationCounts.push_back(0);
+	}
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	unsigned int GetOutputChannels() const override;
+
+	void SetValidityThreshold(float threshold) { m_ValidityThreshold = threshold; }
+
+	// how often each behavior was evaluated and how many evaluations the ones before it saved
+	unsigned int GetEvaluationCount(size_t index) const { return m_EvaluationCounts[index]; }
+	unsigned int GetCalculationCount() const { return m_CalculationCount; }
+	unsigned int GetSkippedCount() const { return m_SkippedCount; }
+	void ResetCounts()
+	{
+		std::fill(m_EvaluationCounts.begin(), m_EvaluationCounts.end(), 0);
+		m_CalculationCount = 0;
+		m_SkippedCount = 0;
+	}
 
 private:
 	vector<ISteeringBehavior*> m_PriorityBehaviors = {};
-};
\ No newline at end of file
+	float m_ValidityThreshold = 0.001f;
+
+	vector<unsigned int> m_EvaluationCounts = {};
+	unsigned int m_CalculationCount = 0;
+	unsigned int m_SkippedCount = 0;
+};
+
+//****************
+//CHANNEL STEERING
+//Writes the linear velocity of one behavior and the angular velocity of another into 'steering', calculating each only
+//when the caller reads its channel ('consumedChannels') and the behavior writes it, a skipped channel is set to zero.
+//Returns how many behaviors were calculated.
+unsigned int CalculateChannelSteering(float deltaT, AgentInfo* pAgent, ISteeringBehavior* pLinearBehavior,
+	ISteeringBehavior* pAngularBehavior, unsigned int consumedChannels, SteeringPlugin_Output& steering);
+
+//***********************
+//STATIC BLENDED STEERING
+//BlendedSteering over a set of concrete behaviors known at compile time. Every member is called by its own type,
+//so the calls aren't virtual and the weighted sum is inlined into one pass. Members with weight 0 aren't evaluated.
+//The weights can still be tuned at runtime, the behaviors are not owned.
+template<typename... TBehaviors>
+class StaticBlendedSteering final : public ISteeringBehavior
+{
+public:
+	static const size_t BehaviorCount = sizeof...(TBehaviors);
+
+	explicit StaticBlendedSteering(TBehaviors*... pBehaviors)
+		:m_pBehaviors(pBehaviors...)
+	{
+		m_Weights.fill(1.f);
+	}
+
+	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override
+	{
+		return Blend(deltaT, pAgent, std::index_sequence_for<TBehaviors...>{});
+	}
+	unsigned int GetOutputChannels() const override
+	{
+		return std::apply([](const TBehaviors*... pBehaviors) { return (0u | ... | pBehaviors->TBehaviors::GetOutputChannels()); }, m_pBehaviors);
+	}
+
+	void SetWeight(size_t index, float weight) { m_Weights[index] = weight; }
+	float GetWeight(size_t index) const { return m_Weights[index]; }
+	void SetWeights(const std::array<float, sizeof...(TBehaviors)>& weights) { m_Weights = weights; }
+
+private:
+	template<size_t... Indices>
+	SteeringPlugin_Output Blend(float deltaT, AgentInfo* pAgent, std::index_sequence<Indices...>)
+	{
+		SteeringPlugin_Output blendedSteering = {};
+		float totalWeight = 0.f;
+		(Accumulate<Indices>(deltaT, pAgent, blendedSteering, totalWeight), ...);
+
+		if (totalWeight > 0.f)
+		{
+			const float scale = 1.f / totalWeight;
+			blendedSteering.LinearVelocity *= scale;
+			blendedSteering.AngularVelocity *= scale;
+		}
+		return blendedSteering;
+	}
+
+	template<size_t Index>
+	void Accumulate(float deltaT, AgentInfo* pAgent, SteeringPlugin_Output& blendedSteering, float& totalWeight)
+	{
+		using TBehavior = std::tuple_element_t<Index, std::tuple<TBehaviors...>>;
+		const float weight = m_Weights[Index];
+		if (weight == 0.f)
+			return;
+
+		const SteeringPlugin_Output steering = std::get<Index>(m_pBehaviors)->TBehavior::CalculateSteering(deltaT, pAgent);
+		blendedSteering.LinearVelocity += weight * steering.LinearVelocity;
+		blendedSteering.AngularVelocity += weight * steering.AngularVelocity;
+		totalWeight += weight;
+	}
+
+	std::tuple<TBehaviors*...> m_pBehaviors;
+	std::array<float, sizeof...(TBehaviors)> m_Weights = {};
+};
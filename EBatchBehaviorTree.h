@@ -0,0 +1,291 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EBatchBehaviorTree.h: Behavior tree that decides for a whole batch of agents at once.
+// The agents' data is one structure of arrays, every node runs once per tick for the set
+// of agents that reach it, passed around as bit masks, instead of once per agent.
+/*=============================================================================*/
+#ifndef ELITE_BATCH_BEHAVIOR_TREE
+#define ELITE_BATCH_BEHAVIOR_TREE
+
+//--- Includes ---
+#include "EBehaviorTree.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// AGENT MASKS
+	//-----------------------------------------------------------------
+	//One bit per agent, agent i is bit (i % 64) of word (i / 64)
+	inline size_t GetAgentMaskWordCount(size_t agentCount)
+	{ return (agentCount + 63) / 64; }
+
+	inline unsigned int CountTrailingZeros(uint64_t bits)
+	{
+#ifdef _MSC_VER
+		unsigned long index = 0;
+		_BitScanForward64(&index, bits);
+		return static_cast<unsigned int>(index);
+#else
+		return static_cast<unsigned int>(__builtin_ctzll(bits));
+#endif
+	}
+
+	//Calls 'function(agent)' for every agent in the mask
+	template<typename TFunction>
+	void ForEachAgent(const uint64_t* pMask, size_t wordCount, TFunction function)
+	{
+		for (size_t word = 0; word < wordCount; ++word)
+		{
+			for (uint64_t bits = pMask[word]; bits != 0; bits &= bits - 1)
+				function(word * 64 + CountTrailingZeros(bits));
+		}
+	}
+
+	//Sets the result bit of every active agent 'predicate(agent)' holds for. The predicate runs for every agent
+	//in a word with any active agent, without branching on the mask, so loops over arrays can vectorize.
+	template<typename TPredicate>
+	void BuildAgentMask(const uint64_t* pActive, uint64_t* pResult, size_t wordCount, size_t agentCount, TPredicate predicate)
+	{
+		for (size_t word = 0; word < wordCount; ++word)
+		{
+			if (pActive[word] == 0)
+			{
+				pResult[word] = 0;
+				continue;
+			}
+
+			const size_t first = word * 64;
+			const size_t count = (std::min)(agentCount - first, static_cast<size_t>(64));
+			uint64_t bits = 0;
+			for (size_t i = 0; i < count; ++i)
+				bits |= static_cast<uint64_t>(predicate(first + i) ? 1 : 0) << i;
+			pResult[word] = bits & pActive[word];
+		}
+	}
+
+	//-----------------------------------------------------------------
+	// BATCH BEHAVIOR TREE
+	//-----------------------------------------------------------------
+	//Built once and not changed while it runs. Nodes get the agents that reach them and split them into
+	//the ones that succeed, fail or keep running: a sequence passes its successes on to the next child,
+	//a selector its failures. Children no agent reaches are skipped.
+	template<typename TAgents>
+	class BatchBehaviorTree final
+	{
+	public:
+		//Sets 'pSuccess' for the active agents the condition holds for
+		using BatchConditional = void(*)(const TAgents& agents, const uint64_t* pActive, uint64_t* pSuccess, size_t wordCount);
+		//Sets 'pSuccess' or 'pRunning' for the active agents, the ones in neither failed
+		using BatchAction = void(*)(TAgents& agents, const uint64_t* pActive, uint64_t* pSuccess, uint64_t* pRunning, size_t wordCount);
+
+		static const unsigned int InvalidNode = 0xFFFFFFFF;
+
+		BatchBehaviorTree() = default;
+
+		unsigned int AddConditional(BatchConditional fpConditional)
+		{
+			Node node{ BatchNodeType::Conditional, 0, 0, { nullptr } };
+			node.fpConditional = fpConditional;
+			return AddNode(node, {});
+		}
+		unsigned int AddAction(BatchAction fpAction)
+		{
+			Node node{ BatchNodeType::Action, 0, 0, { nullptr } };
+			node.fpAction = fpAction;
+			return AddNode(node, {});
+		}
+		unsigned int AddSelector(const std::vector<unsigned int>& children)
+		{ return AddNode(Node{ BatchNodeType::Selector, 0, 0, { nullptr } }, children); }
+		unsigned int AddSequence(const std::vector<unsigned int>& children)
+		{ return AddNode(Node{ BatchNodeType::Sequence, 0, 0, { nullptr } }, children); }
+
+		void SetRoot(unsigned int root)
+		{
+			m_Root = root;
+			m_Depth = GetDepth(root);
+		}
+
+		//Decides for the agents [0, agentCount) in 'pActive', or all of them without a mask
+		void Update(TAgents& agents, size_t agentCount, const uint64_t* pActive = nullptr)
+		{
+			m_WordCount = GetAgentMaskWordCount(agentCount);
+			m_Scratch.resize(m_WordCount * ScratchMasksPerLevel * (m_Depth + 1));
+			m_Results.resize(m_WordCount * 3);
+
+			uint64_t* pAll = GetScratch(0, 0);
+			for (size_t word = 0; word < m_WordCount; ++word)
+			{
+				const size_t first = word * 64;
+				const uint64_t validBits = agentCount - first >= 64 ? ~0ULL : (1ULL << (agentCount - first)) - 1;
+				pAll[word] = pActive != nullptr ? pActive[word] & validBits : validBits;
+			}
+
+			if (m_Root == InvalidNode)
+			{
+				std::fill(m_Results.begin(), m_Results.end(), 0ULL);
+				std::copy(pAll, pAll + m_WordCount, GetResult(Failure));
+				return;
+			}
+			Evaluate(agents, m_Root, 1, pAll, GetResult(Success), GetResult(Failure), GetResult(Running));
+		}
+
+		//Outcome of the last Update, one mask per state
+		const uint64_t* GetResultMask(BehaviorState state) const
+		{ return m_Results.data() + static_cast<size_t>(state) * m_WordCount; }
+		BehaviorState GetAgentState(size_t agent) const
+		{
+			const size_t word = agent / 64;
+			const uint64_t bit = 1ULL << (agent % 64);
+			if (GetResultMask(Success)[word] & bit)
+				return Success;
+			if (GetResultMask(Running)[word] & bit)
+				return Running;
+			return Failure;
+		}
+
+	private:
+		enum class BatchNodeType : unsigned char
+		{
+			Selector,
+			Sequence,
+			Conditional,
+			Action
+		};
+
+		struct Node
+		{
+			BatchNodeType type;
+			unsigned int firstChild;
+			unsigned int childCount;
+			union
+			{
+				BatchConditional fpConditional;
+				BatchAction fpAction;
+			};
+		};
+
+		//Per level of depth: the agents still going on, and a child's success, failure and running agents
+		static const size_t ScratchMasksPerLevel = 4;
+
+		unsigned int AddNode(Node node, const std::vector<unsigned int>& children)
+		{
+			node.firstChild = static_cast<unsigned int>(m_Children.size());
+			node.childCount = static_cast<unsigned int>(children.size());
+			m_Children.insert(m_Children.end(), children.begin(), children.end());
+			m_Nodes.push_back(node);
+			return static_cast<unsigned int>(m_Nodes.size() - 1);
+		}
+
+		unsigned int GetDepth(unsigned int node) const
+		{
+			unsigned int depth = 0;
+			const Node& n = m_Nodes[node];
+			for (unsigned int i = 0; i < n.childCount; ++i)
+				depth = (std::max)(depth, GetDepth(m_Children[n.firstChild + i]));
+			return depth + 1;
+		}
+
+		uint64_t* GetScratch(unsigned int level, size_t mask)
+		{ return m_Scratch.data() + (level * ScratchMasksPerLevel + mask) * m_WordCount; }
+		uint64_t* GetResult(BehaviorState state)
+		{ return m_Results.data() + static_cast<size_t>(state) * m_WordCount; }
+
+		bool IsEmpty(const uint64_t* pMask) const
+		{
+			for (size_t word = 0; word < m_WordCount; ++word)
+			{
+				if (pMask[word] != 0)
+					return false;
+			}
+			return true;
+		}
+
+		void Evaluate(TAgents& agents, unsigned int nodeIndex, unsigned int level, const uint64_t* pActive,
+			uint64_t* pSuccess, uint64_t* pFailure, uint64_t* pRunning)
+		{
+			const size_t wordCount = m_WordCount;
+			std::fill(pSuccess, pSuccess + wordCount, 0ULL);
+			std::fill(pFailure, pFailure + wordCount, 0ULL);
+			std::fill(pRunning, pRunning + wordCount, 0ULL);
+			if (IsEmpty(pActive))
+				return;
+
+			const Node& node = m_Nodes[nodeIndex];
+			switch (node.type)
+			{
+			case BatchNodeType::Conditional:
+				node.fpConditional(agents, pActive, pSuccess, wordCount);
+				for (size_t word = 0; word < wordCount; ++word)
+				{
+					pSuccess[word] &= pActive[word];
+					pFailure[word] = pActive[word] & ~pSuccess[word];
+				}
+				return;
+			case BatchNodeType::Action:
+				node.fpAction(agents, pActive, pSuccess, pRunning, wordCount);
+				for (size_t word = 0; word < wordCount; ++word)
+				{
+					pSuccess[word] &= pActive[word];
+					pRunning[word] &= pActive[word] & ~pSuccess[word];
+					pFailure[word] = pActive[word] & ~(pSuccess[word] | pRunning[word]);
+				}
+				return;
+			default:
+				break;
+			}
+
+			//Composites: a sequence goes on with the agents that succeeded, a selector with the ones that failed
+			const bool isSequence = node.type == BatchNodeType::Sequence;
+			uint64_t* pRemaining = GetScratch(level, 0);
+			uint64_t* pChildSuccess = GetScratch(level, 1);
+			uint64_t* pChildFailure = GetScratch(level, 2);
+			uint64_t* pChildRunning = GetScratch(level, 3);
+			std::copy(pActive, pActive + wordCount, pRemaining);
+
+			for (unsigned int i = 0; i < node.childCount; ++i)
+			{
+				Evaluate(agents, m_Children[node.firstChild + i], level + 1, pRemaining, pChildSuccess, pChildFailure, pChildRunning);
+
+				uint64_t remainingBits = 0;
+				for (size_t word = 0; word < wordCount; ++word)
+				{
+					pRunning[word] |= pChildRunning[word];
+					if (isSequence)
+					{
+						pFailure[word] |= pChildFailure[word];
+						pRemaining[word] = pChildSuccess[word];
+					}
+					else
+					{
+						pSuccess[word] |= pChildSuccess[word];
+						pRemaining[word] = pChildFailure[word];
+					}
+					remainingBits |= pRemaining[word];
+				}
+				if (remainingBits == 0)
+					break;
+			}
+
+			uint64_t* pFinished = isSequence ? pSuccess : pFailure;
+			for (size_t word = 0; word < wordCount; ++word)
+				pFinished[word] |= pRemaining[word];
+		}
+
+		std::vector<Node> m_Nodes = {};
+		std::vector<unsigned int> m_Children = {};
+		unsigned int m_Root = InvalidNode;
+		unsigned int m_Depth = 0;
+
+		size_t m_WordCount = 0;
+		std::vector<uint64_t> m_Scratch = {};
+		std::vector<uint64_t> m_Results = {}; //Failure, Success and Running masks, in BehaviorState order
+	};
+}
+#endif
@@ -0,0 +1,170 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EBehaviorCoroutine.h"
+#include <mutex>
+#include <new>
+
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// COROUTINE FRAME POOL
+//-----------------------------------------------------------------
+namespace
+{
+	struct FramePoolStorage
+	{
+		FramePoolStorage()
+		{
+			for (unsigned int i = 0; i < CoroutineFramePool::BlockCount; ++i)
+				freeBlocks[i] = CoroutineFramePool::BlockCount - 1 - i;
+			freeCount = CoroutineFramePool::BlockCount;
+		}
+
+		alignas(std::max_align_t) unsigned char blocks[CoroutineFramePool::BlockCount][CoroutineFramePool::BlockSize];
+		unsigned int freeBlocks[CoroutineFramePool::BlockCount]; //Stack of free block indices
+		unsigned int freeCount = 0;
+		unsigned int fallbackCount = 0;
+		std::mutex mutex; //Actions may be started by parallel children
+	};
+
+	FramePoolStorage& GetFramePoolStorage()
+	{
+		static FramePoolStorage storage;
+		return storage;
+	}
+}
+
+void* CoroutineFramePool::Allocate(size_t size)
+{
+	FramePoolStorage& storage = GetFramePoolStorage();
+	{
+		std::lock_guard<std::mutex> lock(storage.mutex);
+		if (size <= BlockSize && storage.freeCount > 0)
+			return storage.blocks[storage.freeBlocks[--storage.freeCount]];
+		++storage.fallbackCount;
+	}
+	return ::operator new(size);
+}
+
+void CoroutineFramePool::Deallocate(void* pFrame)
+{
+	FramePoolStorage& storage = GetFramePoolStorage();
+	unsigned char* pBytes = static_cast<unsigned char*>(pFrame);
+	unsigned char* pFirst = &storage.blocks[0][0];
+	if (pBytes < pFirst || pBytes >= pFirst + sizeof(storage.blocks))
+	{
+		::operator delete(pFrame);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(storage.mutex);
+	storage.freeBlocks[storage.freeCount++] = static_cast<unsigned int>((pBytes - pFirst) / BlockSize);
+}
+
+unsigned int CoroutineFramePool::GetUsedBlockCount()
+{
+	FramePoolStorage& storage = GetFramePoolStorage();
+	std::lock_guard<std::mutex> lock(storage.mutex);
+	return BlockCount - storage.freeCount;
+}
+
+unsigned int CoroutineFramePool::GetFallbackCount()
+{
+	FramePoolStorage& storage = GetFramePoolStorage();
+	std::lock_guard<std::mutex> lock(storage.mutex);
+	return storage.fallbackCount;
+}
+
+//-----------------------------------------------------------------
+// BEHAVIOR TASK
+//-----------------------------------------------------------------
+BehaviorState BehaviorTask::Resume(Blackboard* pBlackBoard)
+{
+	if (!m_Handle)
+		return Failure;
+
+	promise_type& promise = m_Handle.promise();
+	if (m_Handle.done())
+		return promise.result;
+
+	//Whatever the action waits for is checked here, the frame is only resumed once it's there
+	if (promise.fpWaitCondition != nullptr)
+	{
+		if (!promise.fpWaitCondition(pBlackBoard))
+			return Running;
+		promise.fpWaitCondition = nullptr;
+	}
+	else if (promise.fpWaitAction != nullptr)
+	{
+		const BehaviorState state = promise.fpWaitAction(pBlackBoard);
+		if (state == Running)
+			return Running;
+		promise.actionResult = state;
+		promise.fpWaitAction = nullptr;
+	}
+
+	promise.pBlackBoard = pBlackBoard;
+	m_Handle.resume();
+	return m_Handle.done() ? promise.result : Running;
+}
+
+//-----------------------------------------------------------------
+// BEHAVIOR TREE COROUTINE (IBehavior)
+//-----------------------------------------------------------------
+BehaviorState BehaviorCoroutine::Execute(Blackboard* pBlackBoard)
+{
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
+	if (m_fpTask == nullptr)
+		return m_CurrentState = Failure;
+
+	if (!m_Task.IsValid())
+		m_Task = m_fpTask(pBlackBoard);
+
+	m_CurrentState = m_Task.Resume(pBlackBoard);
+	if (m_CurrentState != Running)
+	{
+		m_Task = BehaviorTask{}; //Gives the frame back, the next tick starts the action over
+		return m_CurrentState;
+	}
+
+	//Still running, the tree aborts it when a tick doesn't get here anymore
+	if (!m_RunningNodesKey.IsValid())
+		m_RunningNodesKey = pBlackBoard->GetKey<BehaviorRunningNodes*>("RunningNodes");
+	BehaviorRunningNodes* pRunningNodes = nullptr;
+	if (pBlackBoard->TryGetData(m_RunningNodesKey, pRunningNodes) && pRunningNodes != nullptr)
+		pRunningNodes->Report(this);
+	return m_CurrentState;
+}
+
+void BehaviorCoroutine::Abort()
+{
+	m_Task = BehaviorTask{};
+	m_CurrentState = Failure;
+}
+
+void BehaviorCoroutine::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	FlatBehavior flatBehavior{ FlatBehaviorType::Instanced, 0, static_cast<unsigned int>(flatBehaviors.size() + 1), { nullptr } };
+	flatBehavior.pBehavior = this;
+	ELITE_BT_PROFILE_SOURCE(flatBehavior, this);
+	flatBehaviors.push_back(flatBehavior);
+}
+
+BehaviorState BehaviorCoroutine::ExecuteInstance(Blackboard* pBlackBoard, void*& pInstance) const
+{
+	if (m_fpTask == nullptr)
+		return Failure;
+
+	BehaviorTask task = pInstance != nullptr ? BehaviorTask::Attach(pInstance) : m_fpTask(pBlackBoard);
+	pInstance = nullptr;
+	const BehaviorState state = task.Resume(pBlackBoard);
+	if (state == Running)
+		pInstance = task.Detach(); //Else the frame is given back with the task
+	return state;
+}
+
+void BehaviorCoroutine::AbortInstance(void*& pInstance) const
+{
+	BehaviorTask::Attach(pInstance); //Destroys the frame
+	pInstance = nullptr;
+}
@@ -0,0 +1,199 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EBehaviorCoroutine.h: Behavior tree actions written as C++20 coroutines. An action that takes
+// several ticks is one function that co_awaits the next tick, a condition or another action,
+// and continues right after it on the next tick instead of being split over nodes that are
+// checked again every tick. Coroutine frames come from a pool of fixed size blocks.
+/*=============================================================================*/
+#ifndef ELITE_BEHAVIOR_COROUTINE
+#define ELITE_BEHAVIOR_COROUTINE
+
+//--- Includes ---
+#include "EBehaviorTree.h"
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// COROUTINE FRAME POOL
+	//-----------------------------------------------------------------
+	//Blocks for coroutine frames, so starting a coroutine action doesn't go to the heap. Frames larger than a block,
+	//or started while every block is in use, fall back to operator new and are counted.
+	class CoroutineFramePool final
+	{
+	public:
+		static const size_t BlockSize = 512;
+		static const unsigned int BlockCount = 256;
+
+		static void* Allocate(size_t size);
+		static void Deallocate(void* pFrame);
+
+		static unsigned int GetUsedBlockCount();
+		static unsigned int GetFallbackCount();
+	};
+
+	//-----------------------------------------------------------------
+	// BEHAVIOR TASK
+	//-----------------------------------------------------------------
+	//Return type of a coroutine action, e.g. BehaviorTask LootItem(Blackboard* pBlackboard). The action starts on the
+	//first tick and every tick it is suspended in counts as Running, co_return gives its final state.
+	class BehaviorTask final
+	{
+	public:
+		struct promise_type
+		{
+			//The blackboard the action was started with, for the awaitables that check something right away
+			explicit promise_type(Blackboard* pBlackBoard) : pBlackBoard(pBlackBoard) {}
+			template<typename TOwner> promise_type(TOwner&, Blackboard* pBlackBoard) : pBlackBoard(pBlackBoard) {}
+
+			static void* operator new(size_t size)
+			{ return CoroutineFramePool::Allocate(size); }
+			static void operator delete(void* pFrame)
+			{ CoroutineFramePool::Deallocate(pFrame); }
+
+			BehaviorTask get_return_object()
+			{ return BehaviorTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend() noexcept
+			{ return {}; }
+			std::suspend_always final_suspend() noexcept
+			{ return {}; }
+			void return_value(BehaviorState state)
+			{ result = state; }
+			void unhandled_exception()
+			{ std::terminate(); }
+
+			Blackboard* pBlackBoard = nullptr;
+			BehaviorState result = Failure;
+			//What the suspended action waits for, checked by Resume without resuming the frame
+			bool(*fpWaitCondition)(Blackboard*) = nullptr;
+			BehaviorState(*fpWaitAction)(Blackboard*) = nullptr;
+			BehaviorState actionResult = Failure;
+		};
+
+		BehaviorTask() = default;
+		BehaviorTask(BehaviorTask&& other) noexcept : m_Handle(other.m_Handle)
+		{ other.m_Handle = nullptr; }
+		BehaviorTask& operator=(BehaviorTask&& other) noexcept
+		{
+			if (this != &other)
+			{
+				if (m_Handle)
+					m_Handle.destroy();
+				m_Handle = other.m_Handle;
+				other.m_Handle = nullptr;
+			}
+			return *this;
+		}
+		~BehaviorTask()
+		{
+			if (m_Handle)
+				m_Handle.destroy();
+		}
+
+		BehaviorTask(const BehaviorTask& other) = delete;
+		BehaviorTask& operator=(const BehaviorTask& other) = delete;
+
+		bool IsValid() const
+		{ return static_cast<bool>(m_Handle); }
+		//Runs the action until it suspends or finishes, Running while it's suspended
+		BehaviorState Resume(Blackboard* pBlackBoard);
+
+		//Lets go of the frame without destroying it, for keeping it as a plain pointer, and takes one back
+		void* Detach()
+		{
+			void* pFrame = m_Handle.address();
+			m_Handle = nullptr;
+			return pFrame;
+		}
+		static BehaviorTask Attach(void* pFrame)
+		{ return pFrame != nullptr ? BehaviorTask(std::coroutine_handle<promise_type>::from_address(pFrame)) : BehaviorTask{}; }
+
+	private:
+		explicit BehaviorTask(std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+
+		std::coroutine_handle<promise_type> m_Handle = nullptr;
+	};
+
+	//-----------------------------------------------------------------
+	// AWAITABLES
+	//-----------------------------------------------------------------
+	//co_await NextTick{}: continues on the next tick
+	struct NextTick final
+	{
+		bool await_ready() const noexcept
+		{ return false; }
+		void await_suspend(std::coroutine_handle<>) const noexcept {}
+		void await_resume() const noexcept {}
+	};
+
+	//co_await WaitUntil{ fpConditional }: continues right away when the conditional holds, else on the first tick it does.
+	//Until then the frame isn't resumed, only the conditional is checked.
+	struct WaitUntil final
+	{
+		bool(*fpConditional)(Blackboard*);
+
+		bool await_ready() const noexcept
+		{ return false; }
+		bool await_suspend(std::coroutine_handle<BehaviorTask::promise_type> handle) const
+		{
+			BehaviorTask::promise_type& promise = handle.promise();
+			if (fpConditional(promise.pBlackBoard))
+				return false;
+			promise.fpWaitCondition = fpConditional;
+			return true;
+		}
+		void await_resume() const noexcept {}
+	};
+
+	//co_await RunAction{ fpAction }: runs the action this tick and every next one while it's Running, gives its final state
+	struct RunAction final
+	{
+		BehaviorState(*fpAction)(Blackboard*);
+		BehaviorTask::promise_type* pPromise = nullptr;
+
+		bool await_ready() const noexcept
+		{ return false; }
+		bool await_suspend(std::coroutine_handle<BehaviorTask::promise_type> handle)
+		{
+			pPromise = &handle.promise();
+			pPromise->actionResult = fpAction(pPromise->pBlackBoard);
+			if (pPromise->actionResult != Running)
+				return false;
+			pPromise->fpWaitAction = fpAction;
+			return true;
+		}
+		BehaviorState await_resume() const noexcept
+		{ return pPromise->actionResult; }
+	};
+
+	//-----------------------------------------------------------------
+	// BEHAVIOR TREE COROUTINE (IBehavior)
+	//-----------------------------------------------------------------
+	//Starts the coroutine action when ticked without one running, continues it on the next ticks, and lets go of its
+	//frame once it finished. The pointer tree keeps the running action in the node, a compiled tree keeps its frame as
+	//the node's instance, so every tree running a shared definition has an action of its own. The nodes in front of it
+	//are checked every tick as usual: when one of them takes over, the BehaviorTree aborts the action, which destroys
+	//its frame, and the next tick reaching it starts it over.
+	//Without a BehaviorTree's "RunningNodes" in the blackboard nothing aborts it, it continues where it was.
+	class BehaviorCoroutine : public IBehavior
+	{
+	public:
+		explicit BehaviorCoroutine(std::function<BehaviorTask(Blackboard*)> fpTask) : m_fpTask(fpTask) {}
+		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Abort() override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
+
+		//The frame of the running action as the instance
+		virtual BehaviorState ExecuteInstance(Blackboard* pBlackBoard, void*& pInstance) const override;
+		virtual void AbortInstance(void*& pInstance) const override;
+
+	private:
+		std::function<BehaviorTask(Blackboard*)> m_fpTask = nullptr;
+		BehaviorTask m_Task = {};
+		BlackboardKey<BehaviorRunningNodes*> m_RunningNodesKey = {};
+	};
+}
+#endif
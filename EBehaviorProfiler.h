@@ -0,0 +1,269 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EBehaviorProfiler.h: Opt-in per node profiler for the behavior tree.
+// Build with ELITE_BT_PROFILER set to 1 to record call counts, times and results
+// per node. Left at 0 the hooks expand to nothing and the profiler isn't part of the tree.
+/*=============================================================================*/
+#ifndef ELITE_BEHAVIOR_PROFILER
+#define ELITE_BEHAVIOR_PROFILER
+
+#ifndef ELITE_BT_PROFILER
+#define ELITE_BT_PROFILER 0
+#endif
+
+//--- Includes ---
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// BEHAVIOR PROFILER
+	//-----------------------------------------------------------------
+	//Nodes are identified by their pre-order index and named by their path from the root,
+	//e.g. "Selector[0]/Sequence[2]/Conditional[0]", which stays the same as long as the tree is built the same.
+	//Results are counted by BehaviorState value: Failure, Success, Running.
+	class BehaviorProfiler final
+	{
+	public:
+		static const unsigned int InvalidNode = 0xFFFFFFFF;
+
+		struct NodeStats
+		{
+			std::string path = {};
+			unsigned int calls = 0;
+			uint64_t totalNanoseconds = 0;
+			uint64_t maxNanoseconds = 0;
+			unsigned int results[3] = {};
+		};
+
+		BehaviorProfiler()
+			: m_Start(Clock::now())
+		{}
+
+		//Replaces the nodes and clears everything recorded so far. pSources maps the tree's own nodes to their index.
+		void SetNodes(const std::vector<std::string>& paths, const std::vector<const void*>& pSources)
+		{
+			m_Nodes.assign(paths.size(), NodeStats{});
+			m_NodeIndices.clear();
+			for (size_t i = 0; i < paths.size(); ++i)
+			{
+				m_Nodes[i].path = paths[i];
+				if (i < pSources.size() && pSources[i] != nullptr)
+					m_NodeIndices[pSources[i]] = static_cast<unsigned int>(i);
+			}
+			m_OpenNodes.clear();
+			m_TraceEvents.clear();
+		}
+
+		unsigned int FindNode(const void* pSource) const
+		{
+			auto it = m_NodeIndices.find(pSource);
+			return it != m_NodeIndices.end() ? it->second : InvalidNode;
+		}
+
+		//Begin and End nest like the calls they measure
+		void BeginNode(unsigned int node)
+		{
+			m_OpenNodes.push_back({ node, Clock::now() });
+		}
+		void EndNode(unsigned int node, unsigned int result)
+		{
+			if (m_OpenNodes.empty())
+				return;
+
+			const OpenNode openNode = m_OpenNodes.back();
+			m_OpenNodes.pop_back();
+			if (openNode.node != node || node >= m_Nodes.size())
+				return;
+
+			const uint64_t duration = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - openNode.start).count());
+			NodeStats& stats = m_Nodes[node];
+			++stats.calls;
+			stats.totalNanoseconds += duration;
+			if (duration > stats.maxNanoseconds)
+				stats.maxNanoseconds = duration;
+			if (result < 3)
+				++stats.results[result];
+
+			if (m_TraceEvents.size() < m_TraceCapacity)
+			{
+				const uint64_t start = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(openNode.start - m_Start).count());
+				m_TraceEvents.push_back({ node, result, start, duration });
+			}
+		}
+
+		//Every call is kept for the Chrome trace until this many are recorded, later calls only go in the stats
+		void SetTraceCapacity(size_t capacity) { m_TraceCapacity = capacity; }
+
+		const std::vector<NodeStats>& GetNodeStats() const { return m_Nodes; }
+
+		void Reset()
+		{
+			for (NodeStats& stats : m_Nodes)
+			{
+				const std::string path = stats.path;
+				stats = NodeStats{};
+				stats.path = path;
+			}
+			m_OpenNodes.clear();
+			m_TraceEvents.clear();
+		}
+
+		void WriteCSV(std::ostream& os) const
+		{
+			os << "node,path,calls,total_us,mean_us,max_us,success,failure,running\n";
+			for (size_t i = 0; i < m_Nodes.size(); ++i)
+			{
+				const NodeStats& stats = m_Nodes[i];
+				const double mean = stats.calls > 0 ? static_cast<double>(stats.totalNanoseconds) / stats.calls : 0.0;
+				os << i << ',' << stats.path << ',' << stats.calls << ','
+					<< stats.totalNanoseconds / 1000.0 << ',' << mean / 1000.0 << ',' << stats.maxNanoseconds / 1000.0 << ','
+					<< stats.results[1] << ',' << stats.results[0] << ',' << stats.results[2] << '\n';
+			}
+		}
+
+		//Chrome trace_event format, open it in chrome://tracing or Perfetto
+		void WriteChromeTrace(std::ostream& os) const
+		{
+			static const char* resultNames[3] = { "Failure", "Success", "Running" };
+
+			os << "{\"traceEvents\":[";
+			for (size_t i = 0; i < m_TraceEvents.size(); ++i)
+			{
+				const TraceEvent& event = m_TraceEvents[i];
+				os << (i > 0 ? ",\n" : "\n")
+					<< "{\"name\":\"" << m_Nodes[event.node].path << "\",\"cat\":\"BehaviorTree\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+					<< ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0
+					<< ",\"args\":{\"result\":\"" << (event.result < 3 ? resultNames[event.result] : "Unknown") << "\"}}";
+			}
+			os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+		}
+
+		bool ExportCSV(const std::string& fileName) const
+		{
+			std::ofstream file(fileName);
+			if (!file)
+			{
+				printf("WARNING: Can't write behavior tree profile to '%s' \n", fileName.c_str());
+				return false;
+			}
+			WriteCSV(file);
+			return true;
+		}
+
+		bool ExportChromeTrace(const std::string& fileName) const
+		{
+			std::ofstream file(fileName);
+			if (!file)
+			{
+				printf("WARNING: Can't write behavior tree trace to '%s' \n", fileName.c_str());
+				return false;
+			}
+			WriteChromeTrace(file);
+			return true;
+		}
+
+		//Profiler the pointer tree's nodes report to while their tree updates (see NodeScope)
+		static BehaviorProfiler*& Active()
+		{
+			static thread_local BehaviorProfiler* pActive = nullptr;
+			return pActive;
+		}
+
+		class ActiveScope final
+		{
+		public:
+			explicit ActiveScope(BehaviorProfiler* pProfiler)
+				: m_pPrevious(Active())
+			{ Active() = pProfiler; }
+			~ActiveScope() { Active() = m_pPrevious; }
+
+			ActiveScope(const ActiveScope& other) = delete;
+			ActiveScope& operator=(const ActiveScope& other) = delete;
+
+		private:
+			BehaviorProfiler* m_pPrevious;
+		};
+
+		//Measures one Execute, reading the node's state when the scope closes
+		template<typename TState>
+		class NodeScope final
+		{
+		public:
+			NodeScope(const void* pNode, const TState& state)
+				: m_pProfiler(Active()), m_State(state)
+			{
+				if (m_pProfiler == nullptr)
+					return;
+
+				m_Node = m_pProfiler->FindNode(pNode);
+				if (m_Node != InvalidNode)
+					m_pProfiler->BeginNode(m_Node);
+			}
+			~NodeScope()
+			{
+				if (m_pProfiler != nullptr && m_Node != InvalidNode)
+					m_pProfiler->EndNode(m_Node, static_cast<unsigned int>(m_State));
+			}
+
+			NodeScope(const NodeScope& other) = delete;
+			NodeScope& operator=(const NodeScope& other) = delete;
+
+		private:
+			BehaviorProfiler* m_pProfiler;
+			const TState& m_State;
+			unsigned int m_Node = InvalidNode;
+		};
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct OpenNode
+		{
+			unsigned int node;
+			Clock::time_point start;
+		};
+
+		struct TraceEvent
+		{
+			unsigned int node;
+			unsigned int result;
+			uint64_t start;
+			uint64_t duration;
+		};
+
+		Clock::time_point m_Start;
+		std::vector<NodeStats> m_Nodes = {};
+		std::unordered_map<const void*, unsigned int> m_NodeIndices = {};
+		std::vector<OpenNode> m_OpenNodes = {};
+		std::vector<TraceEvent> m_TraceEvents = {};
+		size_t m_TraceCapacity = 1 << 20;
+	};
+}
+
+//-----------------------------------------------------------------
+// PROFILER HOOKS
+//-----------------------------------------------------------------
+#if ELITE_BT_PROFILER
+#define ELITE_BT_PROFILE_NODE(pNode, state) Elite::BehaviorProfiler::NodeScope<std::remove_reference<decltype(state)>::type> eliteProfileNodeScope(pNode, state)
+#define ELITE_BT_PROFILE_ACTIVATE(pProfiler) Elite::BehaviorProfiler::ActiveScope eliteProfileActiveScope(pProfiler)
+#define ELITE_BT_PROFILE_BEGIN(profiler, node) (profiler).BeginNode(node)
+#define ELITE_BT_PROFILE_END(profiler, node, state) (profiler).EndNode(node, static_cast<unsigned int>(state))
+#define ELITE_BT_PROFILE_SOURCE(flatBehavior, pNode) (flatBehavior).pSource = (pNode)
+#else
+#define ELITE_BT_PROFILE_NODE(pNode, state)
+#define ELITE_BT_PROFILE_ACTIVATE(pProfiler)
+#define ELITE_BT_PROFILE_BEGIN(profiler, node)
+#define ELITE_BT_PROFILE_END(profiler, node, state)
+#define ELITE_BT_PROFILE_SOURCE(flatBehavior, pNode)
+#endif
+#endif
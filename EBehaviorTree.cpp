@@ -4,13 +4,48 @@
 
 using namespace Elite;
 
+//-----------------------------------------------------------------
+// BEHAVIOR INTERFACES (BASE)
+//-----------------------------------------------------------------
+void IBehavior::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	FlatBehavior flatBehavior{ FlatBehaviorType::Opaque, 0, static_cast<unsigned int>(flatBehaviors.size() + 1), { nullptr } };
+	flatBehavior.pBehavior = this;
+	ELITE_BT_PROFILE_SOURCE(flatBehavior, this);
+	flatBehaviors.push_back(flatBehavior);
+}
+
 //-----------------------------------------------------------------
 // BEHAVIOR TREE COMPOSITES (IBehavior)
 //-----------------------------------------------------------------
 #pragma region COMPOSITES
+void BehaviorComposite::FlattenComposite(std::vector<FlatBehavior>& flatBehaviors, FlatBehaviorType type)
+{
+	const size_t index = flatBehaviors.size();
+	FlatBehavior flatBehavior{ type, 0, 0, { nullptr } };
+	flatBehavior.pBehavior = this;
+	ELITE_BT_PROFILE_SOURCE(flatBehavior, this);
+	flatBehaviors.push_back(flatBehavior);
+
+	for (auto child : m_ChildrenBehaviors)
+		child->Flatten(flatBehaviors);
+
+	flatBehaviors[index].end = static_cast<unsigned int>(flatBehaviors.size());
+}
+bool BehaviorComposite::IsPure() const
+{
+	for (auto child : m_ChildrenBehaviors)
+	{
+		if (!child->IsPure())
+			return false;
+	}
+	return true;
+}
+
 //SELECTOR
 BehaviorState BehaviorSelector::Execute(Blackboard* pBlackBoard)
 {
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
 	for (auto child : m_ChildrenBehaviors)
 	{
 		m_CurrentState = child->Execute(pBlackBoard);
@@ -28,9 +63,14 @@ BehaviorState BehaviorSelector::Execute(Blackboard* pBlackBoard)
 	}
 	return m_CurrentState = Failure;
 }
+void BehaviorSelector::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	FlattenComposite(flatBehaviors, FlatBehaviorType::Selector);
+}
 //SEQUENCE
 BehaviorState BehaviorSequence::Execute(Blackboard* pBlackBoard)
 {
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
 	for (auto child : m_ChildrenBehaviors)
 	{
 		m_CurrentState = child->Execute(pBlackBoard);
@@ -49,9 +89,14 @@ BehaviorState BehaviorSequence::Execute(Blackboard* pBlackBoard)
 	}
 	return m_CurrentState = Success;
 }
+void BehaviorSequence::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	FlattenComposite(flatBehaviors, FlatBehaviorType::Sequence);
+}
 //PARTIAL SEQUENCE
 BehaviorState BehaviorPartialSequence::Execute(Blackboard* pBlackBoard)
 {
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
 	while (m_CurrentBehaviorIndex < m_ChildrenBehaviors.size())
 	{
 		m_CurrentState = m_ChildrenBehaviors[m_CurrentBehaviorIndex]->Execute(pBlackBoard);
@@ -71,14 +116,136 @@ BehaviorState BehaviorPartialSequence::Execute(Blackboard* pBlackBoard)
 	m_CurrentBehaviorIndex = 0;
 	return m_CurrentState = Success;
 }
+void BehaviorPartialSequence::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	FlattenComposite(flatBehaviors, FlatBehaviorType::PartialSequence);
+}
+//MEMORY SELECTOR
+BehaviorState BehaviorMemorySelector::Execute(Blackboard* pBlackBoard)
+{
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
+	for (unsigned int i = m_RunningBehaviorIndex; i < m_ChildrenBehaviors.size(); ++i)
+	{
+		m_CurrentState = m_ChildrenBehaviors[i]->Execute(pBlackBoard);
+		switch (m_CurrentState)
+		{
+		case Failure:
+			continue; break;
+		case Success:
+			m_RunningBehaviorIndex = 0;
+			return m_CurrentState; break;
+		case Running:
+			m_RunningBehaviorIndex = i;
+			return m_CurrentState; break;
+		}
+	}
+
+	m_RunningBehaviorIndex = 0;
+	return m_CurrentState = Failure;
+}
+void BehaviorMemorySelector::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	FlattenComposite(flatBehaviors, FlatBehaviorType::MemorySelector);
+}
+//MEMORY SEQUENCE
+BehaviorState BehaviorMemorySequence::Execute(Blackboard* pBlackBoard)
+{
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
+	for (unsigned int i = m_RunningBehaviorIndex; i < m_ChildrenBehaviors.size(); ++i)
+	{
+		m_CurrentState = m_ChildrenBehaviors[i]->Execute(pBlackBoard);
+		switch (m_CurrentState)
+		{
+		case Failure:
+			m_RunningBehaviorIndex = 0;
+			return m_CurrentState; break;
+		case Success:
+			continue; break;
+		case Running:
+			m_RunningBehaviorIndex = i;
+			return m_CurrentState; break;
+		}
+	}
+
+	m_RunningBehaviorIndex = 0;
+	return m_CurrentState = Success;
+}
+void BehaviorMemorySequence::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	FlattenComposite(flatBehaviors, FlatBehaviorType::MemorySequence);
+}
+//PARALLEL
+BehaviorParallel::BehaviorParallel(std::vector<IBehavior*> childrenBehaviors, ThreadPool* pThreadPool,
+	ParallelPolicy successPolicy, ParallelPolicy failurePolicy)
+	: BehaviorComposite(childrenBehaviors), m_pThreadPool(pThreadPool), m_SuccessPolicy(successPolicy), m_FailurePolicy(failurePolicy),
+	m_pChildRuns(new ChildRun[childrenBehaviors.size()])
+{
+	m_Tasks.reserve(m_ChildrenBehaviors.size());
+	for (size_t i = 0; i < m_ChildrenBehaviors.size(); ++i)
+	{
+		m_pChildRuns[i].pBehavior = m_ChildrenBehaviors[i];
+		m_Tasks.push_back({ &BehaviorParallel::RunChild, &m_pChildRuns[i] });
+	}
+
+	if (m_pThreadPool != nullptr && !BehaviorComposite::IsPure())
+	{
+		printf("WARNING: Parallel children write outside the blackboard, they run one after the other \n");
+		m_pThreadPool = nullptr;
+	}
+}
+void BehaviorParallel::RunChild(void* pContext)
+{
+	ChildRun* pRun = static_cast<ChildRun*>(pContext);
+	Blackboard::DeferWritesScope deferWrites(&pRun->writeLog);
+	pRun->state = pRun->pBehavior->Execute(pRun->pBlackBoard);
+}
+BehaviorState BehaviorParallel::Execute(Blackboard* pBlackBoard)
+{
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
+	const unsigned int childCount = static_cast<unsigned int>(m_ChildrenBehaviors.size());
+	for (unsigned int i = 0; i < childCount; ++i)
+		m_pChildRuns[i].pBlackBoard = pBlackBoard;
+
+	if (m_pThreadPool != nullptr)
+		m_pThreadPool->Run(m_Tasks.data(), childCount);
+	else
+	{
+		for (unsigned int i = 0; i < childCount; ++i)
+			RunChild(&m_pChildRuns[i]);
+	}
+
+	//Join: the writes in child order, then the policies
+	unsigned int successCount = 0;
+	unsigned int failureCount = 0;
+	for (unsigned int i = 0; i < childCount; ++i)
+	{
+		ChildRun& run = m_pChildRuns[i];
+		pBlackBoard->ApplyWriteLog(run.writeLog);
+		run.writeLog.Clear();
+		successCount += run.state == Success ? 1 : 0;
+		failureCount += run.state == Failure ? 1 : 0;
+	}
+
+	const bool isFailed = m_FailurePolicy == ParallelPolicy::RequireOne ? failureCount > 0 : failureCount == childCount;
+	const bool isSucceeded = m_SuccessPolicy == ParallelPolicy::RequireOne ? successCount > 0 : successCount == childCount;
+	if (isFailed)
+		return m_CurrentState = Failure;
+	if (isSucceeded)
+		return m_CurrentState = Success;
+	return m_CurrentState = Running;
+}
 #pragma endregion
 //-----------------------------------------------------------------
 // BEHAVIOR TREE CONDITIONAL (IBehavior)
 //-----------------------------------------------------------------
 BehaviorState BehaviorConditional::Execute(Blackboard* pBlackBoard)
 {
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
 	if (m_fpConditional == nullptr)
-		return Failure;
+		return m_CurrentState = Failure;
+
+	if (!m_ObservedSlots.empty())
+		return m_CurrentState = ExecuteObserving(pBlackBoard, m_Memo);
 
 	switch (m_fpConditional(pBlackBoard))
 	{
@@ -89,13 +256,652 @@ BehaviorState BehaviorConditional::Execute(Blackboard* pBlackBoard)
 	}
 	return m_CurrentState = Failure;
 }
+BehaviorState BehaviorConditional::ExecuteObserving(Blackboard* pBlackBoard, unsigned int* pMemo) const
+{
+	const bool isEvaluated = (pMemo[1] & 2) != 0;
+	if (isEvaluated && !pBlackBoard->HasChangedSince(m_ObservedSlots, pMemo[0]))
+		return (pMemo[1] & 1) != 0 ? Success : Failure;
+
+	const bool value = m_fpConditional != nullptr && m_fpConditional(pBlackBoard);
+	pMemo[0] = pBlackBoard->GetChangeCount();
+	pMemo[1] = 2 | (value ? 1 : 0);
+	return value ? Success : Failure;
+}
+void BehaviorConditional::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	//Observing conditionals are called through their node, which is only read, the last result is kept by the tree
+	if (!m_ObservedSlots.empty())
+	{
+		FlatBehavior flatBehavior{ FlatBehaviorType::ObservingConditional, 0, static_cast<unsigned int>(flatBehaviors.size() + 1), { nullptr } };
+		flatBehavior.pObservingConditional = this;
+		ELITE_BT_PROFILE_SOURCE(flatBehavior, this);
+		flatBehaviors.push_back(flatBehavior);
+		return;
+	}
+
+	//Only plain functions can be called directly, anything else the std::function wraps keeps its node
+	auto ppFunction = m_fpConditional.target<bool(*)(Blackboard*)>();
+	if (m_fpConditional != nullptr && ppFunction == nullptr)
+	{
+		IBehavior::Flatten(flatBehaviors);
+		return;
+	}
+
+	FlatBehavior flatBehavior{ FlatBehaviorType::Conditional, 0, static_cast<unsigned int>(flatBehaviors.size() + 1), { nullptr } };
+	flatBehavior.fpConditional = ppFunction ? *ppFunction : nullptr;
+	ELITE_BT_PROFILE_SOURCE(flatBehavior, this);
+	flatBehaviors.push_back(flatBehavior);
+}
 //-----------------------------------------------------------------
 // BEHAVIOR TREE ACTION (IBehavior)
 //-----------------------------------------------------------------
 BehaviorState BehaviorAction::Execute(Blackboard* pBlackBoard)
 {
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
 	if (m_fpAction == nullptr)
-		return Failure;
+		return m_CurrentState = Failure;
 
 	return m_CurrentState = m_fpAction(pBlackBoard);
-}
\ No newline at end of file
+}
+void BehaviorAction::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	auto ppFunction = m_fpAction.target<BehaviorState(*)(Blackboard*)>();
+	if (m_fpAction != nullptr && ppFunction == nullptr)
+	{
+		IBehavior::Flatten(flatBehaviors);
+		return;
+	}
+
+	FlatBehavior flatBehavior{ FlatBehaviorType::Action, 0, static_cast<unsigned int>(flatBehaviors.size() + 1), { nullptr } };
+	flatBehavior.fpAction = ppFunction ? *ppFunction : nullptr;
+	ELITE_BT_PROFILE_SOURCE(flatBehavior, this);
+	flatBehaviors.push_back(flatBehavior);
+}
+
+//-----------------------------------------------------------------
+// BEHAVIOR TREE DECORATORS (IBehavior)
+//-----------------------------------------------------------------
+#pragma region DECORATORS
+BehaviorState BehaviorDecorator::Execute(Blackboard* pBlackBoard)
+{
+	ELITE_BT_PROFILE_NODE(this, m_CurrentState);
+	TimingWheel* pTimingWheel = nullptr;
+	if (IsTimed())
+	{
+		pTimingWheel = GetTimingWheel(pBlackBoard);
+		if (pTimingWheel == nullptr)
+			return m_CurrentState = Failure;
+	}
+
+	if (!Enter(m_State, pTimingWheel, m_CurrentState))
+		return m_CurrentState;
+	const BehaviorState childState = m_pChildBehavior != nullptr ? m_pChildBehavior->Execute(pBlackBoard) : Failure;
+	return m_CurrentState = Leave(m_State, pTimingWheel, childState);
+}
+void BehaviorDecorator::Flatten(std::vector<FlatBehavior>& flatBehaviors)
+{
+	const size_t index = flatBehaviors.size();
+	FlatBehavior flatBehavior{ FlatBehaviorType::Decorator, 0, 0, { nullptr } };
+	flatBehavior.pDecorator = this;
+	ELITE_BT_PROFILE_SOURCE(flatBehavior, this);
+	flatBehaviors.push_back(flatBehavior);
+
+	if (m_pChildBehavior != nullptr)
+		m_pChildBehavior->Flatten(flatBehaviors);
+
+	flatBehaviors[index].end = static_cast<unsigned int>(flatBehaviors.size());
+}
+TimingWheel* BehaviorDecorator::GetTimingWheel(Blackboard* pBlackBoard)
+{
+	if (!m_TimingWheelKey.IsValid())
+		m_TimingWheelKey = pBlackBoard->GetKey<TimingWheel*>("TimingWheel");
+
+	TimingWheel* pTimingWheel = nullptr;
+	if (!pBlackBoard->TryGetData(m_TimingWheelKey, pTimingWheel) || pTimingWheel == nullptr)
+	{
+		printf("WARNING: Timed decorator needs a 'TimingWheel' in the Blackboard \n");
+		return nullptr;
+	}
+	return pTimingWheel;
+}
+
+//COOLDOWN
+bool BehaviorCooldown::Enter(BehaviorDecoratorState& decoratorState, TimingWheel* /*pTimingWheel*/, BehaviorState& state) const
+{
+	state = Failure;
+	return !decoratorState.timer.IsPending();
+}
+BehaviorState BehaviorCooldown::Leave(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState childState) const
+{
+	if (childState == Success)
+		pTimingWheel->Schedule(decoratorState.timer, m_Cooldown);
+	return childState;
+}
+
+//TIMEOUT
+bool BehaviorTimeout::Enter(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState& state) const
+{
+	if (decoratorState.isRunning && !decoratorState.timer.IsPending())
+	{
+		decoratorState.isRunning = false;
+		state = Failure;
+		return false;
+	}
+
+	if (!decoratorState.isRunning)
+	{
+		pTimingWheel->Schedule(decoratorState.timer, m_Timeout);
+		decoratorState.isRunning = true;
+	}
+	return true;
+}
+BehaviorState BehaviorTimeout::Leave(BehaviorDecoratorState& decoratorState, TimingWheel* /*pTimingWheel*/, BehaviorState childState) const
+{
+	if (childState != Running)
+	{
+		decoratorState.isRunning = false;
+		TimingWheel::Cancel(decoratorState.timer); //The next run starts a fresh timeout
+	}
+	return childState;
+}
+
+//RATE LIMIT
+bool BehaviorRateLimit::Enter(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState& state) const
+{
+	if (!decoratorState.timer.IsPending())
+	{
+		pTimingWheel->Schedule(decoratorState.timer, m_Window);
+		decoratorState.count = 0;
+	}
+
+	state = Failure;
+	if (decoratorState.count >= m_MaxRuns)
+		return false;
+	++decoratorState.count;
+	return true;
+}
+BehaviorState BehaviorRateLimit::Leave(BehaviorDecoratorState& /*decoratorState*/, TimingWheel* /*pTimingWheel*/, BehaviorState childState) const
+{
+	return childState;
+}
+
+//INVERTER
+BehaviorState BehaviorInverter::Leave(BehaviorDecoratorState& /*decoratorState*/, TimingWheel* /*pTimingWheel*/, BehaviorState childState) const
+{
+	switch (childState)
+	{
+	case Failure:
+		return Success;
+	case Success:
+		return Failure;
+	default:
+		return Running;
+	}
+}
+
+//REPEATER
+BehaviorState BehaviorRepeater::Leave(BehaviorDecoratorState& decoratorState, TimingWheel* /*pTimingWheel*/, BehaviorState childState) const
+{
+	if (childState == Failure)
+	{
+		decoratorState.count = 0;
+		return Failure;
+	}
+
+	if (childState == Success && m_RepeatCount > 0 && ++decoratorState.count >= m_RepeatCount)
+	{
+		decoratorState.count = 0;
+		return Success;
+	}
+	return Running;
+}
+#pragma endregion
+
+//-----------------------------------------------------------------
+// BEHAVIOR TREE DEFINITION
+//-----------------------------------------------------------------
+BehaviorTreeDefinition::BehaviorTreeDefinition(IBehavior* pRootComposite)
+	: m_pRootComposite(pRootComposite)
+{
+	if (m_pRootComposite == nullptr)
+		return;
+
+	m_pRootComposite->Flatten(m_CompiledBehaviors);
+
+	//Lay out the state of the nodes that have any one after the other, the decorators and instances each on their own
+	m_IsShareable = true;
+	for (FlatBehavior& behavior : m_CompiledBehaviors)
+	{
+		unsigned int* pStateCount = &m_StateCount;
+		unsigned int stateSize = 0;
+		switch (behavior.type)
+		{
+		case FlatBehaviorType::PartialSequence: //Current child
+		case FlatBehaviorType::MemorySelector: //Running child's index, 0 is none
+		case FlatBehaviorType::MemorySequence:
+			stateSize = 1;
+			break;
+		case FlatBehaviorType::ObservingConditional: //See BehaviorConditional::ExecuteObserving
+			stateSize = 2;
+			break;
+		case FlatBehaviorType::Decorator:
+			pStateCount = &m_DecoratorCount;
+			stateSize = 1;
+			break;
+		case FlatBehaviorType::Instanced:
+			pStateCount = &m_InstanceCount;
+			stateSize = 1;
+			break;
+		case FlatBehaviorType::Opaque:
+			m_IsShareable = false;
+			break;
+		default:
+			break;
+		}
+
+		if (stateSize == 0)
+			continue;
+		if (*pStateCount + stateSize > 0xFFFF)
+		{
+			printf("WARNING: Behavior tree has too many nodes with state to compile \n");
+			m_CompiledBehaviors.clear();
+			m_StateCount = 0;
+			m_DecoratorCount = 0;
+			m_InstanceCount = 0;
+			m_IsShareable = false;
+			return;
+		}
+		behavior.stateIndex = static_cast<unsigned short>(*pStateCount);
+		*pStateCount += stateSize;
+	}
+}
+
+//-----------------------------------------------------------------
+// BEHAVIOR TREE (BASE)
+//-----------------------------------------------------------------
+BehaviorTree::BehaviorTree(Blackboard* pBlackBoard, IBehavior* pRootComposite)
+	: m_pBlackBoard(pBlackBoard), m_pDefinition(std::make_shared<BehaviorTreeDefinition>(pRootComposite))
+{
+	m_pBlackBoard->AddData("ConditionCache", &m_ConditionCache);
+	m_pBlackBoard->AddData("TimingWheel", &m_TimingWheel);
+	m_pBlackBoard->AddData("RunningNodes", &m_RunningNodes);
+#if ELITE_BT_PROFILER
+	InitializeProfiler();
+#endif
+}
+
+BehaviorTree::BehaviorTree(Blackboard* pBlackBoard, std::shared_ptr<const BehaviorTreeDefinition> pDefinition)
+	: m_pBlackBoard(pBlackBoard), m_pDefinition(pDefinition)
+{
+	m_pBlackBoard->AddData("ConditionCache", &m_ConditionCache);
+	m_pBlackBoard->AddData("TimingWheel", &m_TimingWheel);
+	m_pBlackBoard->AddData("RunningNodes", &m_RunningNodes);
+#if ELITE_BT_PROFILER
+	InitializeProfiler();
+#endif
+	Compile();
+}
+
+void BehaviorTree::Update(float deltaTime)
+{
+	if (m_pDefinition == nullptr || m_pDefinition->GetRoot() == nullptr)
+	{
+		m_CurrentState = Failure;
+		return;
+	}
+
+	//Timers run in real time, also while no decision is made. One expiring is a reason to decide again.
+	const bool hasExpiredTimers = m_TimingWheel.Advance(deltaTime) > 0;
+
+	//A suspended decision continues every frame, regardless of the interval
+	if (m_DecisionInterval > 0.f && !m_IsSuspended)
+	{
+		m_TimeSinceDecision += deltaTime;
+		if (m_TimeSinceDecision < m_DecisionInterval)
+			return;
+		//Don't catch up on decisions missed during a long frame
+		m_TimeSinceDecision = (std::min)(m_TimeSinceDecision - m_DecisionInterval, m_DecisionInterval);
+	}
+
+	//Nothing was written since the last tick finished, so a tree that isn't running anything would decide the same
+	if (!m_IsSuspended && m_SkipUnchangedTicks && m_HasRun && m_CurrentState != Running && !hasExpiredTimers && m_pBlackBoard->GetChangeCount() == m_LastChangeCount)
+		return;
+
+	m_ConditionCache.NewTick();
+	if (m_IsCompiled)
+	{
+		m_SliceLeafCount = 0;
+		if (m_TimeBudget > 0.f)
+			m_SliceDeadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(m_TimeBudget));
+
+		BehaviorState state = Failure;
+		if (m_IsSuspended)
+		{
+			m_IsSuspended = false;
+			state = RunCompiled(m_SuspendedIndex, 0, false, Failure);
+		}
+		else
+			state = m_RunningPath.empty() ? RunCompiled(0, 0, false, Failure) : ResumeCompiled();
+
+		if (m_IsSuspended)
+			return;
+		m_CurrentState = state;
+		if (state != Running)
+			m_RunningPath.clear(); //A decorator can turn its running child's state into another one
+	}
+	else
+	{
+		ELITE_BT_PROFILE_ACTIVATE(&m_Profiler);
+		m_CurrentState = m_pDefinition->GetRoot()->Execute(m_pBlackBoard);
+	}
+	m_RunningNodes.EndTick();
+	m_LastChangeCount = m_pBlackBoard->GetChangeCount();
+	m_HasRun = true;
+}
+
+bool BehaviorTree::Compile()
+{
+	//Whatever ran before, in the pointer tree or the instances of the last compile, is dropped
+	m_RunningNodes.AbortAll();
+	AbortInstances();
+
+	m_IsSuspended = false;
+	m_IsCompiled = m_pDefinition != nullptr && !m_pDefinition->GetBehaviors().empty();
+	if (!m_IsCompiled)
+		return false;
+
+	const size_t nodeCount = m_pDefinition->GetBehaviors().size();
+	m_CompiledNodeStates.assign(m_pDefinition->GetStateCount(), 0);
+	m_pDecoratorStates.reset(new BehaviorDecoratorState[m_pDefinition->GetDecoratorCount()]);
+	m_Instances.assign(m_pDefinition->GetInstanceCount(), nullptr);
+	m_CompiledStack.clear();
+	m_CompiledStack.reserve(nodeCount);
+	m_RunningPath.clear();
+	m_RunningPath.reserve(nodeCount);
+	return true;
+}
+
+void BehaviorTree::AbortInstances()
+{
+	if (m_Instances.empty())
+		return;
+
+	for (const FlatBehavior& behavior : m_pDefinition->GetBehaviors())
+	{
+		if (behavior.type == FlatBehaviorType::Instanced && m_Instances[behavior.stateIndex] != nullptr)
+			behavior.pBehavior->AbortInstance(m_Instances[behavior.stateIndex]);
+	}
+}
+
+#if ELITE_BT_PROFILER
+//Names every node by its path of type and child number from the root, in the same pre-order Compile flattens in
+void BehaviorTree::InitializeProfiler()
+{
+	static const char* typeNames[] = { "Selector", "Sequence", "PartialSequence", "MemorySelector", "MemorySequence", "Conditional", "Conditional", "Action", "Decorator", "Instanced", "Opaque" };
+
+	const std::vector<FlatBehavior>& flatBehaviors = m_pDefinition->GetBehaviors();
+
+	std::vector<std::string> paths(flatBehaviors.size());
+	std::vector<const void*> pSources(flatBehaviors.size());
+	std::vector<unsigned int> parents = {};
+	for (unsigned int i = 0; i < flatBehaviors.size(); ++i)
+	{
+		while (!parents.empty() && flatBehaviors[parents.back()].end <= i)
+			parents.pop_back();
+
+		unsigned int childNumber = 0;
+		if (!parents.empty())
+		{
+			for (unsigned int sibling = parents.back() + 1; sibling < i; sibling = flatBehaviors[sibling].end)
+				++childNumber;
+			paths[i] = paths[parents.back()] + "/";
+		}
+		paths[i] += std::string(typeNames[static_cast<int>(flatBehaviors[i].type)]) + "[" + std::to_string(childNumber) + "]";
+		pSources[i] = flatBehaviors[i].pSource;
+		parents.push_back(i);
+	}
+	m_Profiler.SetNodes(paths, pSources);
+}
+#endif
+
+unsigned int BehaviorTree::GetCompiledChild(unsigned int parentIndex, unsigned int childIndex) const
+{
+	const std::vector<FlatBehavior>& behaviors = m_pDefinition->GetBehaviors();
+	unsigned int child = parentIndex + 1;
+	for (unsigned int i = 0; i < childIndex && child < behaviors[parentIndex].end; ++i)
+		child = behaviors[child].end;
+	return child;
+}
+
+void BehaviorTree::RecordRunningPath(unsigned int index)
+{
+	if (!m_ResumeRunningPath)
+		return;
+
+	m_RunningPath.assign(m_CompiledStack.begin(), m_CompiledStack.end());
+	if (m_RunningPath.empty() || m_RunningPath.back() != index)
+		m_RunningPath.push_back(index);
+}
+
+//Only a top level run suspends, the guards ResumeCompiled checks run to the end.
+//The stack stays as it is, so the next Update continues at 'index' as if it was never interrupted.
+bool BehaviorTree::ShouldSuspend(unsigned int index, size_t stackBase)
+{
+	if (stackBase != 0 || m_SliceLeafCount == 0)
+		return false;
+	const bool isLeafBudgetSpent = m_LeafBudget > 0 && m_SliceLeafCount >= m_LeafBudget;
+	const bool isTimeBudgetSpent = m_TimeBudget > 0.f && std::chrono::steady_clock::now() >= m_SliceDeadline;
+	if (!isLeafBudgetSpent && !isTimeBudgetSpent)
+		return false;
+
+	m_SuspendedIndex = index;
+	m_IsSuspended = true;
+	return true;
+}
+
+//Same semantics as executing the pointer tree, walked iteratively over the flat array:
+//descend to the next leaf, then hand its state up until a composite continues with a sibling.
+//Runs the subtree at 'index' on top of the nodes already on the stack and returns once the stack is back at 'stackBase'.
+//With 'isAscending' the node at 'index' already returned 'state' and only its parents still need to handle it.
+BehaviorState BehaviorTree::RunCompiled(unsigned int index, size_t stackBase, bool isAscending, BehaviorState state)
+{
+	const FlatBehavior* pBehaviors = m_pDefinition->GetBehaviors().data();
+	unsigned int* pNodeStates = m_CompiledNodeStates.data();
+
+	for (;;)
+	{
+		if (!isAscending)
+		{
+			if (ShouldSuspend(index, stackBase))
+				return Running;
+
+			const FlatBehavior& behavior = pBehaviors[index];
+			state = Failure;
+			ELITE_BT_PROFILE_BEGIN(m_Profiler, index);
+			switch (behavior.type)
+			{
+			case FlatBehaviorType::Selector:
+			case FlatBehaviorType::Sequence:
+				if (behavior.end == index + 1)
+				{
+					state = behavior.type == FlatBehaviorType::Selector ? Failure : Success;
+					break;
+				}
+				m_CompiledStack.push_back(index);
+				++index;
+				continue;
+			case FlatBehaviorType::MemorySelector:
+			case FlatBehaviorType::MemorySequence:
+				if (behavior.end == index + 1)
+				{
+					state = behavior.type == FlatBehaviorType::MemorySelector ? Failure : Success;
+					break;
+				}
+				m_CompiledStack.push_back(index);
+				index = pNodeStates[behavior.stateIndex] != 0 ? pNodeStates[behavior.stateIndex] : index + 1; //The memory composites store the running child's index
+				continue;
+			case FlatBehaviorType::PartialSequence:
+			{
+				const unsigned int child = GetCompiledChild(index, pNodeStates[behavior.stateIndex]);
+				if (child == behavior.end)
+				{
+					pNodeStates[behavior.stateIndex] = 0;
+					state = Success;
+					break;
+				}
+				m_CompiledStack.push_back(index);
+				index = child;
+				continue;
+			}
+			case FlatBehaviorType::Conditional:
+				++m_SliceLeafCount;
+				if (behavior.fpConditional != nullptr)
+					state = behavior.fpConditional(m_pBlackBoard) ? Success : Failure;
+				break;
+			case FlatBehaviorType::ObservingConditional:
+				++m_SliceLeafCount;
+				state = behavior.pObservingConditional->ExecuteObserving(m_pBlackBoard, pNodeStates + behavior.stateIndex);
+				break;
+			case FlatBehaviorType::Action:
+				++m_SliceLeafCount;
+				if (behavior.fpAction != nullptr)
+					state = behavior.fpAction(m_pBlackBoard);
+				break;
+			case FlatBehaviorType::Decorator:
+				if (!behavior.pDecorator->Enter(m_pDecoratorStates[behavior.stateIndex], &m_TimingWheel, state))
+					break;
+				if (behavior.end == index + 1)
+				{
+					state = behavior.pDecorator->Leave(m_pDecoratorStates[behavior.stateIndex], &m_TimingWheel, Failure);
+					break;
+				}
+				m_CompiledStack.push_back(index);
+				++index;
+				continue;
+			case FlatBehaviorType::Instanced:
+				++m_SliceLeafCount;
+				state = behavior.pBehavior->ExecuteInstance(m_pBlackBoard, m_Instances[behavior.stateIndex]);
+				if (state == Running)
+					m_RunningNodes.Report(behavior.pBehavior, &m_Instances[behavior.stateIndex]);
+				break;
+			case FlatBehaviorType::Opaque:
+				++m_SliceLeafCount;
+				state = behavior.pBehavior->Execute(m_pBlackBoard);
+				break;
+			}
+
+			ELITE_BT_PROFILE_END(m_Profiler, index, state);
+			if (state == Running)
+				RecordRunningPath(index);
+		}
+		isAscending = false;
+
+		for (;;)
+		{
+			if (m_CompiledStack.size() == stackBase)
+				return state;
+
+			const unsigned int parent = m_CompiledStack.back();
+			const FlatBehavior& parentBehavior = pBehaviors[parent];
+			const unsigned int next = pBehaviors[index].end;
+			bool continueWithNext = false;
+			switch (parentBehavior.type)
+			{
+			case FlatBehaviorType::Selector:
+				continueWithNext = state == Failure && next < parentBehavior.end;
+				break;
+			case FlatBehaviorType::Sequence:
+				continueWithNext = state == Success && next < parentBehavior.end;
+				break;
+			case FlatBehaviorType::MemorySelector:
+				continueWithNext = state == Failure && next < parentBehavior.end;
+				pNodeStates[parentBehavior.stateIndex] = state == Running ? index : 0;
+				break;
+			case FlatBehaviorType::MemorySequence:
+				continueWithNext = state == Success && next < parentBehavior.end;
+				pNodeStates[parentBehavior.stateIndex] = state == Running ? index : 0;
+				break;
+			case FlatBehaviorType::PartialSequence:
+				if (state == Failure)
+					pNodeStates[parentBehavior.stateIndex] = 0;
+				else if (state == Success)
+				{
+					++pNodeStates[parentBehavior.stateIndex];
+					state = Running;
+					RecordRunningPath(parent); //Resumes at the partial sequence itself, it knows which child is next
+				}
+				break;
+			case FlatBehaviorType::Decorator:
+			{
+				const BehaviorState childState = state;
+				state = parentBehavior.pDecorator->Leave(m_pDecoratorStates[parentBehavior.stateIndex], &m_TimingWheel, childState);
+				if (state == Running && childState != Running)
+					RecordRunningPath(parent); //E.g. a repeater, resumes at the decorator to run the child again
+				break;
+			}
+			default:
+				break;
+			}
+
+			if (continueWithNext)
+			{
+				index = next;
+				break;
+			}
+			m_CompiledStack.pop_back();
+			ELITE_BT_PROFILE_END(m_Profiler, parent, state);
+			index = parent;
+		}
+	}
+}
+
+//Walks down last tick's running path. A higher-priority selector child or a sequence guard that no longer
+//lets the path through takes over, its state is handed up from there as if the tree ran from the root.
+BehaviorState BehaviorTree::ResumeCompiled()
+{
+	const FlatBehavior* pBehaviors = m_pDefinition->GetBehaviors().data();
+	m_CompiledStack.clear();
+
+	const size_t resumeDepth = m_RunningPath.size() - 1;
+	for (size_t depth = 0; depth < resumeDepth; ++depth)
+	{
+		const unsigned int parent = m_RunningPath[depth];
+		const unsigned int pathChild = m_RunningPath[depth + 1];
+		const FlatBehaviorType type = pBehaviors[parent].type;
+		m_CompiledStack.push_back(parent);
+		ELITE_BT_PROFILE_BEGIN(m_Profiler, parent);
+		if (type == FlatBehaviorType::Decorator)
+		{
+			//Asked again whether the child may run, e.g. a timeout that expired doesn't let the path through
+			BehaviorState state = Failure;
+			if (pBehaviors[parent].pDecorator->Enter(m_pDecoratorStates[pBehaviors[parent].stateIndex], &m_TimingWheel, state))
+				continue;
+			m_CompiledStack.pop_back();
+			m_RunningPath.clear();
+			ELITE_BT_PROFILE_END(m_Profiler, parent, state);
+			return RunCompiled(parent, 0, true, state);
+		}
+		if (type != FlatBehaviorType::Selector && type != FlatBehaviorType::Sequence)
+			continue; //Memory composites and partial sequences already continue at the path's child
+
+		for (unsigned int child = parent + 1; child < pathChild; child = pBehaviors[child].end)
+		{
+			const FlatBehaviorType childType = pBehaviors[child].type;
+			if (type == FlatBehaviorType::Sequence && childType != FlatBehaviorType::Conditional && childType != FlatBehaviorType::ObservingConditional)
+				continue;
+
+			const BehaviorState state = RunCompiled(child, m_CompiledStack.size(), false, Failure);
+			const bool isInterrupted = type == FlatBehaviorType::Selector ? state != Failure : state == Failure;
+			if (isInterrupted)
+			{
+				if (state != Running)
+					m_RunningPath.clear();
+				return RunCompiled(child, 0, true, state);
+			}
+		}
+	}
+
+	const unsigned int resumeIndex = m_RunningPath.back();
+	m_RunningPath.clear();
+	return RunCompiled(resumeIndex, 0, false, Failure);
+}
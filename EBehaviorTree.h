@@ -9,6 +9,11 @@
 
 //--- Includes ---
 #include "EDecisionMaking.h"
+#include "EBehaviorProfiler.h"
+#include "EThreadPool.h"
+#include "ETimingWheel.h"
+#include <algorithm>
+#include <chrono>
 
 namespace Elite
 {
@@ -22,6 +27,49 @@ namespace Elite
 		Running
 	};
 
+	class IBehavior;
+	class BehaviorConditional;
+	class BehaviorDecorator;
+
+	//-----------------------------------------------------------------
+	// COMPILED BEHAVIOR TREE (FLAT)
+	//-----------------------------------------------------------------
+	//A tree flattened in pre-order into one contiguous array. Every node knows where its subtree ends,
+	//which is also where its next sibling starts, so the tree is walked with indices instead of pointers.
+	//Nodes that keep state between ticks (see BehaviorTreeDefinition) only know where it is, it's owned by the tree running them.
+	enum class FlatBehaviorType : unsigned char
+	{
+		Selector,
+		Sequence,
+		PartialSequence,
+		MemorySelector,
+		MemorySequence,
+		Conditional,
+		ObservingConditional,
+		Action,
+		Decorator, //One child, the decorator only decides around it (see BehaviorDecorator::Enter and Leave)
+		Instanced, //Leaf whose running work is one pointer kept by the tree (see IBehavior::ExecuteInstance)
+		Opaque //Node that can't be flattened, executed through its IBehavior
+	};
+
+	struct FlatBehavior final
+	{
+		FlatBehaviorType type;
+		unsigned short stateIndex; //First word of this node's state, for the node types that have any
+		unsigned int end; //One past the last node of this subtree
+		union
+		{
+			bool(*fpConditional)(Blackboard*);
+			BehaviorState(*fpAction)(Blackboard*);
+			const BehaviorConditional* pObservingConditional;
+			const BehaviorDecorator* pDecorator;
+			IBehavior* pBehavior;
+		};
+#if ELITE_BT_PROFILER
+		const IBehavior* pSource = nullptr; //Node this was flattened from, also for the leaves
+#endif
+	};
+
 	//-----------------------------------------------------------------
 	// BEHAVIOR INTERFACES (BASE)
 	//-----------------------------------------------------------------
@@ -32,6 +80,25 @@ namespace Elite
 		virtual ~IBehavior() = default;
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) = 0;
 
+		//Appends this node and its subtree in pre-order. By default the node is kept as is and called through Execute.
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors);
+
+		//Drops whatever the node was in the middle of. Called by the tree on the nodes that reported they are
+		//running (see BehaviorRunningNodes) once a tick doesn't reach them anymore.
+		virtual void Abort() {}
+
+		//Nodes that flatten to FlatBehaviorType::Instanced. Instead of in the node, the work that runs over several ticks
+		//is kept in 'pInstance', one per tree running the node and null while there is none, so the node is only read.
+		virtual BehaviorState ExecuteInstance(Blackboard* /*pBlackBoard*/, void*& /*pInstance*/) const
+		{ return Failure; }
+		virtual void AbortInstance(void*& /*pInstance*/) const {}
+
+		//Whether the node and its subtree write nothing but the blackboard and their own nodes. Only then BehaviorParallel
+		//runs it on another thread, where its blackboard writes are deferred. Anything else, e.g. a steering behavior
+		//written through a pointer, would race with the other children.
+		virtual bool IsPure() const
+		{ return false; }
+
 	protected:
 		BehaviorState m_CurrentState = Failure;
 	};
@@ -57,8 +124,11 @@ namespace Elite
 		}
 
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) override = 0;
+		virtual bool IsPure() const override;
 
 	protected:
+		void FlattenComposite(std::vector<FlatBehavior>& flatBehaviors, FlatBehaviorType type);
+
 		std::vector<IBehavior*> m_ChildrenBehaviors = {};
 	};
 
@@ -71,6 +141,7 @@ namespace Elite
 		virtual ~BehaviorSelector() = default;
 
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
 	};
 
 	//--- SEQUENCE ---
@@ -82,6 +153,7 @@ namespace Elite
 		virtual ~BehaviorSequence() = default;
 
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
 	};
 
 	//--- PARTIAL SEQUENCE ---
@@ -93,23 +165,111 @@ namespace Elite
 		virtual ~BehaviorPartialSequence() = default;
 
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
 
 	private:
 		unsigned int m_CurrentBehaviorIndex = 0;
 	};
+
+	//--- MEMORY SELECTOR ---
+	//Selector that remembers its running child and continues from it next tick, without re-checking the children before it
+	class BehaviorMemorySelector : public BehaviorComposite
+	{
+	public:
+		explicit BehaviorMemorySelector(std::vector<IBehavior*> childrenBehaviors) :
+			BehaviorComposite(childrenBehaviors) {}
+		virtual ~BehaviorMemorySelector() = default;
+
+		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
+
+	private:
+		unsigned int m_RunningBehaviorIndex = 0;
+	};
+
+	//--- MEMORY SEQUENCE ---
+	//Sequence that remembers its running child and continues from it next tick, without re-running the children before it
+	class BehaviorMemorySequence : public BehaviorComposite
+	{
+	public:
+		explicit BehaviorMemorySequence(std::vector<IBehavior*> childrenBehaviors) :
+			BehaviorComposite(childrenBehaviors) {}
+		virtual ~BehaviorMemorySequence() = default;
+
+		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
+
+	private:
+		unsigned int m_RunningBehaviorIndex = 0;
+	};
+
+	//--- PARALLEL ---
+	enum class ParallelPolicy
+	{
+		RequireOne,
+		RequireAll
+	};
+
+	//Ticks every child every tick, spread over the thread pool when it has one. Their blackboard writes are held back
+	//and made at the join in child order, so the outcome doesn't depend on which thread finished first. Children that
+	//aren't pure (see IBehavior::IsPure) would write around that, with them the pool isn't used and the children run
+	//one after the other. Fails when the failure policy is met, else succeeds when the success policy is met, else runs.
+	class BehaviorParallel : public BehaviorComposite
+	{
+	public:
+		explicit BehaviorParallel(std::vector<IBehavior*> childrenBehaviors, ThreadPool* pThreadPool = nullptr,
+			ParallelPolicy successPolicy = ParallelPolicy::RequireAll, ParallelPolicy failurePolicy = ParallelPolicy::RequireOne);
+		virtual ~BehaviorParallel() = default;
+
+		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+
+	private:
+		struct ChildRun
+		{
+			IBehavior* pBehavior = nullptr;
+			Blackboard* pBlackBoard = nullptr;
+			BlackboardWriteLog writeLog = {};
+			BehaviorState state = Failure;
+		};
+		static void RunChild(void* pContext);
+
+		ThreadPool* m_pThreadPool = nullptr; //Not owned, shared by every parallel node using it
+		ParallelPolicy m_SuccessPolicy = ParallelPolicy::RequireAll;
+		ParallelPolicy m_FailurePolicy = ParallelPolicy::RequireOne;
+		std::unique_ptr<ChildRun[]> m_pChildRuns = nullptr;
+		std::vector<ThreadPool::Task> m_Tasks = {};
+	};
 #pragma endregion
 
 	//-----------------------------------------------------------------
 	// BEHAVIOR TREE CONDITIONAL (IBehavior)
 	//-----------------------------------------------------------------
+	//Slot indices of the blackboard keys a conditional reads, see BehaviorConditional
+	template<typename... TKeys> std::vector<unsigned int> ObserveKeys(const TKeys&... keys)
+	{ return std::vector<unsigned int>{ keys.GetIndex()... }; }
+
 	class BehaviorConditional : public IBehavior
 	{
 	public:
 		explicit BehaviorConditional(std::function<bool(Blackboard*)> fp) : m_fpConditional(fp) {}
+		//A conditional that declares every key it reads is only evaluated again once one of them changed,
+		//until then it returns its last result. Anything else it depends on must go through those keys.
+		explicit BehaviorConditional(std::function<bool(Blackboard*)> fp, std::vector<unsigned int> observedSlots)
+			: m_fpConditional(fp), m_ObservedSlots(observedSlots) {}
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
+		//Conditionals only read
+		virtual bool IsPure() const override
+		{ return true; }
+
+		//Observing conditionals only. Evaluates, or returns the result remembered in 'pMemo' while none of the observed
+		//keys changed. The memo is two words: the change count it was evaluated at, and an evaluated bit above the result.
+		BehaviorState ExecuteObserving(Blackboard* pBlackBoard, unsigned int* pMemo) const;
 
 	private:
 		std::function<bool(Blackboard*)> m_fpConditional = nullptr;
+		std::vector<unsigned int> m_ObservedSlots = {};
+		unsigned int m_Memo[2] = {};
 	};
 
 	//-----------------------------------------------------------------
@@ -118,11 +278,326 @@ namespace Elite
 	class BehaviorAction : public IBehavior
 	{
 	public:
-		explicit BehaviorAction(std::function<BehaviorState(Blackboard*)> fp) : m_fpAction(fp) {}
+		//'isPure' declares the action writes nothing but the blackboard, see IBehavior::IsPure
+		explicit BehaviorAction(std::function<BehaviorState(Blackboard*)> fp, bool isPure = false) : m_fpAction(fp), m_IsPure(isPure) {}
 		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
+		virtual bool IsPure() const override
+		{ return m_IsPure; }
 
 	private:
 		std::function<BehaviorState(Blackboard*)> m_fpAction = nullptr;
+		bool m_IsPure = false;
+	};
+
+	//-----------------------------------------------------------------
+	// BEHAVIOR TREE DECORATORS (IBehavior)
+	//-----------------------------------------------------------------
+#pragma region DECORATORS
+	//What a decorator keeps between ticks: the node's own in the pointer tree, the BehaviorTree's in a compiled one
+	struct BehaviorDecoratorState final
+	{
+		TimingWheel::Timer timer = {};
+		unsigned int count = 0; //Runs in the rate limit's window, successes of the repeater
+		bool isRunning = false; //The timeout was started
+	};
+
+	//--- DECORATOR BASE ---
+	//One child, run when Enter lets it, and the decorator's state made from the child's by Leave. Both only read the
+	//node, so a compiled tree keeps a BehaviorDecoratorState of its own for every decorator and definitions with them
+	//stay shareable. The timed ones schedule its timer on a timing wheel: a compiled tree's own, or the one the pointer
+	//tree registers in the blackboard as "TimingWheel". Both are advanced every Update, without one they fail.
+	class BehaviorDecorator : public IBehavior
+	{
+	public:
+		explicit BehaviorDecorator(IBehavior* pChildBehavior) : m_pChildBehavior(pChildBehavior) {}
+		virtual ~BehaviorDecorator()
+		{
+			delete(m_pChildBehavior);
+			m_pChildBehavior = nullptr;
+		}
+
+		virtual BehaviorState Execute(Blackboard* pBlackBoard) override;
+		virtual void Flatten(std::vector<FlatBehavior>& flatBehaviors) override;
+		//The timed ones schedule on the tree's wheel, which only the updating thread may
+		virtual bool IsPure() const override
+		{ return !IsTimed() && (m_pChildBehavior == nullptr || m_pChildBehavior->IsPure()); }
+
+		//Whether Enter and Leave use the timing wheel, it's never null for the ones that do
+		virtual bool IsTimed() const
+		{ return false; }
+		//Before the child runs. Returns false, with the decorator's state in 'state', when the child doesn't run.
+		virtual bool Enter(BehaviorDecoratorState& /*decoratorState*/, TimingWheel* /*pTimingWheel*/, BehaviorState& /*state*/) const
+		{ return true; }
+		//The decorator's state once the child returned 'childState'
+		virtual BehaviorState Leave(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState childState) const = 0;
+
+	protected:
+		TimingWheel* GetTimingWheel(Blackboard* pBlackBoard);
+
+		IBehavior* m_pChildBehavior = nullptr;
+		BlackboardKey<TimingWheel*> m_TimingWheelKey = {};
+		BehaviorDecoratorState m_State = {};
+	};
+
+	//--- COOLDOWN ---
+	//Fails without running the child for 'cooldown' seconds after it succeeded
+	class BehaviorCooldown : public BehaviorDecorator
+	{
+	public:
+		explicit BehaviorCooldown(IBehavior* pChildBehavior, float cooldown)
+			: BehaviorDecorator(pChildBehavior), m_Cooldown(cooldown) {}
+
+		virtual bool IsTimed() const override
+		{ return true; }
+		virtual bool Enter(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState& state) const override;
+		virtual BehaviorState Leave(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState childState) const override;
+
+	private:
+		float m_Cooldown = 0.f;
+	};
+
+	//--- TIMEOUT ---
+	//Fails when the child is still running 'timeout' seconds after it started
+	class BehaviorTimeout : public BehaviorDecorator
+	{
+	public:
+		explicit BehaviorTimeout(IBehavior* pChildBehavior, float timeout)
+			: BehaviorDecorator(pChildBehavior), m_Timeout(timeout) {}
+
+		virtual bool IsTimed() const override
+		{ return true; }
+		virtual bool Enter(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState& state) const override;
+		virtual BehaviorState Leave(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState childState) const override;
+
+	private:
+		float m_Timeout = 0.f;
+	};
+
+	//--- RATE LIMIT ---
+	//Runs the child at most 'maxRuns' times in every window of 'window' seconds, fails without running it beyond that.
+	//A window starts at the first run after the last one ended.
+	class BehaviorRateLimit : public BehaviorDecorator
+	{
+	public:
+		explicit BehaviorRateLimit(IBehavior* pChildBehavior, unsigned int maxRuns, float window)
+			: BehaviorDecorator(pChildBehavior), m_MaxRuns(maxRuns), m_Window(window) {}
+
+		virtual bool IsTimed() const override
+		{ return true; }
+		virtual bool Enter(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState& state) const override;
+		virtual BehaviorState Leave(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState childState) const override;
+
+	private:
+		unsigned int m_MaxRuns = 1;
+		float m_Window = 0.f;
+	};
+
+	//--- INVERTER ---
+	class BehaviorInverter : public BehaviorDecorator
+	{
+	public:
+		explicit BehaviorInverter(IBehavior* pChildBehavior) : BehaviorDecorator(pChildBehavior) {}
+
+		virtual BehaviorState Leave(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState childState) const override;
+	};
+
+	//--- REPEATER ---
+	//Runs the child again every tick until it succeeded 'repeatCount' times, 0 repeats forever. Fails when the child fails.
+	class BehaviorRepeater : public BehaviorDecorator
+	{
+	public:
+		explicit BehaviorRepeater(IBehavior* pChildBehavior, unsigned int repeatCount = 0)
+			: BehaviorDecorator(pChildBehavior), m_RepeatCount(repeatCount) {}
+
+		virtual BehaviorState Leave(BehaviorDecoratorState& decoratorState, TimingWheel* pTimingWheel, BehaviorState childState) const override;
+
+	private:
+		unsigned int m_RepeatCount = 0;
+	};
+#pragma endregion
+
+	//-----------------------------------------------------------------
+	// BEHAVIOR TREE CONDITION CACHE
+	//-----------------------------------------------------------------
+	//Remembers the result of tagged conditions for the rest of the tick, so conditions that share an expensive
+	//check only do it once. The tree starts a new tick every Update and registers its cache in the blackboard
+	//as "ConditionCache". Actions that change what a condition looks at Invalidate its tag.
+	//Parallel children may use it concurrently, NewTick and new tags are for the updating thread only.
+	class BehaviorConditionCache final
+	{
+	public:
+		BehaviorConditionCache() = default;
+
+		void NewTick() { ++m_CurrentTick; }
+		void Invalidate(unsigned int tag)
+		{
+			if (tag < m_EntryCount)
+				m_pEntries[tag].store(0, std::memory_order_relaxed);
+		}
+		void InvalidateAll() { NewTick(); }
+
+		template<typename TCondition> bool Evaluate(unsigned int tag, TCondition condition)
+		{
+			if (tag >= m_EntryCount)
+			{
+				//Can't grow while other threads read the entries, evaluate without caching instead
+				if (Blackboard::IsDeferringWrites())
+				{
+					m_EvaluationCount.fetch_add(1, std::memory_order_relaxed);
+					return condition();
+				}
+				Grow(tag + 1);
+			}
+
+			//An entry packs the tick it was evaluated in with the result in the lowest bit
+			std::atomic<unsigned int>& entry = m_pEntries[tag];
+			const unsigned int packed = entry.load(std::memory_order_relaxed);
+			if ((packed >> 1) == m_CurrentTick)
+			{
+				m_HitCount.fetch_add(1, std::memory_order_relaxed);
+				return (packed & 1) != 0;
+			}
+
+			m_EvaluationCount.fetch_add(1, std::memory_order_relaxed);
+			const bool value = condition();
+			entry.store((m_CurrentTick << 1) | (value ? 1 : 0), std::memory_order_relaxed);
+			return value;
+		}
+
+		unsigned int GetHitCount() const { return m_HitCount.load(std::memory_order_relaxed); }
+		unsigned int GetEvaluationCount() const { return m_EvaluationCount.load(std::memory_order_relaxed); }
+
+	private:
+		void Grow(unsigned int entryCount)
+		{
+			std::unique_ptr<std::atomic<unsigned int>[]> pEntries(new std::atomic<unsigned int>[entryCount]);
+			for (unsigned int i = 0; i < entryCount; ++i)
+				pEntries[i].store(i < m_EntryCount ? m_pEntries[i].load(std::memory_order_relaxed) : 0, std::memory_order_relaxed);
+			m_pEntries = std::move(pEntries);
+			m_EntryCount = entryCount;
+		}
+
+		std::unique_ptr<std::atomic<unsigned int>[]> m_pEntries = nullptr;
+		unsigned int m_EntryCount = 0;
+		unsigned int m_CurrentTick = 1; //Tick 0 is never current, invalidated entries hold it
+		std::atomic<unsigned int> m_HitCount{ 0 };
+		std::atomic<unsigned int> m_EvaluationCount{ 0 };
+	};
+
+	//-----------------------------------------------------------------
+	// BEHAVIOR TREE RUNNING NODES
+	//-----------------------------------------------------------------
+	//Nodes that keep something running between ticks report every tick they end Running, in the node itself or in an
+	//instance of a compiled tree ('ppInstance', see IBehavior::ExecuteInstance). The tree registers the list in the
+	//blackboard as "RunningNodes" and after every finished tick aborts the nodes that reported the tick before but not
+	//this one: something of higher priority took over.
+	class BehaviorRunningNodes final
+	{
+	public:
+		BehaviorRunningNodes() = default;
+
+		//Parallel children may report concurrently
+		void Report(IBehavior* pBehavior, void** ppInstance = nullptr)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Current.push_back({ pBehavior, ppInstance });
+		}
+
+		void EndTick()
+		{
+			for (const RunningNode& node : m_Previous)
+			{
+				if (std::find(m_Current.begin(), m_Current.end(), node) == m_Current.end())
+					Abort(node);
+			}
+			m_Previous.swap(m_Current);
+			m_Current.clear();
+		}
+
+		//Aborts every node reported since the last finished tick and the one before, e.g. before the instances go away
+		void AbortAll()
+		{
+			for (const RunningNode& node : m_Previous)
+				Abort(node);
+			for (const RunningNode& node : m_Current)
+			{
+				if (std::find(m_Previous.begin(), m_Previous.end(), node) == m_Previous.end())
+					Abort(node);
+			}
+			m_Previous.clear();
+			m_Current.clear();
+		}
+
+	private:
+		struct RunningNode
+		{
+			IBehavior* pBehavior;
+			void** ppInstance;
+
+			bool operator==(const RunningNode& other) const
+			{ return pBehavior == other.pBehavior && ppInstance == other.ppInstance; }
+		};
+
+		static void Abort(const RunningNode& node)
+		{
+			if (node.ppInstance != nullptr)
+				node.pBehavior->AbortInstance(*node.ppInstance);
+			else
+				node.pBehavior->Abort();
+		}
+
+		std::vector<RunningNode> m_Previous = {};
+		std::vector<RunningNode> m_Current = {};
+		std::mutex m_Mutex;
+	};
+
+	//-----------------------------------------------------------------
+	// BEHAVIOR TREE DEFINITION
+	//-----------------------------------------------------------------
+	//The read only part of a tree: its nodes and their compiled form. Any number of BehaviorTrees, e.g. one per agent,
+	//can run the same definition, each keeping the state of the partial sequences, memory composites and observing
+	//conditionals in a block of a few words of its own, and a BehaviorDecoratorState per decorator and an instance per
+	//instanced node (e.g. a BehaviorCoroutine's running action) next to it.
+	class BehaviorTreeDefinition final
+	{
+	public:
+		//Takes ownership of the nodes and compiles them
+		explicit BehaviorTreeDefinition(IBehavior* pRootComposite);
+		~BehaviorTreeDefinition()
+		{
+			delete(m_pRootComposite);
+			m_pRootComposite = nullptr;
+		}
+
+		BehaviorTreeDefinition(const BehaviorTreeDefinition& other) = delete;
+		BehaviorTreeDefinition& operator=(const BehaviorTreeDefinition& other) = delete;
+
+		IBehavior* GetRoot() const
+		{ return m_pRootComposite; }
+		const std::vector<FlatBehavior>& GetBehaviors() const
+		{ return m_CompiledBehaviors; }
+		//Words of state a tree running the compiled nodes needs, and decorator states and instances
+		unsigned int GetStateCount() const
+		{ return m_StateCount; }
+		unsigned int GetDecoratorCount() const
+		{ return m_DecoratorCount; }
+		unsigned int GetInstanceCount() const
+		{ return m_InstanceCount; }
+
+		//Opaque nodes keep their state in the node itself, so a definition with any of them can't be run by
+		//more than one tree. Without them nothing is written to the definition and trees can run it from any thread.
+		//The pointer tree keeps state in every node, it's only ever run by the one tree it was built for.
+		bool IsShareable() const
+		{ return m_IsShareable; }
+
+	private:
+		IBehavior* m_pRootComposite = nullptr;
+		std::vector<FlatBehavior> m_CompiledBehaviors = {};
+		unsigned int m_StateCount = 0;
+		unsigned int m_DecoratorCount = 0;
+		unsigned int m_InstanceCount = 0;
+		bool m_IsShareable = false;
 	};
 
 	//-----------------------------------------------------------------
@@ -131,33 +606,113 @@ namespace Elite
 	class BehaviorTree final : public Elite::IDecisionMaking
 	{
 	public:
-		explicit BehaviorTree(Blackboard* pBlackBoard, IBehavior* pRootComposite)
-			: m_pBlackBoard(pBlackBoard), m_pRootComposite(pRootComposite) {};
+		explicit BehaviorTree(Blackboard* pBlackBoard, IBehavior* pRootComposite);
+		//Runs a definition shared with other trees, compiled from the start
+		explicit BehaviorTree(Blackboard* pBlackBoard, std::shared_ptr<const BehaviorTreeDefinition> pDefinition);
 		~BehaviorTree()
 		{
-			delete(m_pRootComposite);
-			m_pRootComposite = nullptr;
+			AbortInstances();
 			delete(m_pBlackBoard); //Takes ownership of passed blackboard!
 			m_pBlackBoard = nullptr;
 		};
 
-		virtual void Update(float deltaTime) override
-		{
-			if (m_pRootComposite == nullptr)
-			{
-				m_CurrentState = Failure;
-				return;
-			}
-				
-			m_CurrentState = m_pRootComposite->Execute(m_pBlackBoard);
-		}
+		virtual void Update(float deltaTime) override;
 		Blackboard* GetBlackboard() const
 		{ return m_pBlackBoard;	}
+		//Timers of the decorators, compiled or in the blackboard, advanced at the start of every Update
+		TimingWheel& GetTimingWheel()
+		{ return m_TimingWheel; }
+
+		//Runs the tree as the contiguous array its definition compiled, composites and leaves without virtual dispatch.
+		//The pointer tree is kept for the nodes that can't be flattened.
+		bool Compile();
+		bool IsCompiled() const
+		{ return m_IsCompiled; }
+		const std::shared_ptr<const BehaviorTreeDefinition>& GetDefinition() const
+		{ return m_pDefinition; }
+
+		//Compiled trees only. When the last tick ended Running, the next one starts at the node that was running
+		//instead of at the root. On the way down only the selectors' higher-priority children and the conditionals
+		//in front of the path in sequences are checked again, actions the path already passed aren't re-run.
+		void SetResumeRunningPath(bool resume)
+		{
+			m_ResumeRunningPath = resume;
+			m_RunningPath.clear();
+		}
+		//The next Update starts at the node that returned Running instead of at the root
+		bool HasRunningPath() const
+		{ return !m_RunningPath.empty(); }
+
+		//Skips Update while the blackboard wasn't written since the last tick and that tick didn't end Running.
+		//Only correct when every input of the tree goes through the blackboard (or NotifyChanged).
+		void SetSkipUnchangedTicks(bool skip)
+		{ m_SkipUnchangedTicks = skip; }
+
+		//Decides at most once every 'interval' seconds, in between the steering the last decision selected keeps running.
+		//Trees of many agents can be given different offsets so their decisions don't all land on the same frame.
+		void SetDecisionInterval(float interval, float offset = 0.f)
+		{
+			m_DecisionInterval = interval;
+			m_TimeSinceDecision = interval - offset;
+		}
+
+		//Compiled trees only. A decision that takes longer than 'budget' seconds is suspended between two leaves
+		//and continued on the next Update, the last finished decision stays the current state until then.
+		//At least one leaf runs per Update. 0 turns the budget off.
+		void SetTimeBudget(float budget)
+		{ m_TimeBudget = budget; }
+		//Compiled trees only. Suspends after 'leafCount' leaves per Update instead of after a time, so a decision takes
+		//the same Updates on every run, as tests and replays need. Either budget running out suspends. 0 turns it off.
+		void SetLeafBudget(unsigned int leafCount)
+		{ m_LeafBudget = leafCount; }
+		bool IsSuspended() const
+		{ return m_IsSuspended; }
+
+#if ELITE_BT_PROFILER
+		BehaviorProfiler& GetProfiler()
+		{ return m_Profiler; }
+#endif
 
 	private:
+		BehaviorState RunCompiled(unsigned int index, size_t stackBase, bool isAscending, BehaviorState state);
+		BehaviorState ResumeCompiled();
+		unsigned int GetCompiledChild(unsigned int parentIndex, unsigned int childIndex) const;
+		void RecordRunningPath(unsigned int index);
+		bool ShouldSuspend(unsigned int index, size_t stackBase);
+		void AbortInstances();
+#if ELITE_BT_PROFILER
+		void InitializeProfiler();
+#endif
+
 		BehaviorState m_CurrentState = Failure;
 		Blackboard* m_pBlackBoard = nullptr;
-		IBehavior* m_pRootComposite = nullptr;
+		std::shared_ptr<const BehaviorTreeDefinition> m_pDefinition = nullptr;
+		BehaviorConditionCache m_ConditionCache = {};
+		TimingWheel m_TimingWheel{};
+		BehaviorRunningNodes m_RunningNodes = {};
+		unsigned int m_LastChangeCount = 0;
+		bool m_HasRun = false;
+		bool m_SkipUnchangedTicks = false;
+
+		float m_DecisionInterval = 0.f;
+		float m_TimeSinceDecision = 0.f;
+		float m_TimeBudget = 0.f;
+		unsigned int m_LeafBudget = 0;
+		std::chrono::steady_clock::time_point m_SliceDeadline = {};
+		unsigned int m_SliceLeafCount = 0;
+		unsigned int m_SuspendedIndex = 0;
+		bool m_IsSuspended = false;
+#if ELITE_BT_PROFILER
+		BehaviorProfiler m_Profiler = {};
+#endif
+
+		bool m_IsCompiled = false;
+		std::vector<unsigned int> m_CompiledNodeStates = {}; //The nodes' state, at their stateIndex
+		std::unique_ptr<BehaviorDecoratorState[]> m_pDecoratorStates = nullptr; //At the decorators' stateIndex, timers on m_TimingWheel
+		std::vector<void*> m_Instances = {}; //At the instanced nodes' stateIndex
+		std::vector<unsigned int> m_CompiledStack = {};
+		std::vector<unsigned int> m_RunningPath = {}; //Root to the node that returned Running last tick
+		bool m_ResumeRunningPath = false;
 	};
 }
 #endif
\ No newline at end of file
@@ -9,51 +9,340 @@
 
 //Includes
 #include <unordered_map>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <typeinfo>
+#include <type_traits>
 
 namespace Elite
 {
 	//-----------------------------------------------------------------
 	// BLACKBOARD TYPES (BASE)
 	//-----------------------------------------------------------------
-	class IBlackBoardField
+	//Operations the arena needs to copy, move and destroy a value it only knows as bytes.
+	//There is exactly one per type, so its address doubles as the type tag of a slot.
+	struct BlackboardTypeInfo final
+	{
+		size_t size;
+		size_t alignment;
+		void(*moveConstruct)(void* pDestination, void* pSource);
+		void(*copyConstruct)(void* pDestination, const void* pSource);
+		void(*copyAssign)(void* pDestination, const void* pSource);
+		void(*destroy)(void* pData);
+		const char* name;
+	};
+
+	template<typename T>
+	const BlackboardTypeInfo* GetBlackboardTypeInfo()
+	{
+		static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types can't be stored in the Blackboard");
+		static const BlackboardTypeInfo typeInfo =
+		{
+			sizeof(T),
+			alignof(T),
+			[](void* pDestination, void* pSource) { new (pDestination) T(std::move(*static_cast<T*>(pSource))); },
+			[](void* pDestination, const void* pSource) { new (pDestination) T(*static_cast<const T*>(pSource)); },
+			[](void* pDestination, const void* pSource) { *static_cast<T*>(pDestination) = *static_cast<const T*>(pSource); },
+			[](void* pData) { static_cast<T*>(pData)->~T(); },
+			typeid(T).name()
+		};
+		return &typeInfo;
+	}
+
+	//-----------------------------------------------------------------
+	// BLACKBOARD STORAGE
+	//-----------------------------------------------------------------
+	//All fields live inline in one contiguous buffer, a slot only knows where its value starts and its type.
+	//The buffer only grows while data is being added, so pointers into it stay valid once the blackboard is built.
+	class BlackboardArena final
 	{
 	public:
-		IBlackBoardField() = default;
-		virtual ~IBlackBoardField() = default;
+		static const unsigned int InvalidOffset = 0xFFFFFFFF;
+		struct Slot
+		{
+			const BlackboardTypeInfo* pType;
+			unsigned int offset;
+		};
+
+		BlackboardArena() = default;
+		~BlackboardArena() { Clear(); }
+
+		BlackboardArena(const BlackboardArena& other) = delete;
+		BlackboardArena& operator=(const BlackboardArena& other) = delete;
+		BlackboardArena(BlackboardArena&& other) = delete;
+		BlackboardArena& operator=(BlackboardArena&& other) = delete;
+
+		//Adds a slot without storage, Construct gives it a value later
+		unsigned int AddSlot(const BlackboardTypeInfo* pType)
+		{
+			m_Slots.push_back({ pType, InvalidOffset });
+			return static_cast<unsigned int>(m_Slots.size() - 1);
+		}
+
+		template<typename T> void Construct(unsigned int slotIndex, const T& data)
+		{
+			assert(m_Slots[slotIndex].pType == GetBlackboardTypeInfo<T>() && m_Slots[slotIndex].offset == InvalidOffset);
+
+			const size_t offset = Allocate(sizeof(T), alignof(T));
+			new (GetBytes() + offset) T(data);
+			m_Slots[slotIndex].offset = static_cast<unsigned int>(offset);
+		}
+
+		//Same as Construct, with the value of a slot of the same type in another arena
+		void ConstructFrom(unsigned int slotIndex, const BlackboardArena& source, unsigned int sourceIndex)
+		{
+			const BlackboardTypeInfo* pType = m_Slots[slotIndex].pType;
+			assert(pType == source.m_Slots[sourceIndex].pType && m_Slots[slotIndex].offset == InvalidOffset && source.HasStorage(sourceIndex));
+
+			const size_t offset = Allocate(pType->size, pType->alignment);
+			pType->copyConstruct(GetBytes() + offset, source.GetBytes() + source.m_Slots[sourceIndex].offset);
+			m_Slots[slotIndex].offset = static_cast<unsigned int>(offset);
+		}
+
+		//Assigns the value of a slot of the same type in another arena
+		void AssignFrom(unsigned int slotIndex, const BlackboardArena& source, unsigned int sourceIndex)
+		{
+			const BlackboardTypeInfo* pType = m_Slots[slotIndex].pType;
+			assert(pType == source.m_Slots[sourceIndex].pType && HasStorage(slotIndex) && source.HasStorage(sourceIndex));
+
+			pType->copyAssign(GetBytes() + m_Slots[slotIndex].offset, source.GetBytes() + source.m_Slots[sourceIndex].offset);
+		}
+
+		const Slot& GetSlot(unsigned int slotIndex) const { return m_Slots[slotIndex]; }
+		unsigned int GetSlotCount() const { return static_cast<unsigned int>(m_Slots.size()); }
+		bool HasStorage(unsigned int slotIndex) const { return m_Slots[slotIndex].offset != InvalidOffset; }
+
+		template<typename T> T* Get(unsigned int slotIndex)
+		{
+			assert(m_Slots[slotIndex].pType == GetBlackboardTypeInfo<T>() && HasStorage(slotIndex));
+			return reinterpret_cast<T*>(GetBytes() + m_Slots[slotIndex].offset);
+		}
+		template<typename T> const T* Get(unsigned int slotIndex) const
+		{
+			assert(m_Slots[slotIndex].pType == GetBlackboardTypeInfo<T>() && HasStorage(slotIndex));
+			return reinterpret_cast<const T*>(GetBytes() + m_Slots[slotIndex].offset);
+		}
+
+		//Makes this arena an exact copy of the other one. When the layout did not change since the
+		//last copy the values are assigned in place, so e.g. vectors keep their capacity.
+		void CopyFrom(const BlackboardArena& other)
+		{
+			if (!HasSameLayout(other))
+			{
+				Clear();
+				m_Slots = other.m_Slots;
+				m_Buffer.resize(other.m_Buffer.size());
+				m_UsedBytes = other.m_UsedBytes;
+				for (const Slot& slot : m_Slots)
+				{
+					if (slot.offset != InvalidOffset)
+						slot.pType->copyConstruct(GetBytes() + slot.offset, other.GetBytes() + slot.offset);
+				}
+				return;
+			}
+
+			for (const Slot& slot : m_Slots)
+			{
+				if (slot.offset != InvalidOffset)
+					slot.pType->copyAssign(GetBytes() + slot.offset, other.GetBytes() + slot.offset);
+			}
+		}
+
+		void Clear()
+		{
+			for (Slot& slot : m_Slots)
+			{
+				if (slot.offset != InvalidOffset)
+					slot.pType->destroy(GetBytes() + slot.offset);
+			}
+			m_Slots.clear();
+			m_Buffer.clear();
+			m_UsedBytes = 0;
+		}
+
+	private:
+		bool HasSameLayout(const BlackboardArena& other) const
+		{
+			if (m_Slots.size() != other.m_Slots.size() || m_Buffer.size() < other.m_Buffer.size())
+				return false;
+			for (size_t i = 0; i < m_Slots.size(); ++i)
+			{
+				if (m_Slots[i].pType != other.m_Slots[i].pType || m_Slots[i].offset != other.m_Slots[i].offset)
+					return false;
+			}
+			return true;
+		}
+
+		size_t Allocate(size_t size, size_t alignment)
+		{
+			const size_t offset = (m_UsedBytes + alignment - 1) & ~(alignment - 1);
+			Reserve(offset + size);
+			m_UsedBytes = offset + size;
+			return offset;
+		}
+
+		unsigned char* GetBytes() { return reinterpret_cast<unsigned char*>(m_Buffer.data()); }
+		const unsigned char* GetBytes() const { return reinterpret_cast<const unsigned char*>(m_Buffer.data()); }
+
+		//Grows the buffer, moving every stored value to its new location
+		void Reserve(size_t bytes)
+		{
+			const size_t capacity = m_Buffer.size() * sizeof(std::max_align_t);
+			if (bytes <= capacity)
+				return;
+
+			const size_t newBlocks = ((std::max)(bytes, capacity * 2) + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+			std::vector<std::max_align_t> newBuffer(newBlocks);
+			unsigned char* pNewBytes = reinterpret_cast<unsigned char*>(newBuffer.data());
+			for (Slot& slot : m_Slots)
+			{
+				if (slot.offset == InvalidOffset)
+					continue;
+				slot.pType->moveConstruct(pNewBytes + slot.offset, GetBytes() + slot.offset);
+				slot.pType->destroy(GetBytes() + slot.offset);
+			}
+			m_Buffer.swap(newBuffer);
+		}
+
+		std::vector<Slot> m_Slots;
+		std::vector<std::max_align_t> m_Buffer;
+		size_t m_UsedBytes = 0;
 	};
 
-	//BlackboardField does not take ownership of pointers whatsoever!
+	//-----------------------------------------------------------------
+	// BLACKBOARD KEYS
+	//-----------------------------------------------------------------
+	//Typed handle to a blackboard slot. Resolve it once by name (Blackboard::GetKey) and use it
+	//on the hot path to index the slot directly, without building or hashing a string.
 	template<typename T>
-	class BlackboardField : public IBlackBoardField
+	class BlackboardKey final
 	{
 	public:
-		explicit BlackboardField(T data) : m_Data(data)
-		{}
-		T GetData() { return m_Data; };
-		void SetData(T data) { m_Data = data; }
+		BlackboardKey() = default;
+
+		bool IsValid() const { return m_Index != InvalidIndex; }
+		unsigned int GetIndex() const { return m_Index; }
 
 	private:
-		T m_Data;
+		friend class Blackboard;
+		friend class BlackboardSnapshot;
+		explicit BlackboardKey(unsigned int index) : m_Index(index) {}
+
+		static const unsigned int InvalidIndex = 0xFFFFFFFF;
+		unsigned int m_Index = InvalidIndex;
 	};
 
 	//-----------------------------------------------------------------
-	// BLACKBOARD (BASE)
+	// BLACKBOARD SNAPSHOT
 	//-----------------------------------------------------------------
-	class Blackboard final
+	//Read-only copy of a blackboard as it was published at a tick boundary (see Blackboard::Publish).
+	//Keys resolved on the blackboard index the snapshot as well. Nothing in it changes while it is held,
+	//so any number of threads can read it without locking.
+	//Pointer slots (the interface, the closest entity, the condition cache, ...) can't be read through a
+	//snapshot: only the pointer would be copied, the data behind it keeps changing on the writing thread.
+	class BlackboardSnapshot final
 	{
 	public:
-		Blackboard() = default;
-		~Blackboard()
+		BlackboardSnapshot() = default;
+		~BlackboardSnapshot() = default;
+
+		BlackboardSnapshot(const BlackboardSnapshot& other) = delete;
+		BlackboardSnapshot& operator=(const BlackboardSnapshot& other) = delete;
+		BlackboardSnapshot(BlackboardSnapshot&& other) = delete;
+		BlackboardSnapshot& operator=(BlackboardSnapshot&& other) = delete;
+
+		unsigned int GetVersion() const { return m_Version; }
+
+		template<typename T> bool TryGetData(const BlackboardKey<T>& key, T& data) const
+		{
+			const T* pData = TryGetDataPtr(key);
+			if (pData == nullptr)
+				return false;
+
+			data = *pData;
+			return true;
+		}
+
+		template<typename T> const T* TryGetDataPtr(const BlackboardKey<T>& key) const
+		{
+			static_assert(!std::is_pointer<T>::value, "Pointer slots point into live data and can't be read through a snapshot");
+			if (!key.IsValid() || key.m_Index >= m_Arena.GetSlotCount() || !m_Arena.HasStorage(key.m_Index))
+				return nullptr;
+			return m_Arena.Get<T>(key.m_Index);
+		}
+
+	private:
+		friend class Blackboard;
+
+		BlackboardArena m_Arena;
+		unsigned int m_Version = 0;
+	};
+
+	//-----------------------------------------------------------------
+	// BLACKBOARD WRITE LOG
+	//-----------------------------------------------------------------
+	//Writes held back while the log defers them on a thread (see Blackboard::DeferWritesScope),
+	//in the order they were made, until Blackboard::ApplyWriteLog replays them.
+	class BlackboardWriteLog final
+	{
+	public:
+		BlackboardWriteLog() = default;
+
+		bool IsEmpty() const { return m_TargetSlots.empty(); }
+		void Clear()
+		{
+			m_Arena.Clear();
+			m_TargetSlots.clear();
+		}
+
+	private:
+		friend class Blackboard;
+
+		//Latest write to the slot still in the log, nullptr when there is none
+		template<typename T> const T* Find(unsigned int targetSlot) const
 		{
-			for (auto el : m_BlackboardData)
+			for (size_t i = m_TargetSlots.size(); i > 0; --i)
 			{
-				delete(el.second);
-				el.second = nullptr;
+				if (m_TargetSlots[i - 1] == targetSlot)
+					return m_Arena.Get<T>(static_cast<unsigned int>(i - 1));
 			}
+			return nullptr;
+		}
 
-			m_BlackboardData.clear();
+		template<typename T> void Add(unsigned int targetSlot, const T& data)
+		{
+			const unsigned int entry = m_Arena.AddSlot(GetBlackboardTypeInfo<T>());
+			m_Arena.Construct(entry, data);
+			m_TargetSlots.push_back(targetSlot);
 		}
 
+		void AddFrom(unsigned int targetSlot, const BlackboardWriteLog& other, unsigned int otherEntry)
+		{
+			const unsigned int entry = m_Arena.AddSlot(other.m_Arena.GetSlot(otherEntry).pType);
+			m_Arena.ConstructFrom(entry, other.m_Arena, otherEntry);
+			m_TargetSlots.push_back(targetSlot);
+		}
+
+		BlackboardArena m_Arena;
+		std::vector<unsigned int> m_TargetSlots;
+	};
+
+	//-----------------------------------------------------------------
+	// BLACKBOARD (BASE)
+	//-----------------------------------------------------------------
+	//The blackboard does not take ownership of pointers whatsoever!
+	class Blackboard final
+	{
+	public:
+		Blackboard() = default;
+		~Blackboard() = default;
+
 		Blackboard(const Blackboard& other) = delete;
 		Blackboard& operator=(const Blackboard& other) = delete;
 		Blackboard(Blackboard&& other) = delete;
@@ -62,48 +351,368 @@ namespace Elite
 		//Add data to the blackboard
 		template<typename T> bool AddData(const std::string& name, T data)
 		{
-			auto it = m_BlackboardData.find(name);
-			if (it == m_BlackboardData.end())
+			const BlackboardTypeInfo* pType = GetBlackboardTypeInfo<T>();
+			auto it = m_SlotIndices.find(name);
+			if (it == m_SlotIndices.end())
 			{
-				m_BlackboardData[name] = new BlackboardField<T>(data);
+				const unsigned int index = AddSlot(name, pType);
+				m_Arena.Construct(index, data);
+				MarkChanged(index);
 				return true;
 			}
+			//Slot was reserved by GetKey before the data existed
+			if (!m_Arena.HasStorage(it->second))
+			{
+				if (m_Arena.GetSlot(it->second).pType == pType)
+				{
+					m_Arena.Construct(it->second, data);
+					MarkChanged(it->second);
+					return true;
+				}
+				printf("WARNING: Data '%s' is reserved in Blackboard with type '%s' \n", name.c_str(), m_Arena.GetSlot(it->second).pType->name);
+				return false;
+			}
 			printf("WARNING: Data '%s' of type '%s' already in Blackboard \n", name.c_str(), typeid(T).name());
 			return false;
 		}
 
-		//Change the data of the blackboard
-		template<typename T> bool ChangeData(const std::string& name, T data)
+		//Resolve a typed key for the slot with this name, reserving the slot if the data is not added yet.
+		//Meant to be called once while building, the returned key stays valid for the lifetime of the blackboard.
+		template<typename T> BlackboardKey<T> GetKey(const std::string& name)
 		{
-			auto it = m_BlackboardData.find(name);
-			if (it != m_BlackboardData.end())
+			const BlackboardTypeInfo* pType = GetBlackboardTypeInfo<T>();
+			auto it = m_SlotIndices.find(name);
+			if (it == m_SlotIndices.end())
+				return BlackboardKey<T>(AddSlot(name, pType));
+
+			if (m_Arena.GetSlot(it->second).pType != pType)
 			{
-				BlackboardField<T>* p = dynamic_cast<BlackboardField<T>*>(m_BlackboardData[name]);
-				if (p)
-				{
-					p->SetData(data);
-					return true;
-				}
+				printf("WARNING: Data '%s' in Blackboard is not of type '%s' \n", name.c_str(), typeid(T).name());
+				return BlackboardKey<T>();
 			}
+			return BlackboardKey<T>(it->second);
+		}
+
+		//Change the data of the blackboard
+		template<typename T> bool ChangeData(const BlackboardKey<T>& key, T data)
+		{
+			if (TryChangeData(key, data))
+				return true;
+			if (key.IsValid())
+				printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", m_SlotNames[key.m_Index].c_str(), typeid(T).name());
+			return false;
+		}
+
+		template<typename T> bool ChangeData(const std::string& name, T data)
+		{
+			if (TryChangeData(name, data))
+				return true;
 			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", name.c_str(), typeid(T).name());
 			return false;
 		}
 
 		//Get the data from the blackboard
-		template<typename T> bool GetData(const std::string& name, T& data)
+		template<typename T> bool GetData(const BlackboardKey<T>& key, T& data) const
+		{
+			if (TryGetData(key, data))
+				return true;
+			if (key.IsValid())
+				printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", m_SlotNames[key.m_Index].c_str(), typeid(T).name());
+			return false;
+		}
+
+		template<typename T> bool GetData(const std::string& name, T& data) const
 		{
-			BlackboardField<T>* p = dynamic_cast<BlackboardField<T>*>(m_BlackboardData[name]);
-			if (p != nullptr)
+			if (TryGetData(name, data))
+				return true;
+			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", name.c_str(), typeid(T).name());
+			return false;
+		}
+
+		//Read the data in place, without copying it out. Returns nullptr when the data is not there.
+		//The pointer stays valid until data is added to the blackboard again.
+		template<typename T> const T* GetDataPtr(const BlackboardKey<T>& key) const
+		{
+			const T* pData = TryGetDataPtr(key);
+			if (pData == nullptr && key.IsValid())
+				printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", m_SlotNames[key.m_Index].c_str(), typeid(T).name());
+			return pData;
+		}
+
+		//Silent variants for use inside a tick: they never insert and never log,
+		//they only count the hit or miss on the slot (see DumpAccessCounters).
+		template<typename T> bool TryChangeData(const BlackboardKey<T>& key, const T& data)
+		{
+			if (!CountAccess(key))
+				return false;
+
+			if (BlackboardWriteLog* pLog = DeferredWriteLog())
 			{
-				data = p->GetData();
+				pLog->Add(key.m_Index, data);
 				return true;
 			}
-			printf("WARNING: Data '%s' of type '%s' not found in Blackboard \n", name.c_str(), typeid(T).name());
+			*m_Arena.Get<T>(key.m_Index) = data;
+			MarkChanged(key.m_Index);
+			return true;
+		}
+
+		template<typename T> bool TryChangeData(const std::string& name, const T& data)
+		{
+			const unsigned int index = FindSlot<T>(name);
+			if (index == BlackboardKey<T>::InvalidIndex)
+				return false;
+
+			if (BlackboardWriteLog* pLog = DeferredWriteLog())
+			{
+				pLog->Add(index, data);
+				return true;
+			}
+			*m_Arena.Get<T>(index) = data;
+			MarkChanged(index);
+			return true;
+		}
+
+		template<typename T> bool TryGetData(const BlackboardKey<T>& key, T& data) const
+		{
+			const T* pData = TryGetDataPtr(key);
+			if (pData == nullptr)
+				return false;
+
+			data = *pData;
+			return true;
+		}
+
+		template<typename T> bool TryGetData(const std::string& name, T& data) const
+		{
+			const unsigned int index = FindSlot<T>(name);
+			if (index == BlackboardKey<T>::InvalidIndex)
+				return false;
+
+			const T* pDeferred = FindDeferredWrite<T>(index);
+			data = pDeferred != nullptr ? *pDeferred : *m_Arena.Get<T>(index);
+			return true;
+		}
+
+		template<typename T> const T* TryGetDataPtr(const BlackboardKey<T>& key) const
+		{
+			if (!CountAccess(key))
+				return nullptr;
+			if (const T* pDeferred = FindDeferredWrite<T>(key.m_Index))
+				return pDeferred;
+			return m_Arena.Get<T>(key.m_Index);
+		}
+
+		//While a scope is open, the calling thread's writes go to its log instead of the blackboard and its
+		//accesses aren't counted, so any number of threads can run behaviors against the blackboard at once
+		//as long as nothing else writes it. ApplyWriteLog makes the writes afterwards, on one thread.
+		//Reads on that thread see its own pending writes first (a pointer into the log stays valid until the
+		//thread writes again), never those of other threads or of the scope it is nested in.
+		class DeferWritesScope final
+		{
+		public:
+			explicit DeferWritesScope(BlackboardWriteLog* pLog)
+				: m_pPrevious(DeferredWriteLog())
+			{ DeferredWriteLog() = pLog; }
+			~DeferWritesScope() { DeferredWriteLog() = m_pPrevious; }
+
+			DeferWritesScope(const DeferWritesScope& other) = delete;
+			DeferWritesScope& operator=(const DeferWritesScope& other) = delete;
+
+		private:
+			BlackboardWriteLog* m_pPrevious;
+		};
+
+		static bool IsDeferringWrites() { return DeferredWriteLog() != nullptr; }
+
+		//Replays the log in order. Inside another deferring scope the writes move on to that scope's log.
+		void ApplyWriteLog(const BlackboardWriteLog& log)
+		{
+			BlackboardWriteLog* pDeferredLog = DeferredWriteLog();
+			for (size_t i = 0; i < log.m_TargetSlots.size(); ++i)
+			{
+				const unsigned int target = log.m_TargetSlots[i];
+				if (pDeferredLog != nullptr)
+					pDeferredLog->AddFrom(target, log, static_cast<unsigned int>(i));
+				else
+				{
+					m_Arena.AssignFrom(target, log.m_Arena, static_cast<unsigned int>(i));
+					MarkChanged(target);
+				}
+			}
+		}
+
+		//Every write stamps its slot with the next change count. Data that changes without going through
+		//the blackboard (e.g. behind a stored pointer) has to be reported with NotifyChanged, which is not
+		//deferred and so can't be called while writes are.
+		template<typename T> void NotifyChanged(const BlackboardKey<T>& key)
+		{
+			if (key.IsValid())
+				MarkChanged(key.m_Index);
+		}
+
+		template<typename T> unsigned int GetChangeStamp(const BlackboardKey<T>& key) const
+		{ return key.IsValid() ? m_ChangeStamps[key.m_Index] : 0; }
+		unsigned int GetChangeCount() const { return m_ChangeCount; }
+
+		//True when one of the slots was written after the change count was 'changeCount'
+		bool HasChangedSince(const std::vector<unsigned int>& slotIndices, unsigned int changeCount) const
+		{
+			for (unsigned int index : slotIndices)
+			{
+				if (index >= m_ChangeStamps.size() || m_ChangeStamps[index] > changeCount)
+					return true;
+			}
 			return false;
 		}
 
+		//Copies the current data into a snapshot and makes it the one AcquireSnapshot hands out, in one atomic swap.
+		//Call it at the tick boundary, from the thread writing the blackboard, and only when something reads
+		//snapshots: the copy isn't free. Snapshots no reader holds anymore are reused, so in steady state
+		//publishing doesn't allocate.
+		void Publish()
+		{
+			std::shared_ptr<BlackboardSnapshot> pSnapshot = nullptr;
+			for (const auto& pPooled : m_SnapshotPool)
+			{
+				//Only the pool owns it: it's neither published nor held by a reader, and can't become so
+				if (pPooled.use_count() == 1)
+				{
+					std::atomic_thread_fence(std::memory_order_acquire);
+					pSnapshot = pPooled;
+					break;
+				}
+			}
+			if (pSnapshot == nullptr)
+			{
+				pSnapshot = std::make_shared<BlackboardSnapshot>();
+				m_SnapshotPool.push_back(pSnapshot);
+			}
+
+			pSnapshot->m_Arena.CopyFrom(m_Arena);
+			pSnapshot->m_Version = ++m_PublishedVersion;
+			m_pPublishedSnapshot.store(std::shared_ptr<const BlackboardSnapshot>(pSnapshot));
+		}
+
+		//Latest published snapshot, safe to call from any thread. Never blocks on the writer.
+		//Returns nullptr before the first Publish.
+		std::shared_ptr<const BlackboardSnapshot> AcquireSnapshot() const
+		{
+			return m_pPublishedSnapshot.load();
+		}
+
+		unsigned int GetPublishedVersion() const { return m_PublishedVersion; }
+
+		//Per key hits and misses of every access so far. Lookups of names that are not in the
+		//blackboard, and keys that failed to resolve, are counted together on a separate line.
+		void DumpAccessCounters(std::ostream& os) const
+		{
+			os << "Blackboard access counters (hits / misses)\n";
+			for (size_t i = 0; i < m_AccessCounters.size(); ++i)
+			{
+				os << "  " << m_SlotNames[i] << ": " << m_AccessCounters[i].hits << " / " << m_AccessCounters[i].misses;
+				if (!m_Arena.HasStorage(static_cast<unsigned int>(i)))
+					os << " (never added)";
+				os << '\n';
+			}
+			if (m_UnknownMisses > 0)
+				os << "  <unknown or unresolved>: 0 / " << m_UnknownMisses << '\n';
+		}
+
+		void ResetAccessCounters()
+		{
+			for (AccessCounter& counter : m_AccessCounters)
+				counter = {};
+			m_UnknownMisses = 0;
+		}
+
 	private:
-		std::unordered_map<std::string, IBlackBoardField*> m_BlackboardData;
+		struct AccessCounter
+		{
+			unsigned int hits = 0;
+			unsigned int misses = 0;
+		};
+
+		unsigned int AddSlot(const std::string& name, const BlackboardTypeInfo* pType)
+		{
+			const unsigned int index = m_Arena.AddSlot(pType);
+			m_SlotIndices[name] = index;
+			m_SlotNames.push_back(name);
+			m_AccessCounters.push_back({});
+			m_ChangeStamps.push_back(0);
+			return index;
+		}
+
+		void MarkChanged(unsigned int index)
+		{ m_ChangeStamps[index] = ++m_ChangeCount; }
+
+		static BlackboardWriteLog*& DeferredWriteLog()
+		{
+			static thread_local BlackboardWriteLog* pLog = nullptr;
+			return pLog;
+		}
+
+		template<typename T> static const T* FindDeferredWrite(unsigned int index)
+		{
+			const BlackboardWriteLog* pLog = DeferredWriteLog();
+			return pLog != nullptr && !pLog->IsEmpty() ? pLog->Find<T>(index) : nullptr;
+		}
+
+		//A resolved key can only miss when its data was never added, its type was checked by GetKey
+		template<typename T> bool CountAccess(const BlackboardKey<T>& key) const
+		{
+			const bool isCounted = !IsDeferringWrites();
+			if (!key.IsValid())
+			{
+				if (isCounted)
+					++m_UnknownMisses;
+				return false;
+			}
+			if (!m_Arena.HasStorage(key.m_Index))
+			{
+				if (isCounted)
+					++m_AccessCounters[key.m_Index].misses;
+				return false;
+			}
+			if (isCounted)
+				++m_AccessCounters[key.m_Index].hits;
+			return true;
+		}
+
+		//Slow path lookup by name, checks the type as well
+		template<typename T> unsigned int FindSlot(const std::string& name) const
+		{
+			const bool isCounted = !IsDeferringWrites();
+			auto it = m_SlotIndices.find(name);
+			if (it == m_SlotIndices.end())
+			{
+				if (isCounted)
+					++m_UnknownMisses;
+				return BlackboardKey<T>::InvalidIndex;
+			}
+			if (!m_Arena.HasStorage(it->second) || m_Arena.GetSlot(it->second).pType != GetBlackboardTypeInfo<T>())
+			{
+				if (isCounted)
+					++m_AccessCounters[it->second].misses;
+				return BlackboardKey<T>::InvalidIndex;
+			}
+			if (isCounted)
+				++m_AccessCounters[it->second].hits;
+			return it->second;
+		}
+
+		BlackboardArena m_Arena;
+		std::unordered_map<std::string, unsigned int> m_SlotIndices;
+		std::vector<std::string> m_SlotNames;
+
+		std::vector<std::shared_ptr<BlackboardSnapshot>> m_SnapshotPool;
+		std::atomic<std::shared_ptr<const BlackboardSnapshot>> m_pPublishedSnapshot{ nullptr };
+		unsigned int m_PublishedVersion = 0;
+
+		std::vector<unsigned int> m_ChangeStamps; //Per slot, the change count of its last write
+		unsigned int m_ChangeCount = 0;
+
+		mutable std::vector<AccessCounter> m_AccessCounters;
+		mutable unsigned int m_UnknownMisses = 0;
 	};
 }
 #endif
\ No newline at end of file
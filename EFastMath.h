@@ -0,0 +1,201 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EFastMath.h: Polynomial approximations of sin, cos and atan2 for the steering behaviors,
+// one angle at a time and in batches of four with SSE. Within a few turns of 0 sin and cos
+// are off by at most 2.2e-7, and atan2 by at most 2.0e-6 radians everywhere, far below what
+// steering can tell apart. Further from 0 sin and cos lose the precision of the angle itself:
+// about 3e-2 around 1e6 radians (see FastMath::ReduceToHalfTurn for the range).
+// Tests/FastMathTest.cpp checks these bounds. Wander and Face use them when ELITE_FAST_TRIG is 1.
+/*=============================================================================*/
+#ifndef ELITE_FAST_MATH
+#define ELITE_FAST_MATH
+
+//--- Includes ---
+#include <cmath>
+#include <cstddef>
+
+#ifndef ELITE_FAST_TRIG
+#define ELITE_FAST_TRIG 0
+#endif
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ELITE_FAST_MATH_SSE 1
+#include <emmintrin.h>
+#else
+#define ELITE_FAST_MATH_SSE 0
+#endif
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// FAST TRIGONOMETRY
+	//-----------------------------------------------------------------
+	namespace FastMath
+	{
+		const float Pi = 3.14159265f;
+		const float HalfPi = 1.57079633f;
+		const float InvTwoPi = 0.159154943f;
+		//2 pi split in a part that multiplies exactly and the rest, so reducing an angle keeps its precision
+		const float TwoPiHigh = 6.28125f;
+		const float TwoPiLow = 1.93530718e-3f;
+
+		//sin on [-pi/2, pi/2], odd Taylor polynomial up to x^11
+		inline float SinPolynomial(float x)
+		{
+			const float x2 = x * x;
+			return x * (1.f + x2 * (-1.66666667e-1f + x2 * (8.33333333e-3f + x2 * (-1.98412698e-4f + x2 * (2.75573192e-6f + x2 * -2.50521084e-8f)))));
+		}
+
+		//atan on [0, 1]
+		inline float AtanPolynomial(float z)
+		{
+			const float z2 = z * z;
+			return z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+		}
+
+		//From 2^23 turns on (about 5.3e7 radians) floats are further apart than a turn
+		const float WholeTurns = 8388608.f;
+
+		//The same angle in [-pi, pi]. Its precision drops with the number of turns (see the top of the file), angles
+		//beyond WholeTurns turns can't be told apart within a turn anymore and reduce to 0. Infinity and NaN give NaN.
+		inline float ReduceToHalfTurn(float angle)
+		{
+			const float scaled = angle * InvTwoPi;
+			if (!(std::fabs(scaled) < WholeTurns))
+				return angle * 0.f;
+			const float turns = static_cast<float>(static_cast<int>(scaled + (scaled < 0.f ? -0.5f : 0.5f)));
+			return (angle - turns * TwoPiHigh) - turns * TwoPiLow;
+		}
+
+		//An angle in [-pi, pi] mirrored into [-pi/2, pi/2], keeping its sine
+		inline float MirrorForSin(float x)
+		{ return x > HalfPi ? Pi - x : (x < -HalfPi ? -Pi - x : x); }
+	}
+
+	inline float FastSin(float angle)
+	{ return FastMath::SinPolynomial(FastMath::MirrorForSin(FastMath::ReduceToHalfTurn(angle))); }
+	inline float FastCos(float angle)
+	{ return FastMath::SinPolynomial(FastMath::HalfPi - std::fabs(FastMath::ReduceToHalfTurn(angle))); }
+	inline void FastSinCos(float angle, float& sin, float& cos)
+	{
+		const float x = FastMath::ReduceToHalfTurn(angle);
+		sin = FastMath::SinPolynomial(FastMath::MirrorForSin(x));
+		cos = FastMath::SinPolynomial(FastMath::HalfPi - std::fabs(x));
+	}
+
+	inline float FastAtan2(float y, float x)
+	{
+		const float absX = std::fabs(x);
+		const float absY = std::fabs(y);
+		const float maxXY = absX > absY ? absX : absY;
+
+		//atan of the smaller over the larger, then mirrored into the right octant. A negative zero x counts as left of
+		//the origin, as for std::atan2: atan2(+-0, -0) is +-pi.
+		const float minXY = absX > absY ? absY : absX;
+		float angle = maxXY > 0.f ? FastMath::AtanPolynomial(minXY / maxXY) : 0.f;
+		if (absY > absX)
+			angle = FastMath::HalfPi - angle;
+		if (std::signbit(x))
+			angle = FastMath::Pi - angle;
+		return std::signbit(y) ? -angle : angle;
+	}
+
+	//-----------------------------------------------------------------
+	// FAST TRIGONOMETRY (BATCH)
+	//-----------------------------------------------------------------
+	//Sine and cosine of 'count' angles, four at a time with SSE
+	inline void FastSinCos(const float* pAngles, float* pSin, float* pCos, size_t count)
+	{
+		size_t i = 0;
+#if ELITE_FAST_MATH_SSE
+		const __m128 invTwoPi = _mm_set1_ps(FastMath::InvTwoPi);
+		const __m128 twoPiHigh = _mm_set1_ps(FastMath::TwoPiHigh);
+		const __m128 twoPiLow = _mm_set1_ps(FastMath::TwoPiLow);
+		const __m128 halfPi = _mm_set1_ps(FastMath::HalfPi);
+		const __m128 pi = _mm_set1_ps(FastMath::Pi);
+		const __m128 signBit = _mm_set1_ps(-0.f);
+		const __m128 wholeTurns = _mm_set1_ps(FastMath::WholeTurns);
+
+		const auto reduce = [&](__m128 angle)
+		{
+			//Rounding to the nearest turn is the default conversion mode. Beyond WholeTurns turns, or for infinity and NaN,
+			//angle * 0 as ReduceToHalfTurn does.
+			const __m128 scaled = _mm_mul_ps(angle, invTwoPi);
+			const __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(scaled));
+			const __m128 reduced = _mm_sub_ps(_mm_sub_ps(angle, _mm_mul_ps(turns, twoPiHigh)), _mm_mul_ps(turns, twoPiLow));
+			const __m128 isBeyond = _mm_cmpnlt_ps(_mm_andnot_ps(signBit, scaled), wholeTurns);
+			return _mm_or_ps(_mm_and_ps(isBeyond, _mm_mul_ps(angle, _mm_setzero_ps())), _mm_andnot_ps(isBeyond, reduced));
+		};
+		const auto mirror = [&](__m128 x)
+		{
+			//Beyond +-pi/2: copysign(pi, x) - x
+			const __m128 mirrored = _mm_sub_ps(_mm_or_ps(pi, _mm_and_ps(x, signBit)), x);
+			const __m128 isOutside = _mm_cmpgt_ps(_mm_andnot_ps(signBit, x), halfPi);
+			return _mm_or_ps(_mm_and_ps(isOutside, mirrored), _mm_andnot_ps(isOutside, x));
+		};
+		const auto polynomial = [](__m128 x)
+		{
+			const __m128 x2 = _mm_mul_ps(x, x);
+			__m128 p = _mm_set1_ps(-2.50521084e-8f);
+			p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(2.75573192e-6f));
+			p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.98412698e-4f));
+			p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(8.33333333e-3f));
+			p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.66666667e-1f));
+			p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.f));
+			return _mm_mul_ps(p, x);
+		};
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 x = reduce(_mm_loadu_ps(pAngles + i));
+			_mm_storeu_ps(pSin + i, polynomial(mirror(x)));
+			_mm_storeu_ps(pCos + i, polynomial(_mm_sub_ps(halfPi, _mm_andnot_ps(signBit, x))));
+		}
+#endif
+		for (; i < count; ++i)
+			FastSinCos(pAngles[i], pSin[i], pCos[i]);
+	}
+
+	//atan2 of 'count' pairs, four at a time with SSE
+	inline void FastAtan2(const float* pY, const float* pX, float* pAngles, size_t count)
+	{
+		size_t i = 0;
+#if ELITE_FAST_MATH_SSE
+		const __m128 signBit = _mm_set1_ps(-0.f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 halfPi = _mm_set1_ps(FastMath::HalfPi);
+		const __m128 pi = _mm_set1_ps(FastMath::Pi);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 y = _mm_loadu_ps(pY + i);
+			const __m128 x = _mm_loadu_ps(pX + i);
+			const __m128 absY = _mm_andnot_ps(signBit, y);
+			const __m128 absX = _mm_andnot_ps(signBit, x);
+			const __m128 maxXY = _mm_max_ps(absX, absY);
+			const __m128 isZero = _mm_cmpeq_ps(maxXY, zero);
+			const __m128 z = _mm_div_ps(_mm_min_ps(absX, absY), _mm_or_ps(maxXY, _mm_and_ps(isZero, _mm_set1_ps(1.f))));
+
+			const __m128 z2 = _mm_mul_ps(z, z);
+			__m128 angle = _mm_set1_ps(-0.01172120f);
+			angle = _mm_add_ps(_mm_mul_ps(angle, z2), _mm_set1_ps(0.05265332f));
+			angle = _mm_add_ps(_mm_mul_ps(angle, z2), _mm_set1_ps(-0.11643287f));
+			angle = _mm_add_ps(_mm_mul_ps(angle, z2), _mm_set1_ps(0.19354346f));
+			angle = _mm_add_ps(_mm_mul_ps(angle, z2), _mm_set1_ps(-0.33262347f));
+			angle = _mm_add_ps(_mm_mul_ps(angle, z2), _mm_set1_ps(0.99997726f));
+			angle = _mm_mul_ps(angle, z);
+
+			const __m128 isSteep = _mm_cmpgt_ps(absY, absX);
+			angle = _mm_or_ps(_mm_and_ps(isSteep, _mm_sub_ps(halfPi, angle)), _mm_andnot_ps(isSteep, angle));
+			//The sign bit of x, so a negative zero counts as left too
+			const __m128 isLeft = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+			angle = _mm_or_ps(_mm_and_ps(isLeft, _mm_sub_ps(pi, angle)), _mm_andnot_ps(isLeft, angle));
+			_mm_storeu_ps(pAngles + i, _mm_xor_ps(angle, _mm_and_ps(y, signBit)));
+		}
+#endif
+		for (; i < count; ++i)
+			pAngles[i] = FastAtan2(pY[i], pX[i]);
+	}
+}
+#endif
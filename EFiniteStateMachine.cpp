@@ -0,0 +1,158 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EFiniteStateMachine.h"
+
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// FINITE STATE MACHINE
+//-----------------------------------------------------------------
+FiniteStateMachine::FiniteStateMachine(Blackboard* pBlackBoard)
+	: m_pBlackBoard(pBlackBoard)
+{
+	m_pBlackBoard->AddData("ConditionCache", &m_ConditionCache);
+}
+
+unsigned int FiniteStateMachine::AddState(const std::vector<BehaviorState(*)(Blackboard*)>& actions)
+{
+	m_IsCompiled = false;
+	m_BuildActions.push_back(actions);
+	return static_cast<unsigned int>(m_BuildActions.size() - 1);
+}
+
+void FiniteStateMachine::AddTransition(unsigned int fromState, unsigned int toState, const std::vector<FSMGuard>& guards)
+{
+	m_IsCompiled = false;
+	m_BuildTransitions.push_back({ fromState, toState, guards });
+}
+
+void FiniteStateMachine::AddAnyStateTransition(unsigned int toState, const std::vector<FSMGuard>& guards)
+{
+	m_IsCompiled = false;
+	m_BuildTransitions.push_back({ InvalidState, toState, guards });
+}
+
+bool FiniteStateMachine::Compile()
+{
+	const unsigned int stateCount = static_cast<unsigned int>(m_BuildActions.size());
+	m_TransitionOffsets.assign(stateCount + 2, 0);
+	m_Transitions.clear();
+	m_Guards.clear();
+	m_ActionOffsets.assign(stateCount + 1, 0);
+	m_Actions.clear();
+	m_IsCompiled = false;
+
+	for (const BuildTransition& transition : m_BuildTransitions)
+	{
+		const bool isFromValid = transition.fromState == InvalidState || transition.fromState < stateCount;
+		if (!isFromValid || transition.toState >= stateCount)
+		{
+			printf("WARNING: Finite state machine transition between states that don't exist \n");
+			return false;
+		}
+	}
+
+	//Transitions grouped by their state, the any state ones in the last group, each group in the order they were added
+	for (unsigned int state = 0; state <= stateCount; ++state)
+	{
+		const unsigned int fromState = state < stateCount ? state : InvalidState;
+		m_TransitionOffsets[state] = static_cast<unsigned int>(m_Transitions.size());
+		for (const BuildTransition& transition : m_BuildTransitions)
+		{
+			if (transition.fromState != fromState)
+				continue;
+
+			m_Transitions.push_back({ transition.toState, static_cast<unsigned int>(m_Guards.size()), static_cast<unsigned int>(transition.guards.size()) });
+			m_Guards.insert(m_Guards.end(), transition.guards.begin(), transition.guards.end());
+		}
+	}
+	m_TransitionOffsets[stateCount + 1] = static_cast<unsigned int>(m_Transitions.size());
+
+	for (unsigned int state = 0; state < stateCount; ++state)
+	{
+		m_ActionOffsets[state] = static_cast<unsigned int>(m_Actions.size());
+		m_Actions.insert(m_Actions.end(), m_BuildActions[state].begin(), m_BuildActions[state].end());
+	}
+	m_ActionOffsets[stateCount] = static_cast<unsigned int>(m_Actions.size());
+
+	m_CurrentState = 0;
+	m_IsCompiled = stateCount > 0;
+	return m_IsCompiled;
+}
+
+void FiniteStateMachine::SetState(unsigned int state)
+{
+	if (state < m_BuildActions.size())
+		m_CurrentState = state;
+}
+
+void FiniteStateMachine::Update(float /*deltaTime*/)
+{
+	if (!m_IsCompiled && !Compile())
+	{
+		m_ActionState = Failure;
+		return;
+	}
+
+	m_ConditionCache.NewTick();
+
+	const unsigned int stateCount = static_cast<unsigned int>(m_ActionOffsets.size() - 1);
+	if (!TakeAnyStateTransition(m_TransitionOffsets[stateCount], m_TransitionOffsets[stateCount + 1]))
+		TakeTransition(m_TransitionOffsets[m_CurrentState], m_TransitionOffsets[m_CurrentState + 1]);
+
+	//The state's actions run like a sequence
+	m_ActionState = Success;
+	for (unsigned int i = m_ActionOffsets[m_CurrentState]; i < m_ActionOffsets[m_CurrentState + 1]; ++i)
+	{
+		m_ActionState = m_Actions[i] != nullptr ? m_Actions[i](m_pBlackBoard) : Failure;
+		if (m_ActionState != Success)
+			break;
+	}
+}
+
+bool FiniteStateMachine::AreGuardsMet(const Transition& transition)
+{
+	for (unsigned int i = transition.firstGuard; i < transition.firstGuard + transition.guardCount; ++i)
+	{
+		const FSMGuard& guard = m_Guards[i];
+		++m_GuardEvaluationCount;
+		const bool value = guard.fpConditional != nullptr && guard.fpConditional(m_pBlackBoard);
+		if (value != guard.expected)
+			return false;
+	}
+	return true;
+}
+
+bool FiniteStateMachine::TakeTransition(unsigned int firstTransition, unsigned int endTransition)
+{
+	for (unsigned int i = firstTransition; i < endTransition; ++i)
+	{
+		const Transition& transition = m_Transitions[i];
+		if (transition.toState == m_CurrentState || !AreGuardsMet(transition))
+			continue;
+
+		m_CurrentState = transition.toState;
+		++m_TransitionCount;
+		return true;
+	}
+	return false;
+}
+
+//The any state transitions are in priority order, like the children of a selector. One into the current state
+//whose guards still hold keeps the machine there, the ones after it can't take over.
+bool FiniteStateMachine::TakeAnyStateTransition(unsigned int firstTransition, unsigned int endTransition)
+{
+	for (unsigned int i = firstTransition; i < endTransition; ++i)
+	{
+		const Transition& transition = m_Transitions[i];
+		if (!AreGuardsMet(transition))
+			continue;
+		if (transition.toState == m_CurrentState)
+			return true;
+
+		m_CurrentState = transition.toState;
+		++m_TransitionCount;
+		return true;
+	}
+	return false;
+}
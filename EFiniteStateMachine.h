@@ -0,0 +1,120 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EFiniteStateMachine.h: Table driven finite state machine over the same blackboard,
+// conditionals and actions as the behavior tree. Every tick only the guards of the
+// transitions leaving the current state are checked, instead of a whole selector chain.
+/*=============================================================================*/
+#ifndef ELITE_FINITE_STATE_MACHINE
+#define ELITE_FINITE_STATE_MACHINE
+
+//--- Includes ---
+#include "EDecisionMaking.h"
+#include "EBehaviorTree.h"
+#include <vector>
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// FSM HELPERS
+	//-----------------------------------------------------------------
+	//One condition of a transition, met when the conditional returns 'expected'
+	struct FSMGuard final
+	{
+		bool(*fpConditional)(Blackboard*);
+		bool expected;
+	};
+
+	inline FSMGuard When(bool(*fpConditional)(Blackboard*))
+	{ return FSMGuard{ fpConditional, true }; }
+	inline FSMGuard Unless(bool(*fpConditional)(Blackboard*))
+	{ return FSMGuard{ fpConditional, false }; }
+
+	//-----------------------------------------------------------------
+	// FINITE STATE MACHINE
+	//-----------------------------------------------------------------
+	//States and transitions are added while building and laid out in flat tables by Compile: the transitions of every
+	//state next to each other, sorted by state, pointing into one array of guards, and the same for the states' actions.
+	//An Update first takes the first transition whose guards are all met, checking the ones from any state before the
+	//current state's own, then runs the actions of the state it is in, in order until one doesn't succeed.
+	//The current state's own transitions are only checked when no any state transition was met.
+	class FiniteStateMachine final : public Elite::IDecisionMaking
+	{
+	public:
+		static const unsigned int InvalidState = 0xFFFFFFFF;
+
+		explicit FiniteStateMachine(Blackboard* pBlackBoard);
+		~FiniteStateMachine()
+		{
+			delete(m_pBlackBoard); //Takes ownership of passed blackboard!
+			m_pBlackBoard = nullptr;
+		}
+
+		FiniteStateMachine(const FiniteStateMachine& other) = delete;
+		FiniteStateMachine& operator=(const FiniteStateMachine& other) = delete;
+
+		//Building, states are numbered in the order they are added and the first one is where the machine starts
+		unsigned int AddState(const std::vector<BehaviorState(*)(Blackboard*)>& actions);
+		void AddTransition(unsigned int fromState, unsigned int toState, const std::vector<FSMGuard>& guards);
+		//Checked every tick, before the current state's own, in the order they were added: while the machine is in
+		//'toState' and the guards still hold, the ones added after it aren't checked and it stays there
+		void AddAnyStateTransition(unsigned int toState, const std::vector<FSMGuard>& guards);
+		bool Compile();
+
+		virtual void Update(float deltaTime) override;
+		Blackboard* GetBlackboard() const
+		{ return m_pBlackBoard; }
+
+		unsigned int GetCurrentState() const
+		{ return m_CurrentState; }
+		//Result of the current state's actions in the last Update
+		BehaviorState GetActionState() const
+		{ return m_ActionState; }
+		void SetState(unsigned int state);
+
+		unsigned int GetGuardEvaluationCount() const
+		{ return m_GuardEvaluationCount; }
+		unsigned int GetTransitionCount() const
+		{ return m_TransitionCount; }
+
+	private:
+		struct Transition
+		{
+			unsigned int toState;
+			unsigned int firstGuard;
+			unsigned int guardCount;
+		};
+
+		struct BuildTransition
+		{
+			unsigned int fromState; //InvalidState for any state
+			unsigned int toState;
+			std::vector<FSMGuard> guards;
+		};
+
+		bool AreGuardsMet(const Transition& transition);
+		bool TakeTransition(unsigned int firstTransition, unsigned int endTransition);
+		bool TakeAnyStateTransition(unsigned int firstTransition, unsigned int endTransition);
+
+		Blackboard* m_pBlackBoard = nullptr;
+		BehaviorConditionCache m_ConditionCache = {};
+
+		//Building
+		std::vector<std::vector<BehaviorState(*)(Blackboard*)>> m_BuildActions = {};
+		std::vector<BuildTransition> m_BuildTransitions = {};
+
+		//Compiled, state i's transitions are [m_TransitionOffsets[i], m_TransitionOffsets[i + 1]), the any state ones come last
+		std::vector<unsigned int> m_TransitionOffsets = {};
+		std::vector<Transition> m_Transitions = {};
+		std::vector<FSMGuard> m_Guards = {};
+		std::vector<unsigned int> m_ActionOffsets = {};
+		std::vector<BehaviorState(*)(Blackboard*)> m_Actions = {};
+		bool m_IsCompiled = false;
+
+		unsigned int m_CurrentState = 0;
+		BehaviorState m_ActionState = Failure;
+		unsigned int m_GuardEvaluationCount = 0;
+		unsigned int m_TransitionCount = 0;
+	};
+}
+#endif
@@ -0,0 +1,297 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EGoapPlanner.h"
+#include <algorithm>
+#include <bitset>
+
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// GOAP PLANNER
+//-----------------------------------------------------------------
+GoapPlanner::GoapPlanner(Blackboard* pBlackBoard)
+	: m_pBlackBoard(pBlackBoard)
+{
+	m_pBlackBoard->AddData("ConditionCache", &m_ConditionCache);
+}
+
+unsigned int GoapPlanner::AddFact(bool(*fpConditional)(Blackboard*))
+{
+	if (m_Facts.size() == MaxFactCount)
+	{
+		printf("WARNING: GOAP planner can't have more than %u facts \n", MaxFactCount);
+		return InvalidIndex;
+	}
+
+	m_IsCompiled = false;
+	m_Facts.push_back(fpConditional);
+	return static_cast<unsigned int>(m_Facts.size() - 1);
+}
+
+unsigned int GoapPlanner::AddAction(const std::string& name, BehaviorState(*fpAction)(Blackboard*), float cost,
+	const std::vector<GoapFact>& preconditions, const std::vector<GoapFact>& effects)
+{
+	Action action{ name, fpAction, cost, {}, {} };
+	if (!MakeCondition(preconditions, action.preconditions) || !MakeCondition(effects, action.effects) || cost <= 0.f)
+	{
+		printf("WARNING: GOAP action '%s' uses a fact that doesn't exist or doesn't cost anything \n", name.c_str());
+		return InvalidIndex;
+	}
+
+	m_IsCompiled = false;
+	m_Actions.push_back(action);
+	return static_cast<unsigned int>(m_Actions.size() - 1);
+}
+
+unsigned int GoapPlanner::AddGoal(const std::string& name, const std::vector<GoapFact>& facts)
+{
+	Goal goal{ name, {} };
+	if (!MakeCondition(facts, goal.condition))
+	{
+		printf("WARNING: GOAP goal '%s' uses a fact that doesn't exist \n", name.c_str());
+		return InvalidIndex;
+	}
+
+	m_IsCompiled = false;
+	m_Goals.push_back(goal);
+	return static_cast<unsigned int>(m_Goals.size() - 1);
+}
+
+bool GoapPlanner::MakeCondition(const std::vector<GoapFact>& facts, GoapCondition& condition) const
+{
+	condition = GoapCondition{};
+	for (const GoapFact& fact : facts)
+	{
+		if (fact.fact >= m_Facts.size())
+			return false;
+
+		const uint64_t bit = 1ULL << fact.fact;
+		condition.mask |= bit;
+		condition.values = fact.value ? condition.values | bit : condition.values & ~bit;
+	}
+	return true;
+}
+
+bool GoapPlanner::Compile()
+{
+	m_RelevantFacts = 0;
+	m_CostPerFact = 0.f;
+	bool isCostSet = false;
+	for (const Action& action : m_Actions)
+	{
+		m_RelevantFacts |= action.preconditions.mask;
+
+		const size_t effectCount = std::bitset<64>(action.effects.mask).count();
+		if (effectCount == 0)
+			continue;
+
+		const float costPerFact = action.cost / effectCount;
+		m_CostPerFact = isCostSet ? (std::min)(m_CostPerFact, costPerFact) : costPerFact;
+		isCostSet = true;
+	}
+	for (const Goal& goal : m_Goals)
+		m_RelevantFacts |= goal.condition.mask;
+
+	//Everything a search needs, allocated once
+	m_Nodes.clear();
+	m_Nodes.reserve(MaxSearchNodes);
+	m_Open.clear();
+	m_Open.reserve(MaxSearchNodes); //Every push adds a node
+	m_Visited.assign(MaxSearchNodes * 2, VisitedEntry{ 0, 0, 0 });
+	m_Search = 0;
+
+	for (CachedPlan& cachedPlan : m_PlanCache)
+		cachedPlan = CachedPlan{};
+	m_NextCacheEntry = 0;
+	m_PlanGoal = InvalidIndex;
+	m_PlanLength = 0;
+	m_PlanStep = 0;
+
+	m_IsCompiled = true;
+	return true;
+}
+
+void GoapPlanner::Update(float /*deltaTime*/)
+{
+	if (!m_IsCompiled)
+		Compile();
+
+	m_ConditionCache.NewTick();
+	m_WorldState = 0;
+	for (size_t i = 0; i < m_Facts.size(); ++i)
+	{
+		if (m_Facts[i] != nullptr && m_Facts[i](m_pBlackBoard))
+			m_WorldState |= 1ULL << i;
+	}
+
+	//The current plan goes on while its goal still is the first unmet one and its next action can run
+	const bool isPlanValid = m_PlanStep < m_PlanLength && m_Actions[m_Plan[m_PlanStep]].preconditions.IsMetBy(m_WorldState);
+	unsigned int goal = 0;
+	for (; goal < m_Goals.size(); ++goal)
+	{
+		if (m_Goals[goal].condition.IsMetBy(m_WorldState))
+			continue;
+		if (goal == m_PlanGoal && isPlanValid)
+			break;
+		if (Plan(m_WorldState, goal, m_Plan, m_PlanLength) && m_PlanLength > 0)
+		{
+			m_PlanGoal = goal;
+			m_PlanStep = 0;
+			break;
+		}
+	}
+
+	if (goal == m_Goals.size())
+	{
+		m_PlanGoal = InvalidIndex;
+		m_PlanLength = 0;
+		m_PlanStep = 0;
+		m_ActionState = m_fpIdleAction != nullptr ? m_fpIdleAction(m_pBlackBoard) : Success;
+		return;
+	}
+
+	const Action& action = m_Actions[m_Plan[m_PlanStep]];
+	m_ActionState = action.fpAction != nullptr ? action.fpAction(m_pBlackBoard) : Failure;
+	switch (m_ActionState)
+	{
+	case Success:
+		++m_PlanStep;
+		break;
+	case Failure:
+		m_PlanLength = 0; //Plans again next tick, from what the world looks like then
+		m_PlanStep = 0;
+		break;
+	default:
+		break;
+	}
+}
+
+bool GoapPlanner::Plan(uint64_t worldState, unsigned int goal, unsigned int* pPlan, unsigned int& planLength)
+{
+	planLength = 0;
+	if (goal >= m_Goals.size())
+		return false;
+	if (!m_IsCompiled)
+		Compile();
+
+	const uint64_t relevantState = worldState & m_RelevantFacts;
+	const CachedPlan* pCachedPlan = nullptr;
+	for (const CachedPlan& cachedPlan : m_PlanCache)
+	{
+		if (cachedPlan.goal == goal && cachedPlan.worldState == relevantState)
+		{
+			pCachedPlan = &cachedPlan;
+			++m_CacheHitCount;
+			break;
+		}
+	}
+
+	if (pCachedPlan == nullptr)
+	{
+		CachedPlan& cachedPlan = m_PlanCache[m_NextCacheEntry];
+		m_NextCacheEntry = (m_NextCacheEntry + 1) % PlanCacheSize;
+		cachedPlan.goal = goal;
+		cachedPlan.worldState = relevantState;
+		cachedPlan.isFound = Search(relevantState, goal, cachedPlan);
+		pCachedPlan = &cachedPlan;
+	}
+
+	if (!pCachedPlan->isFound)
+		return false;
+	std::copy(pCachedPlan->plan, pCachedPlan->plan + pCachedPlan->length, pPlan);
+	planLength = pCachedPlan->length;
+	return true;
+}
+
+//Cheapest cost of setting the goal's facts that are still wrong, never more than the real cost
+float GoapPlanner::EstimateCost(uint64_t worldState, const GoapCondition& goal) const
+{
+	return std::bitset<64>((worldState ^ goal.values) & goal.mask).count() * m_CostPerFact;
+}
+
+//A* from 'worldState', the visited table keeps the cheapest node per world state
+bool GoapPlanner::Search(uint64_t worldState, unsigned int goal, CachedPlan& plan)
+{
+	++m_SearchCount;
+	if (++m_Search == 0)
+	{
+		//Entries of searches that long ago would look current again
+		for (VisitedEntry& entry : m_Visited)
+			entry.search = 0;
+		m_Search = 1;
+	}
+	m_Nodes.clear();
+	m_Open.clear();
+	plan.length = 0;
+
+	const GoapCondition& goalCondition = m_Goals[goal].condition;
+	m_Nodes.push_back({ worldState, 0.f, EstimateCost(worldState, goalCondition), InvalidIndex, InvalidIndex, 0 });
+	FindVisited(worldState) = { worldState, 0, m_Search };
+	PushOpen(0);
+
+	while (!m_Open.empty())
+	{
+		const unsigned int index = PopOpen();
+		const SearchNode node = m_Nodes[index];
+		if (FindVisited(node.worldState).node != index)
+			continue; //A cheaper way to the same state was found after this one was queued
+
+		if (goalCondition.IsMetBy(node.worldState))
+		{
+			plan.length = node.depth;
+			for (unsigned int i = index; m_Nodes[i].parent != InvalidIndex; i = m_Nodes[i].parent)
+				plan.plan[m_Nodes[i].depth - 1] = m_Nodes[i].action;
+			return true;
+		}
+		if (node.depth == MaxPlanLength)
+			continue;
+
+		for (unsigned int action = 0; action < m_Actions.size(); ++action)
+		{
+			const Action& candidate = m_Actions[action];
+			if (!candidate.preconditions.IsMetBy(node.worldState))
+				continue;
+
+			const uint64_t nextState = candidate.effects.ApplyTo(node.worldState);
+			if (nextState == node.worldState)
+				continue;
+
+			const float cost = node.cost + candidate.cost;
+			VisitedEntry& visited = FindVisited(nextState);
+			if (visited.search == m_Search && m_Nodes[visited.node].cost <= cost)
+				continue;
+			if (m_Nodes.size() == MaxSearchNodes)
+				return false;
+
+			const unsigned int nextIndex = static_cast<unsigned int>(m_Nodes.size());
+			m_Nodes.push_back({ nextState, cost, cost + EstimateCost(nextState, goalCondition), index, action, node.depth + 1 });
+			visited = { nextState, nextIndex, m_Search };
+			PushOpen(nextIndex);
+		}
+	}
+	return false;
+}
+
+//The entry of this world state in the current search, or the empty one where it would go
+GoapPlanner::VisitedEntry& GoapPlanner::FindVisited(uint64_t worldState)
+{
+	const size_t mask = m_Visited.size() - 1;
+	size_t slot = static_cast<size_t>((worldState * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+	while (m_Visited[slot].search == m_Search && m_Visited[slot].worldState != worldState)
+		slot = (slot + 1) & mask;
+	return m_Visited[slot];
+}
+
+void GoapPlanner::PushOpen(unsigned int node)
+{
+	m_Open.push_back(node);
+	std::push_heap(m_Open.begin(), m_Open.end(), [this](unsigned int a, unsigned int b) { return m_Nodes[a].estimate > m_Nodes[b].estimate; });
+}
+
+unsigned int GoapPlanner::PopOpen()
+{
+	std::pop_heap(m_Open.begin(), m_Open.end(), [this](unsigned int a, unsigned int b) { return m_Nodes[a].estimate > m_Nodes[b].estimate; });
+	const unsigned int node = m_Open.back();
+	m_Open.pop_back();
+	return node;
+}
@@ -0,0 +1,183 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EGoapPlanner.h: Goal oriented action planner over the same blackboard, conditionals and
+// actions as the behavior tree. The world state is a bitset of facts sensed by conditionals,
+// actions have precondition and effect masks, and plans are searched with A* over storage
+// that is allocated once, so planning doesn't allocate.
+/*=============================================================================*/
+#ifndef ELITE_GOAP_PLANNER
+#define ELITE_GOAP_PLANNER
+
+//--- Includes ---
+#include "EDecisionMaking.h"
+#include "EBehaviorTree.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// GOAP HELPERS
+	//-----------------------------------------------------------------
+	//A fact of the world state and the value it should have, or gets
+	struct GoapFact final
+	{
+		unsigned int fact;
+		bool value;
+	};
+
+	//The facts in 'mask' having the values in 'values'
+	struct GoapCondition final
+	{
+		uint64_t mask = 0;
+		uint64_t values = 0;
+
+		bool IsMetBy(uint64_t worldState) const
+		{ return (worldState & mask) == values; }
+		uint64_t ApplyTo(uint64_t worldState) const
+		{ return (worldState & ~mask) | values; }
+	};
+
+	//-----------------------------------------------------------------
+	// GOAP PLANNER
+	//-----------------------------------------------------------------
+	//Every Update senses the facts, picks the first goal (in the order they were added) that isn't met and has a plan,
+	//and runs the plan's current action. A plan is kept while the next action's preconditions hold, and a plan found once
+	//is cached by its goal and the start state's facts that any precondition or goal looks at, so going back to the same
+	//situation doesn't search again.
+	class GoapPlanner final : public Elite::IDecisionMaking
+	{
+	public:
+		static const unsigned int MaxFactCount = 64;
+		static const unsigned int MaxPlanLength = 16;
+		static const unsigned int MaxSearchNodes = 4096;
+		static const unsigned int PlanCacheSize = 16;
+		static const unsigned int InvalidIndex = 0xFFFFFFFF;
+
+		explicit GoapPlanner(Blackboard* pBlackBoard);
+		~GoapPlanner()
+		{
+			delete(m_pBlackBoard); //Takes ownership of passed blackboard!
+			m_pBlackBoard = nullptr;
+		}
+
+		GoapPlanner(const GoapPlanner& other) = delete;
+		GoapPlanner& operator=(const GoapPlanner& other) = delete;
+
+		//Building
+		unsigned int AddFact(bool(*fpConditional)(Blackboard*));
+		unsigned int AddAction(const std::string& name, BehaviorState(*fpAction)(Blackboard*), float cost,
+			const std::vector<GoapFact>& preconditions, const std::vector<GoapFact>& effects);
+		unsigned int AddGoal(const std::string& name, const std::vector<GoapFact>& facts);
+		//Runs while every goal is met or none of them can be planned for
+		void SetIdleAction(BehaviorState(*fpAction)(Blackboard*))
+		{ m_fpIdleAction = fpAction; }
+		bool Compile();
+
+		virtual void Update(float deltaTime) override;
+		Blackboard* GetBlackboard() const
+		{ return m_pBlackBoard; }
+
+		uint64_t GetWorldState() const
+		{ return m_WorldState; }
+		unsigned int GetCurrentGoal() const
+		{ return m_PlanGoal; }
+		//Action the plan is at, InvalidIndex while idle
+		unsigned int GetCurrentAction() const
+		{ return m_PlanStep < m_PlanLength ? m_Plan[m_PlanStep] : InvalidIndex; }
+		const std::string& GetActionName(unsigned int action) const
+		{ return m_Actions[action].name; }
+		BehaviorState GetActionState() const
+		{ return m_ActionState; }
+
+		unsigned int GetSearchCount() const
+		{ return m_SearchCount; }
+		unsigned int GetCacheHitCount() const
+		{ return m_CacheHitCount; }
+
+		//Plans from 'worldState' to the goal, returns false when there is none within MaxPlanLength and MaxSearchNodes
+		bool Plan(uint64_t worldState, unsigned int goal, unsigned int* pPlan, unsigned int& planLength);
+
+	private:
+		struct Action
+		{
+			std::string name;
+			BehaviorState(*fpAction)(Blackboard*);
+			float cost;
+			GoapCondition preconditions;
+			GoapCondition effects;
+		};
+
+		struct Goal
+		{
+			std::string name;
+			GoapCondition condition;
+		};
+
+		struct SearchNode
+		{
+			uint64_t worldState;
+			float cost;
+			float estimate; //cost + heuristic
+			unsigned int parent;
+			unsigned int action;
+			unsigned int depth;
+		};
+
+		struct VisitedEntry
+		{
+			uint64_t worldState;
+			unsigned int node;
+			unsigned int search; //Search it belongs to, older entries count as empty
+		};
+
+		struct CachedPlan
+		{
+			unsigned int goal = InvalidIndex;
+			uint64_t worldState = 0;
+			bool isFound = false; //Goals without a plan are cached too, so they aren't searched again every tick
+			unsigned int length = 0;
+			unsigned int plan[MaxPlanLength] = {};
+		};
+
+		bool MakeCondition(const std::vector<GoapFact>& facts, GoapCondition& condition) const;
+		float EstimateCost(uint64_t worldState, const GoapCondition& goal) const;
+		bool Search(uint64_t worldState, unsigned int goal, CachedPlan& plan);
+		VisitedEntry& FindVisited(uint64_t worldState);
+		void PushOpen(unsigned int node);
+		unsigned int PopOpen();
+
+		Blackboard* m_pBlackBoard = nullptr;
+		BehaviorConditionCache m_ConditionCache = {};
+
+		std::vector<bool(*)(Blackboard*)> m_Facts = {};
+		std::vector<Action> m_Actions = {};
+		std::vector<Goal> m_Goals = {};
+		BehaviorState(*m_fpIdleAction)(Blackboard*) = nullptr;
+		uint64_t m_RelevantFacts = 0; //Facts any precondition or goal looks at, the rest can't change a plan
+		float m_CostPerFact = 0.f; //Lowest cost of setting one fact, keeps the heuristic admissible
+		bool m_IsCompiled = false;
+
+		//Search storage, sized by Compile and reused by every search
+		std::vector<SearchNode> m_Nodes = {};
+		std::vector<unsigned int> m_Open = {}; //Binary heap of node indices on estimate
+		std::vector<VisitedEntry> m_Visited = {}; //Open addressing, twice MaxSearchNodes entries
+		unsigned int m_Search = 0;
+		CachedPlan m_PlanCache[PlanCacheSize] = {};
+		unsigned int m_NextCacheEntry = 0;
+
+		//Current plan
+		uint64_t m_WorldState = 0;
+		unsigned int m_PlanGoal = InvalidIndex;
+		unsigned int m_Plan[MaxPlanLength] = {};
+		unsigned int m_PlanLength = 0;
+		unsigned int m_PlanStep = 0;
+		BehaviorState m_ActionState = Failure;
+
+		unsigned int m_SearchCount = 0;
+		unsigned int m_CacheHitCount = 0;
+	};
+}
+#endif
@@ -0,0 +1,229 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EPerformanceCounters.h: Hardware performance counters attributed to the phases of a tick.
+// Build with ELITE_PERF_COUNTERS set to 1 on Linux to read cycles, instructions, L1D/LLC
+// misses and branch misses through perf_event_open. Anywhere else the phases are no-ops.
+/*=============================================================================*/
+#ifndef ELITE_PERFORMANCE_COUNTERS
+#define ELITE_PERFORMANCE_COUNTERS
+
+#ifndef ELITE_PERF_COUNTERS
+#define ELITE_PERF_COUNTERS 0
+#endif
+
+#if ELITE_PERF_COUNTERS && !defined(__linux__)
+#undef ELITE_PERF_COUNTERS
+#define ELITE_PERF_COUNTERS 0
+#endif
+
+//--- Includes ---
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if ELITE_PERF_COUNTERS
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// PERFORMANCE COUNTERS
+	//-----------------------------------------------------------------
+	enum PerfCounter
+	{
+		PerfCycles,
+		PerfInstructions,
+		PerfL1DMisses,
+		PerfLLCMisses,
+		PerfBranchMisses,
+		PerfCounterCount
+	};
+
+	//The counters of the calling thread, user space only so it works without lowering perf_event_paranoid.
+	//They are opened as one group, so the kernel schedules them together and one read returns all of them
+	//for the same stretch of time. Counters the CPU or kernel doesn't offer stay closed and read 0.
+	class PerfCounterSet final
+	{
+	public:
+		PerfCounterSet() = default;
+		~PerfCounterSet() { Close(); }
+
+		PerfCounterSet(const PerfCounterSet& other) = delete;
+		PerfCounterSet& operator=(const PerfCounterSet& other) = delete;
+
+		bool Open()
+		{
+#if ELITE_PERF_COUNTERS
+			static const uint32_t types[PerfCounterCount] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE };
+			static const uint64_t configs[PerfCounterCount] =
+			{
+				PERF_COUNT_HW_CPU_CYCLES,
+				PERF_COUNT_HW_INSTRUCTIONS,
+				PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+				PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+				PERF_COUNT_HW_BRANCH_MISSES
+			};
+
+			Close();
+			for (int i = 0; i < PerfCounterCount; ++i)
+			{
+				perf_event_attr attributes;
+				memset(&attributes, 0, sizeof(attributes));
+				attributes.size = sizeof(attributes);
+				attributes.type = types[i];
+				attributes.config = configs[i];
+				attributes.exclude_kernel = 1;
+				attributes.exclude_hv = 1;
+				attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+				//The first counter that opens leads the group, the others join it
+				const int leader = m_GroupSize > 0 ? m_FileDescriptors[m_GroupOrder[0]] : -1;
+				m_FileDescriptors[i] = static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, leader, 0));
+				if (m_FileDescriptors[i] >= 0)
+					m_GroupOrder[m_GroupSize++] = i;
+			}
+			if (m_GroupSize == 0)
+				printf("WARNING: perf_event_open failed, hardware counters are not available \n");
+			return m_GroupSize > 0;
+#else
+			return false;
+#endif
+		}
+
+		void Close()
+		{
+#if ELITE_PERF_COUNTERS
+			//Members first, the leader last
+			for (int i = m_GroupSize - 1; i >= 0; --i)
+				close(m_FileDescriptors[m_GroupOrder[i]]);
+			for (int& fileDescriptor : m_FileDescriptors)
+				fileDescriptor = -1;
+			m_GroupSize = 0;
+#endif
+		}
+
+		bool IsOpen(PerfCounter counter) const
+		{ return m_FileDescriptors[counter] >= 0; }
+
+		//Counts since Open, scaled up when the kernel had to multiplex the group. One read for all counters.
+		void Read(uint64_t values[PerfCounterCount]) const
+		{
+			for (int i = 0; i < PerfCounterCount; ++i)
+				values[i] = 0;
+#if ELITE_PERF_COUNTERS
+			if (m_GroupSize == 0)
+				return;
+
+			uint64_t data[3 + PerfCounterCount] = {}; //counter count, time enabled, time running, the values in group order
+			const ssize_t size = static_cast<ssize_t>((3 + m_GroupSize) * sizeof(uint64_t));
+			if (read(m_FileDescriptors[m_GroupOrder[0]], data, sizeof(data)) != size || data[0] != static_cast<uint64_t>(m_GroupSize))
+				return;
+
+			const bool isMultiplexed = data[2] > 0 && data[2] < data[1];
+			for (int i = 0; i < m_GroupSize; ++i)
+			{
+				const uint64_t value = data[3 + i];
+				values[m_GroupOrder[i]] = isMultiplexed ? static_cast<uint64_t>(static_cast<double>(value) * data[1] / data[2]) : value;
+			}
+#endif
+		}
+
+	private:
+		int m_FileDescriptors[PerfCounterCount] = { -1, -1, -1, -1, -1 };
+		int m_GroupOrder[PerfCounterCount] = {}; //Counter of every group member, the leader first
+		int m_GroupSize = 0;
+	};
+
+	//-----------------------------------------------------------------
+	// PHASE COUNTERS
+	//-----------------------------------------------------------------
+	//Adds up the counters between BeginPhase and EndPhase per phase, and every 'reportInterval' ticks
+	//writes the average per tick of every phase and starts over.
+	class PerfPhaseCounters final
+	{
+	public:
+		PerfPhaseCounters(const std::vector<std::string>& phaseNames, unsigned int reportInterval)
+			: m_PhaseNames(phaseNames), m_Phases(phaseNames.size()), m_ReportInterval(reportInterval)
+		{}
+
+		bool Open() { return m_IsOpen = m_Counters.Open(); }
+
+		void BeginPhase(unsigned int phase)
+		{
+#if ELITE_PERF_COUNTERS
+			if (m_IsOpen && phase < m_Phases.size())
+				m_Counters.Read(m_Phases[phase].begin);
+#endif
+		}
+
+		void EndPhase(unsigned int phase)
+		{
+#if ELITE_PERF_COUNTERS
+			if (!m_IsOpen || phase >= m_Phases.size())
+				return;
+
+			uint64_t end[PerfCounterCount];
+			m_Counters.Read(end);
+			Phase& p = m_Phases[phase];
+			for (int i = 0; i < PerfCounterCount; ++i)
+				p.total[i] += end[i] - p.begin[i];
+#endif
+		}
+
+		void EndTick(std::ostream& os)
+		{
+#if ELITE_PERF_COUNTERS
+			if (!m_IsOpen || ++m_TickCount < m_ReportInterval)
+				return;
+
+			Report(os);
+			for (Phase& p : m_Phases)
+				p = Phase{};
+			m_TickCount = 0;
+#endif
+		}
+
+		void Report(std::ostream& os) const
+		{
+			static const char* counterNames[PerfCounterCount] = { "cycles", "instructions", "L1D misses", "LLC misses", "branch misses" };
+
+			const double ticks = m_TickCount > 0 ? static_cast<double>(m_TickCount) : 1.0;
+			os << "Performance counters, average per tick over " << m_TickCount << " ticks\n";
+			for (size_t phase = 0; phase < m_Phases.size(); ++phase)
+			{
+				const Phase& p = m_Phases[phase];
+				os << "  " << m_PhaseNames[phase] << ":";
+				for (int i = 0; i < PerfCounterCount; ++i)
+				{
+					if (m_Counters.IsOpen(static_cast<PerfCounter>(i)))
+						os << ' ' << counterNames[i] << ' ' << static_cast<double>(p.total[i]) / ticks << ',';
+				}
+				if (p.total[PerfCycles] > 0)
+					os << " IPC " << static_cast<double>(p.total[PerfInstructions]) / p.total[PerfCycles];
+				os << '\n';
+			}
+		}
+
+	private:
+		struct Phase
+		{
+			uint64_t begin[PerfCounterCount] = {};
+			uint64_t total[PerfCounterCount] = {};
+		};
+
+		PerfCounterSet m_Counters;
+		std::vector<std::string> m_PhaseNames;
+		std::vector<Phase> m_Phases;
+		unsigned int m_ReportInterval;
+		unsigned int m_TickCount = 0;
+		bool m_IsOpen = false;
+	};
+}
+#endif
@@ -0,0 +1,284 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EStaticBehaviorTree.h: Behavior tree composed at compile time out of templates.
+// The whole tree is one type, building it doesn't allocate and a tick has no
+// virtual calls or std::function, so the compiler can inline it into one function.
+/*=============================================================================*/
+#ifndef ELITE_STATIC_BEHAVIOR_TREE
+#define ELITE_STATIC_BEHAVIOR_TREE
+
+//--- Includes ---
+#include "EBehaviorTree.h"
+#include <tuple>
+#include <type_traits>
+
+namespace Elite
+{
+	namespace StaticBT
+	{
+		//-----------------------------------------------------------------
+		// LEAVES
+		//-----------------------------------------------------------------
+		template<bool(*fpConditional)(Blackboard*)>
+		class Cond final
+		{
+		public:
+			BehaviorState Execute(Blackboard* pBlackBoard)
+			{ return fpConditional(pBlackBoard) ? Success : Failure; }
+		};
+
+		template<BehaviorState(*fpAction)(Blackboard*)>
+		class Act final
+		{
+		public:
+			BehaviorState Execute(Blackboard* pBlackBoard)
+			{ return fpAction(pBlackBoard); }
+		};
+
+		//-----------------------------------------------------------------
+		// COMPOSITES
+		//-----------------------------------------------------------------
+#pragma region COMPOSITES
+		//--- SELECTOR ---
+		template<typename... TChildren>
+		class Selector final
+		{
+		public:
+			BehaviorState Execute(Blackboard* pBlackBoard)
+			{ return ExecuteFrom<0>(pBlackBoard); }
+
+		private:
+			template<size_t I> BehaviorState ExecuteFrom(Blackboard* pBlackBoard)
+			{ return ExecuteChild<I>(pBlackBoard, std::integral_constant<bool, (I < sizeof...(TChildren))>{}); }
+
+			template<size_t I> BehaviorState ExecuteChild(Blackboard* pBlackBoard, std::true_type)
+			{
+				const BehaviorState state = std::get<I>(m_Children).Execute(pBlackBoard);
+				if (state != Failure)
+					return state;
+				return ExecuteFrom<I + 1>(pBlackBoard);
+			}
+			template<size_t I> BehaviorState ExecuteChild(Blackboard*, std::false_type)
+			{ return Failure; }
+
+			std::tuple<TChildren...> m_Children;
+		};
+
+		//--- SEQUENCE ---
+		template<typename... TChildren>
+		class Sequence final
+		{
+		public:
+			BehaviorState Execute(Blackboard* pBlackBoard)
+			{ return ExecuteFrom<0>(pBlackBoard); }
+
+		private:
+			template<size_t I> BehaviorState ExecuteFrom(Blackboard* pBlackBoard)
+			{ return ExecuteChild<I>(pBlackBoard, std::integral_constant<bool, (I < sizeof...(TChildren))>{}); }
+
+			template<size_t I> BehaviorState ExecuteChild(Blackboard* pBlackBoard, std::true_type)
+			{
+				const BehaviorState state = std::get<I>(m_Children).Execute(pBlackBoard);
+				if (state != Success)
+					return state;
+				return ExecuteFrom<I + 1>(pBlackBoard);
+			}
+			template<size_t I> BehaviorState ExecuteChild(Blackboard*, std::false_type)
+			{ return Success; }
+
+			std::tuple<TChildren...> m_Children;
+		};
+
+		//--- PARTIAL SEQUENCE ---
+		//Runs one child per tick, same semantics as BehaviorPartialSequence
+		template<typename... TChildren>
+		class PartialSequence final
+		{
+		public:
+			BehaviorState Execute(Blackboard* pBlackBoard)
+			{
+				if (m_CurrentBehaviorIndex >= sizeof...(TChildren))
+				{
+					m_CurrentBehaviorIndex = 0;
+					return Success;
+				}
+
+				switch (ExecuteAt<0>(pBlackBoard))
+				{
+				case Failure:
+					m_CurrentBehaviorIndex = 0;
+					return Failure;
+				case Success:
+					++m_CurrentBehaviorIndex;
+					return Running;
+				default:
+					return Running;
+				}
+			}
+
+		private:
+			template<size_t I> BehaviorState ExecuteAt(Blackboard* pBlackBoard)
+			{ return ExecuteChild<I>(pBlackBoard, std::integral_constant<bool, (I < sizeof...(TChildren))>{}); }
+
+			template<size_t I> BehaviorState ExecuteChild(Blackboard* pBlackBoard, std::true_type)
+			{
+				if (m_CurrentBehaviorIndex == I)
+					return std::get<I>(m_Children).Execute(pBlackBoard);
+				return ExecuteAt<I + 1>(pBlackBoard);
+			}
+			template<size_t I> BehaviorState ExecuteChild(Blackboard*, std::false_type)
+			{ return Failure; }
+
+			std::tuple<TChildren...> m_Children;
+			unsigned int m_CurrentBehaviorIndex = 0;
+		};
+
+		//--- MEMORY SELECTOR ---
+		//Continues at the child that was running, same semantics as BehaviorMemorySelector
+		template<typename... TChildren>
+		class MemorySelector final
+		{
+		public:
+			BehaviorState Execute(Blackboard* pBlackBoard)
+			{ return ExecuteFrom<0>(pBlackBoard); }
+
+		private:
+			template<size_t I> BehaviorState ExecuteFrom(Blackboard* pBlackBoard)
+			{ return ExecuteChild<I>(pBlackBoard, std::integral_constant<bool, (I < sizeof...(TChildren))>{}); }
+
+			template<size_t I> BehaviorState ExecuteChild(Blackboard* pBlackBoard, std::true_type)
+			{
+				if (I < m_RunningBehaviorIndex)
+					return ExecuteFrom<I + 1>(pBlackBoard);
+
+				const BehaviorState state = std::get<I>(m_Children).Execute(pBlackBoard);
+				if (state == Failure)
+					return ExecuteFrom<I + 1>(pBlackBoard);
+				m_RunningBehaviorIndex = state == Running ? static_cast<unsigned int>(I) : 0;
+				return state;
+			}
+			template<size_t I> BehaviorState ExecuteChild(Blackboard*, std::false_type)
+			{
+				m_RunningBehaviorIndex = 0;
+				return Failure;
+			}
+
+			std::tuple<TChildren...> m_Children;
+			unsigned int m_RunningBehaviorIndex = 0;
+		};
+
+		//--- MEMORY SEQUENCE ---
+		//Continues at the child that was running, same semantics as BehaviorMemorySequence
+		template<typename... TChildren>
+		class MemorySequence final
+		{
+		public:
+			BehaviorState Execute(Blackboard* pBlackBoard)
+			{ return ExecuteFrom<0>(pBlackBoard); }
+
+		private:
+			template<size_t I> BehaviorState ExecuteFrom(Blackboard* pBlackBoard)
+			{ return ExecuteChild<I>(pBlackBoard, std::integral_constant<bool, (I < sizeof...(TChildren))>{}); }
+
+			template<size_t I> BehaviorState ExecuteChild(Blackboard* pBlackBoard, std::true_type)
+			{
+				if (I < m_RunningBehaviorIndex)
+					return ExecuteFrom<I + 1>(pBlackBoard);
+
+				const BehaviorState state = std::get<I>(m_Children).Execute(pBlackBoard);
+				if (state == Success)
+					return ExecuteFrom<I + 1>(pBlackBoard);
+				m_RunningBehaviorIndex = state == Running ? static_cast<unsigned int>(I) : 0;
+				return state;
+			}
+			template<size_t I> BehaviorState ExecuteChild(Blackboard*, std::false_type)
+			{
+				m_RunningBehaviorIndex = 0;
+				return Success;
+			}
+
+			std::tuple<TChildren...> m_Children;
+			unsigned int m_RunningBehaviorIndex = 0;
+		};
+#pragma endregion
+
+		//-----------------------------------------------------------------
+		// DECORATORS
+		//-----------------------------------------------------------------
+		//--- COOLDOWN ---
+		//Fails without running the child for 'CooldownMilliseconds' after it succeeded, same semantics as BehaviorCooldown.
+		//Timed on the "TimingWheel" of the blackboard, which the Tree registers and advances.
+		template<typename TChild, unsigned int CooldownMilliseconds>
+		class Cooldown final
+		{
+		public:
+			BehaviorState Execute(Blackboard* pBlackBoard)
+			{
+				if (m_Timer.IsPending())
+					return Failure;
+
+				if (!m_TimingWheelKey.IsValid())
+					m_TimingWheelKey = pBlackBoard->GetKey<TimingWheel*>("TimingWheel");
+				TimingWheel* pTimingWheel = nullptr;
+				if (!pBlackBoard->TryGetData(m_TimingWheelKey, pTimingWheel) || pTimingWheel == nullptr)
+				{
+					printf("WARNING: Cooldown needs a 'TimingWheel' in the Blackboard \n");
+					return Failure;
+				}
+
+				const BehaviorState state = m_Child.Execute(pBlackBoard);
+				if (state == Success)
+					pTimingWheel->Schedule(m_Timer, CooldownMilliseconds / 1000.f);
+				return state;
+			}
+
+		private:
+			TChild m_Child;
+			TimingWheel::Timer m_Timer = {};
+			BlackboardKey<TimingWheel*> m_TimingWheelKey = {};
+		};
+
+		//-----------------------------------------------------------------
+		// STATIC BEHAVIOR TREE
+		//-----------------------------------------------------------------
+		template<typename TRoot>
+		class Tree final : public IDecisionMaking
+		{
+		public:
+			explicit Tree(Blackboard* pBlackBoard)
+				: m_pBlackBoard(pBlackBoard)
+			{
+				m_pBlackBoard->AddData("ConditionCache", &m_ConditionCache);
+				m_pBlackBoard->AddData("TimingWheel", &m_TimingWheel);
+			};
+			~Tree()
+			{
+				delete(m_pBlackBoard); //Takes ownership of passed blackboard!
+				m_pBlackBoard = nullptr;
+			};
+
+			Tree(const Tree& other) = delete;
+			Tree& operator=(const Tree& other) = delete;
+			Tree(Tree&& other) = delete;
+			Tree& operator=(Tree&& other) = delete;
+
+			virtual void Update(float deltaTime) override
+			{
+				m_TimingWheel.Advance(deltaTime);
+				m_ConditionCache.NewTick();
+				m_CurrentState = m_Root.Execute(m_pBlackBoard);
+			}
+			Blackboard* GetBlackboard() const
+			{ return m_pBlackBoard; }
+
+		private:
+			BehaviorState m_CurrentState = Failure;
+			Blackboard* m_pBlackBoard = nullptr;
+			BehaviorConditionCache m_ConditionCache = {};
+			TimingWheel m_TimingWheel{};
+			TRoot m_Root;
+		};
+	}
+}
+#endif
@@ -0,0 +1,178 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EThreadPool.h: Small work-stealing thread pool for running batches of short tasks,
+// e.g. the children of a BehaviorParallel. Every worker has its own queue and steals
+// from the others when it runs dry, the thread waiting on a batch helps out as well.
+/*=============================================================================*/
+#ifndef ELITE_THREAD_POOL
+#define ELITE_THREAD_POOL
+
+//--- Includes ---
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// THREAD POOL
+	//-----------------------------------------------------------------
+	class ThreadPool final
+	{
+	public:
+		struct Task
+		{
+			void(*fpRun)(void* pContext);
+			void* pContext;
+		};
+
+		//Without workers Run does every task itself, on the calling thread
+		explicit ThreadPool(unsigned int workerCount)
+		{
+			m_Queues.reserve(workerCount + 1);
+			for (unsigned int i = 0; i <= workerCount; ++i) //The last queue takes tasks from threads outside the pool
+				m_Queues.push_back(std::unique_ptr<Queue>(new Queue()));
+			m_Workers.reserve(workerCount);
+			for (unsigned int i = 0; i < workerCount; ++i)
+				m_Workers.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+		}
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_SleepMutex);
+				m_IsStopping = true;
+			}
+			m_WakeUp.notify_all();
+			for (std::thread& worker : m_Workers)
+				worker.join();
+		}
+
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+		ThreadPool(ThreadPool&& other) = delete;
+		ThreadPool& operator=(ThreadPool&& other) = delete;
+
+		unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_Workers.size()); }
+
+		//Runs every task and returns once all of them are done. The calling thread runs tasks too,
+		//so this can be called from inside a task without running out of threads.
+		void Run(const Task* pTasks, unsigned int taskCount)
+		{
+			if (taskCount == 0)
+				return;
+			if (m_Workers.empty())
+			{
+				for (unsigned int i = 0; i < taskCount; ++i)
+					pTasks[i].fpRun(pTasks[i].pContext);
+				return;
+			}
+
+			std::atomic<unsigned int> remaining{ taskCount };
+			const unsigned int ownQueue = GetOwnQueue();
+			m_PendingCount.fetch_add(taskCount, std::memory_order_release); //Before the tasks are queued, so it never drops below the queued count
+			for (unsigned int i = 0; i < taskCount; ++i)
+			{
+				//Spread the batch, the first task stays with the caller
+				Queue& queue = *m_Queues[i == 0 ? ownQueue : (ownQueue + i) % m_Queues.size()];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				queue.tasks.push_back({ pTasks[i], &remaining });
+			}
+			{
+				std::lock_guard<std::mutex> lock(m_SleepMutex);
+			}
+			m_WakeUp.notify_all();
+
+			while (remaining.load(std::memory_order_acquire) > 0)
+			{
+				if (!RunOneTask(ownQueue))
+					std::this_thread::yield(); //The rest is being run by workers
+			}
+		}
+
+	private:
+		struct QueuedTask
+		{
+			Task task;
+			std::atomic<unsigned int>* pRemaining;
+		};
+
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<QueuedTask> tasks;
+		};
+
+		//Workers use their own queue, any other thread shares the last one
+		unsigned int GetOwnQueue() const
+		{
+			const std::thread::id id = std::this_thread::get_id();
+			for (size_t i = 0; i < m_Workers.size(); ++i)
+			{
+				if (m_Workers[i].get_id() == id)
+					return static_cast<unsigned int>(i);
+			}
+			return static_cast<unsigned int>(m_Workers.size());
+		}
+
+		//Newest task of the own queue first, otherwise the oldest one of another queue
+		bool RunOneTask(unsigned int ownQueue)
+		{
+			QueuedTask queuedTask = {};
+			bool isFound = false;
+			for (size_t i = 0; i < m_Queues.size() && !isFound; ++i)
+			{
+				const size_t queueIndex = (ownQueue + i) % m_Queues.size();
+				Queue& queue = *m_Queues[queueIndex];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (queue.tasks.empty())
+					continue;
+
+				if (i == 0)
+				{
+					queuedTask = queue.tasks.back();
+					queue.tasks.pop_back();
+				}
+				else
+				{
+					queuedTask = queue.tasks.front();
+					queue.tasks.pop_front();
+				}
+				isFound = true;
+			}
+			if (!isFound)
+				return false;
+
+			m_PendingCount.fetch_sub(1, std::memory_order_relaxed);
+			queuedTask.task.fpRun(queuedTask.task.pContext);
+			queuedTask.pRemaining->fetch_sub(1, std::memory_order_release);
+			return true;
+		}
+
+		void WorkerLoop(unsigned int workerIndex)
+		{
+			for (;;)
+			{
+				if (RunOneTask(workerIndex))
+					continue;
+
+				std::unique_lock<std::mutex> lock(m_SleepMutex);
+				m_WakeUp.wait(lock, [this]() { return m_IsStopping || m_PendingCount.load(std::memory_order_acquire) > 0; });
+				if (m_IsStopping)
+					return;
+			}
+		}
+
+		std::vector<std::unique_ptr<Queue>> m_Queues;
+		std::vector<std::thread> m_Workers;
+		std::atomic<unsigned int> m_PendingCount{ 0 };
+		std::mutex m_SleepMutex;
+		std::condition_variable m_WakeUp;
+		bool m_IsStopping = false;
+	};
+}
+#endif
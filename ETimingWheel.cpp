@@ -0,0 +1,95 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "ETimingWheel.h"
+#include <cmath>
+
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// TIMING WHEEL
+//-----------------------------------------------------------------
+TimingWheel::TimingWheel(float tickDuration)
+	: m_TickDuration(tickDuration > 0.f ? tickDuration : 1.f / 100.f)
+{
+	for (auto& level : m_Slots)
+	{
+		for (Timer& head : level)
+			head.m_pPrevious = head.m_pNext = &head;
+	}
+}
+
+TimingWheel::~TimingWheel()
+{
+	//Timers may outlive the wheel, they must not point into it anymore
+	for (auto& level : m_Slots)
+	{
+		for (Timer& head : level)
+		{
+			while (head.m_pNext != &head)
+				head.m_pNext->Unlink();
+			head.m_pPrevious = head.m_pNext = nullptr;
+		}
+	}
+}
+
+void TimingWheel::Schedule(Timer& timer, float delay)
+{
+	timer.Unlink();
+	const float ticks = std::ceil(delay / m_TickDuration);
+	const uint64_t maxTicks = (1ULL << (SlotBits * LevelCount)) - 1;
+	const uint64_t delayTicks = ticks < 1.f ? 1 : (ticks < static_cast<float>(maxTicks) ? static_cast<uint64_t>(ticks) : maxTicks);
+	timer.m_ExpiryTick = m_CurrentTick + delayTicks;
+	Insert(timer);
+}
+
+unsigned int TimingWheel::Advance(float deltaTime)
+{
+	unsigned int expiredCount = 0;
+	m_Accumulated += deltaTime;
+	while (m_Accumulated >= m_TickDuration)
+	{
+		m_Accumulated -= m_TickDuration;
+		++m_CurrentTick;
+
+		//Lower the timers of the next slot of every level whose lower level wrapped
+		for (unsigned int level = 1; level < LevelCount; ++level)
+		{
+			if ((m_CurrentTick & ((1ULL << (SlotBits * level)) - 1)) != 0)
+				break;
+			Cascade(level);
+		}
+
+		Timer& head = m_Slots[0][m_CurrentTick & (SlotCount - 1)];
+		while (head.m_pNext != &head)
+		{
+			head.m_pNext->Unlink();
+			++expiredCount;
+		}
+	}
+	return expiredCount;
+}
+
+void TimingWheel::Insert(Timer& timer)
+{
+	const uint64_t delta = timer.m_ExpiryTick - m_CurrentTick;
+	unsigned int level = 0;
+	while (level + 1 < LevelCount && delta >= (1ULL << (SlotBits * (level + 1))))
+		++level;
+
+	Timer& head = m_Slots[level][(timer.m_ExpiryTick >> (SlotBits * level)) & (SlotCount - 1)];
+	timer.m_pPrevious = head.m_pPrevious;
+	timer.m_pNext = &head;
+	head.m_pPrevious->m_pNext = &timer;
+	head.m_pPrevious = &timer;
+}
+
+void TimingWheel::Cascade(unsigned int level)
+{
+	Timer& head = m_Slots[level][(m_CurrentTick >> (SlotBits * level)) & (SlotCount - 1)];
+	while (head.m_pNext != &head)
+	{
+		Timer& timer = *head.m_pNext;
+		timer.Unlink();
+		Insert(timer);
+	}
+}
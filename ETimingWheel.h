@@ -0,0 +1,87 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// ETimingWheel.h: Hierarchical timing wheel for the timers of behavior tree decorators. Timers
+// are linked into the slot of the tick they expire at, a level further up when that is far
+// away, so scheduling, cancelling and advancing a tick cost the same however many timers run.
+/*=============================================================================*/
+#ifndef ELITE_TIMING_WHEEL
+#define ELITE_TIMING_WHEEL
+
+//--- Includes ---
+#include <cstdint>
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// TIMING WHEEL
+	//-----------------------------------------------------------------
+	//Every level has SlotCount slots of SlotCount times the ticks of the level below. Timers in a higher level move down
+	//when the level below wraps, and expire from the lowest one. Expiring only unlinks a timer, its owner checks IsPending.
+	class TimingWheel final
+	{
+	public:
+		static const unsigned int SlotBits = 6;
+		static const unsigned int SlotCount = 1 << SlotBits;
+		static const unsigned int LevelCount = 4; //SlotCount^LevelCount ticks ahead at most, longer delays are clamped
+
+		class Timer final
+		{
+		public:
+			Timer() = default;
+			~Timer()
+			{ Unlink(); }
+
+			Timer(const Timer& other) = delete;
+			Timer& operator=(const Timer& other) = delete;
+
+			bool IsPending() const
+			{ return m_pPrevious != nullptr; }
+
+		private:
+			friend class TimingWheel;
+			void Unlink()
+			{
+				if (m_pPrevious == nullptr)
+					return;
+				m_pPrevious->m_pNext = m_pNext;
+				m_pNext->m_pPrevious = m_pPrevious;
+				m_pPrevious = nullptr;
+				m_pNext = nullptr;
+			}
+
+			Timer* m_pPrevious = nullptr;
+			Timer* m_pNext = nullptr;
+			uint64_t m_ExpiryTick = 0;
+		};
+
+		explicit TimingWheel(float tickDuration = 1.f / 100.f);
+		~TimingWheel();
+
+		TimingWheel(const TimingWheel& other) = delete;
+		TimingWheel& operator=(const TimingWheel& other) = delete;
+
+		//(Re)starts the timer, it expires on the first tick at least 'delay' seconds from now
+		void Schedule(Timer& timer, float delay);
+		static void Cancel(Timer& timer)
+		{ timer.Unlink(); }
+
+		//Moves time forward, returns how many timers expired
+		unsigned int Advance(float deltaTime);
+
+		uint64_t GetTick() const
+		{ return m_CurrentTick; }
+		float GetTickDuration() const
+		{ return m_TickDuration; }
+
+	private:
+		void Insert(Timer& timer);
+		void Cascade(unsigned int level);
+
+		Timer m_Slots[LevelCount][SlotCount] = {}; //Heads of circular lists, linked to themselves when empty
+		uint64_t m_CurrentTick = 0;
+		float m_TickDuration = 0.f;
+		float m_Accumulated = 0.f;
+	};
+}
+#endif
@@ -0,0 +1,276 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EUtilityAI.h"
+#include <cmath>
+
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// RESPONSE CURVES
+//-----------------------------------------------------------------
+float ResponseCurve::Evaluate(float x) const
+{
+	float y = 0.f;
+	switch (type)
+	{
+	case ResponseCurveType::Linear:
+		y = slope * (x - xShift) + yShift;
+		break;
+	case ResponseCurveType::Polynomial:
+		y = slope * std::pow(x - xShift, exponent) + yShift;
+		break;
+	case ResponseCurveType::Logistic:
+		y = slope / (1.f + std::exp(-exponent * (x - xShift))) + yShift;
+		break;
+	}
+
+	if (!(y > 0.f)) //Also NaN, e.g. a fractional exponent of a negative base
+		return 0.f;
+	return y < 1.f ? y : 1.f;
+}
+
+//-----------------------------------------------------------------
+// UTILITY AI
+//-----------------------------------------------------------------
+UtilityAI::UtilityAI(Blackboard* pBlackBoard)
+	: m_pBlackBoard(pBlackBoard)
+{
+	m_pBlackBoard->AddData("ConditionCache", &m_ConditionCache);
+}
+
+unsigned int UtilityAI::AddInput(float(*fpInput)(Blackboard*), float min, float max)
+{
+	m_IsCompiled = false;
+	m_Inputs.push_back({ fpInput, min, max });
+	return static_cast<unsigned int>(m_Inputs.size() - 1);
+}
+
+unsigned int UtilityAI::AddCurve(const ResponseCurve& curve)
+{
+	//Sampled once here, scoring only interpolates between two samples
+	const unsigned int offset = static_cast<unsigned int>(m_CurveTables.size());
+	for (unsigned int i = 0; i < CurveSampleCount; ++i)
+		m_CurveTables.push_back(curve.Evaluate(static_cast<float>(i) / (CurveSampleCount - 1)));
+	m_CurveTables.push_back(m_CurveTables.back());
+	return offset / (CurveSampleCount + 1);
+}
+
+unsigned int UtilityAI::AddAction(const std::string& name, BehaviorState(*fpAction)(Blackboard*), float weight)
+{
+	m_IsCompiled = false;
+	m_Actions.push_back({ name, fpAction, weight });
+	return static_cast<unsigned int>(m_Actions.size() - 1);
+}
+
+void UtilityAI::AddConsideration(unsigned int action, unsigned int input, unsigned int curve)
+{
+	m_IsCompiled = false;
+	m_BuildConsiderations.push_back({ action, input, curve });
+}
+
+bool UtilityAI::Compile()
+{
+	m_IsCompiled = false;
+	const unsigned int curveCount = static_cast<unsigned int>(m_CurveTables.size() / (CurveSampleCount + 1));
+	for (const BuildConsideration& consideration : m_BuildConsiderations)
+	{
+		if (consideration.action >= m_Actions.size() || consideration.input >= m_Inputs.size() || consideration.curve >= curveCount)
+		{
+			printf("WARNING: Utility consideration uses an action, input or curve that doesn't exist \n");
+			return false;
+		}
+	}
+
+	m_ConsiderationCount = static_cast<unsigned int>(m_BuildConsiderations.size());
+	const size_t paddedCount = (m_ConsiderationCount + 3) & ~3u;
+	m_ConsiderationInputs.clear();
+	m_ConsiderationTables.clear();
+	m_ConsiderationMins.assign(paddedCount, 0.f);
+	m_ConsiderationScales.assign(paddedCount, 0.f);
+	m_ActionConsiderations.assign(m_Actions.size() + 1, 0);
+
+	//Grouped by action, each group in the order they were added
+	for (unsigned int action = 0; action < m_Actions.size(); ++action)
+	{
+		m_ActionConsiderations[action] = static_cast<unsigned int>(m_ConsiderationInputs.size());
+		for (const BuildConsideration& consideration : m_BuildConsiderations)
+		{
+			if (consideration.action != action)
+				continue;
+
+			const Input& input = m_Inputs[consideration.input];
+			const size_t i = m_ConsiderationInputs.size();
+			m_ConsiderationInputs.push_back(consideration.input);
+			m_ConsiderationTables.push_back(consideration.curve * (CurveSampleCount + 1));
+			m_ConsiderationMins[i] = input.min;
+			m_ConsiderationScales[i] = input.max > input.min ? (CurveSampleCount - 1) / (input.max - input.min) : 0.f;
+		}
+	}
+	m_ActionConsiderations[m_Actions.size()] = m_ConsiderationCount;
+
+	m_InputValues.assign(m_Inputs.size(), 0.f);
+	m_RawValues.assign(paddedCount, 0.f);
+	m_SamplePositions.assign(paddedCount, 0.f);
+	m_LowSamples.assign(paddedCount, 0.f);
+	m_HighSamples.assign(paddedCount, 0.f);
+	m_ConsiderationScores.assign(paddedCount, 0.f);
+	m_ActionScores.assign(m_Actions.size(), 0.f);
+	m_ChosenAction = InvalidAction;
+	ResetTrace();
+	m_IsCompiled = !m_Actions.empty();
+	return m_IsCompiled;
+}
+
+void UtilityAI::Update(float /*deltaTime*/)
+{
+	if (!m_IsCompiled && !Compile())
+	{
+		m_ActionState = Failure;
+		return;
+	}
+
+	m_ConditionCache.NewTick();
+	for (size_t i = 0; i < m_Inputs.size(); ++i)
+		m_InputValues[i] = m_Inputs[i].fpInput != nullptr ? m_Inputs[i].fpInput(m_pBlackBoard) : 0.f;
+
+	ScoreConsiderations();
+
+	//Compensated product per action, then the best one
+	float bestScore = -1.f;
+	m_ChosenAction = InvalidAction;
+	for (unsigned int action = 0; action < m_Actions.size(); ++action)
+	{
+		const unsigned int first = m_ActionConsiderations[action];
+		const unsigned int count = m_ActionConsiderations[action + 1] - first;
+		float score = 1.f;
+		for (unsigned int i = first; i < first + count; ++i)
+			score *= m_ConsiderationScores[i];
+		if (count > 1)
+		{
+			const float modification = 1.f - 1.f / count;
+			score += (1.f - score) * modification * score;
+		}
+
+		score *= m_Actions[action].weight;
+		m_ActionScores[action] = score;
+		if (score > bestScore)
+		{
+			bestScore = score;
+			m_ChosenAction = action;
+		}
+	}
+
+	const Action& chosen = m_Actions[m_ChosenAction];
+	m_ActionState = chosen.fpAction != nullptr ? chosen.fpAction(m_pBlackBoard) : Failure;
+
+	if (m_TraceCapacity > 0)
+	{
+		const size_t row = m_TracedCount % m_TraceCapacity;
+		m_TraceTicks[row] = m_TickCount;
+		m_TraceChosen[row] = m_ChosenAction;
+		std::copy(m_ActionScores.begin(), m_ActionScores.end(), m_TraceScores.begin() + row * m_ActionScores.size());
+		++m_TracedCount;
+	}
+	++m_TickCount;
+}
+
+//Normalizes every consideration's input to a position in its lookup table and interpolates between the samples
+//around it. The arithmetic runs four considerations at a time, only fetching the samples is done one by one.
+void UtilityAI::ScoreConsiderations()
+{
+	const size_t paddedCount = m_RawValues.size();
+	for (unsigned int i = 0; i < m_ConsiderationCount; ++i)
+		m_RawValues[i] = m_InputValues[m_ConsiderationInputs[i]];
+
+	const float lastSample = static_cast<float>(CurveSampleCount - 1);
+#if ELITE_UTILITY_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 last = _mm_set1_ps(lastSample);
+	for (size_t i = 0; i < paddedCount; i += 4)
+	{
+		__m128 position = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&m_RawValues[i]), _mm_loadu_ps(&m_ConsiderationMins[i])), _mm_loadu_ps(&m_ConsiderationScales[i]));
+		position = _mm_min_ps(_mm_max_ps(position, zero), last); //max first, so NaN ends up at 0
+		_mm_storeu_ps(&m_SamplePositions[i], position);
+	}
+#else
+	for (size_t i = 0; i < paddedCount; ++i)
+	{
+		const float position = (m_RawValues[i] - m_ConsiderationMins[i]) * m_ConsiderationScales[i];
+		m_SamplePositions[i] = position > 0.f ? (position < lastSample ? position : lastSample) : 0.f;
+	}
+#endif
+
+	const float* pTables = m_CurveTables.data();
+	for (unsigned int i = 0; i < m_ConsiderationCount; ++i)
+	{
+		const unsigned int sample = static_cast<unsigned int>(m_SamplePositions[i]);
+		const float* pSamples = pTables + m_ConsiderationTables[i] + sample;
+		m_LowSamples[i] = pSamples[0];
+		m_HighSamples[i] = pSamples[1];
+		m_SamplePositions[i] -= static_cast<float>(sample);
+	}
+
+#if ELITE_UTILITY_SSE
+	for (size_t i = 0; i < paddedCount; i += 4)
+	{
+		const __m128 low = _mm_loadu_ps(&m_LowSamples[i]);
+		const __m128 high = _mm_loadu_ps(&m_HighSamples[i]);
+		_mm_storeu_ps(&m_ConsiderationScores[i], _mm_add_ps(low, _mm_mul_ps(_mm_sub_ps(high, low), _mm_loadu_ps(&m_SamplePositions[i]))));
+	}
+#else
+	for (size_t i = 0; i < paddedCount; ++i)
+		m_ConsiderationScores[i] = m_LowSamples[i] + (m_HighSamples[i] - m_LowSamples[i]) * m_SamplePositions[i];
+#endif
+}
+
+void UtilityAI::SetTraceCapacity(unsigned int tickCount)
+{
+	m_TraceCapacity = tickCount;
+	ResetTrace();
+}
+
+//Rows as wide as the actions there are now, an action added later makes the next Update compile and reset it again
+void UtilityAI::ResetTrace()
+{
+	m_TracedCount = 0;
+	m_TraceTicks.assign(m_TraceCapacity, 0);
+	const unsigned int noAction = InvalidAction; //assign takes a reference, and the constant has no definition to refer to
+	m_TraceChosen.assign(m_TraceCapacity, noAction);
+	m_TraceScores.assign(static_cast<size_t>(m_TraceCapacity) * m_Actions.size(), 0.f);
+}
+
+void UtilityAI::WriteScoreTrace(std::ostream& os) const
+{
+	os << "tick,chosen";
+	for (const Action& action : m_Actions)
+		os << ',' << action.name;
+	os << '\n';
+
+	if (m_TraceCapacity == 0 || !m_IsCompiled) //Rows laid out for other actions until the next Update compiles
+		return;
+
+	const size_t rowSize = m_Actions.size();
+	const unsigned int rowCount = m_TracedCount < m_TraceCapacity ? m_TracedCount : m_TraceCapacity;
+	for (unsigned int traced = m_TracedCount - rowCount; traced < m_TracedCount; ++traced)
+	{
+		const size_t row = traced % m_TraceCapacity;
+		const unsigned int chosen = m_TraceChosen[row];
+		os << m_TraceTicks[row] << ',' << (chosen < m_Actions.size() ? m_Actions[chosen].name : "");
+		for (size_t i = 0; i < rowSize; ++i)
+			os << ',' << m_TraceScores[row * rowSize + i];
+		os << '\n';
+	}
+}
+
+void UtilityAI::WriteConsiderations(std::ostream& os) const
+{
+	if (!m_IsCompiled)
+		return;
+
+	for (unsigned int action = 0; action < m_Actions.size(); ++action)
+	{
+		os << m_Actions[action].name << ": " << m_ActionScores[action] << (action == m_ChosenAction ? " (chosen)" : "") << '\n';
+		for (unsigned int i = m_ActionConsiderations[action]; i < m_ActionConsiderations[action + 1]; ++i)
+			os << "  input " << m_ConsiderationInputs[i] << " = " << m_RawValues[i] << " -> " << m_ConsiderationScores[i] << '\n';
+	}
+}
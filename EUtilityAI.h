@@ -0,0 +1,172 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// EUtilityAI.h: Utility based decision making over the same blackboard and actions as the
+// behavior tree. Every action is scored by its considerations, response curves of blackboard
+// inputs baked into lookup tables, and the best scoring action runs. The considerations of all
+// actions are scored together in one pass: mapping the inputs onto the curves and blending the
+// samples go four at a time with SSE, the table lookups in between are one at a time. A decision
+// costs time linear in the number of considerations.
+/*=============================================================================*/
+#ifndef ELITE_UTILITY_AI
+#define ELITE_UTILITY_AI
+
+//--- Includes ---
+#include "EDecisionMaking.h"
+#include "EBehaviorTree.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ELITE_UTILITY_SSE 1
+#include <emmintrin.h>
+#else
+#define ELITE_UTILITY_SSE 0
+#endif
+
+namespace Elite
+{
+	//-----------------------------------------------------------------
+	// RESPONSE CURVES
+	//-----------------------------------------------------------------
+	enum class ResponseCurveType
+	{
+		Linear, //slope * (x - xShift) + yShift
+		Polynomial, //slope * (x - xShift)^exponent + yShift
+		Logistic //slope / (1 + e^(-exponent * (x - xShift))) + yShift
+	};
+
+	//Maps an input normalized to [0, 1] to a score in [0, 1]
+	struct ResponseCurve final
+	{
+		ResponseCurveType type = ResponseCurveType::Linear;
+		float slope = 1.f;
+		float exponent = 1.f;
+		float xShift = 0.f;
+		float yShift = 0.f;
+
+		float Evaluate(float x) const;
+	};
+
+	//Conditionals as a 0 or 1 input
+	template<bool(*fpConditional)(Blackboard*)>
+	float ConditionInput(Blackboard* pBlackBoard)
+	{ return fpConditional(pBlackBoard) ? 1.f : 0.f; }
+
+	//-----------------------------------------------------------------
+	// UTILITY AI
+	//-----------------------------------------------------------------
+	//Inputs are read from the blackboard once per Update, however many considerations use them. An action's score is
+	//the product of its considerations' scores, compensated for how many there are so actions with more of them aren't
+	//punished for it, times its weight. An action without considerations scores its weight.
+	class UtilityAI final : public Elite::IDecisionMaking
+	{
+	public:
+		static const unsigned int InvalidAction = 0xFFFFFFFF;
+		static const unsigned int CurveSampleCount = 64; //Samples per lookup table, between them the score is interpolated
+
+		explicit UtilityAI(Blackboard* pBlackBoard);
+		~UtilityAI()
+		{
+			delete(m_pBlackBoard); //Takes ownership of passed blackboard!
+			m_pBlackBoard = nullptr;
+		}
+
+		UtilityAI(const UtilityAI& other) = delete;
+		UtilityAI& operator=(const UtilityAI& other) = delete;
+
+		//Building. Inputs are normalized from [min, max] to [0, 1] and clamped.
+		unsigned int AddInput(float(*fpInput)(Blackboard*), float min, float max);
+		unsigned int AddCurve(const ResponseCurve& curve);
+		unsigned int AddAction(const std::string& name, BehaviorState(*fpAction)(Blackboard*), float weight = 1.f);
+		void AddConsideration(unsigned int action, unsigned int input, unsigned int curve);
+		bool Compile();
+
+		virtual void Update(float deltaTime) override;
+		Blackboard* GetBlackboard() const
+		{ return m_pBlackBoard; }
+
+		//Result of the last Update
+		unsigned int GetChosenAction() const
+		{ return m_ChosenAction; }
+		BehaviorState GetActionState() const
+		{ return m_ActionState; }
+		unsigned int GetActionCount() const
+		{ return static_cast<unsigned int>(m_Actions.size()); }
+		const std::string& GetActionName(unsigned int action) const
+		{ return m_Actions[action].name; }
+		float GetActionScore(unsigned int action) const
+		{ return m_ActionScores[action]; }
+
+		//Keeps every action's score of the last 'tickCount' Updates, 0 turns the trace off. The trace is laid out for the
+		//actions when the AI is compiled, compiling again (also after adding an action) starts it over.
+		void SetTraceCapacity(unsigned int tickCount);
+		//One row per traced Update: the tick, every action's score and the chosen action's name
+		void WriteScoreTrace(std::ostream& os) const;
+		//The considerations of every action with their current input and score
+		void WriteConsiderations(std::ostream& os) const;
+
+	private:
+		struct Input
+		{
+			float(*fpInput)(Blackboard*);
+			float min;
+			float max;
+		};
+
+		struct Action
+		{
+			std::string name;
+			BehaviorState(*fpAction)(Blackboard*);
+			float weight;
+		};
+
+		struct BuildConsideration
+		{
+			unsigned int action;
+			unsigned int input;
+			unsigned int curve;
+		};
+
+		void ScoreConsiderations();
+		void ResetTrace();
+
+		Blackboard* m_pBlackBoard = nullptr;
+		BehaviorConditionCache m_ConditionCache = {};
+
+		std::vector<Input> m_Inputs = {};
+		std::vector<Action> m_Actions = {};
+		std::vector<BuildConsideration> m_BuildConsiderations = {};
+		std::vector<float> m_CurveTables = {}; //CurveSampleCount + 1 samples per curve, the last one repeated for the interpolation at 1
+		bool m_IsCompiled = false;
+
+		//Compiled considerations as structure of arrays sorted by action, padded to a multiple of four
+		std::vector<unsigned int> m_ConsiderationInputs = {};
+		std::vector<unsigned int> m_ConsiderationTables = {}; //Offset of the curve's table
+		std::vector<float> m_ConsiderationMins = {};
+		std::vector<float> m_ConsiderationScales = {}; //(CurveSampleCount - 1) / (max - min)
+		std::vector<unsigned int> m_ActionConsiderations = {}; //Action i's considerations are [m_ActionConsiderations[i], m_ActionConsiderations[i + 1])
+		unsigned int m_ConsiderationCount = 0;
+
+		//Per Update
+		std::vector<float> m_InputValues = {};
+		std::vector<float> m_RawValues = {};
+		std::vector<float> m_SamplePositions = {};
+		std::vector<float> m_LowSamples = {};
+		std::vector<float> m_HighSamples = {};
+		std::vector<float> m_ConsiderationScores = {};
+		std::vector<float> m_ActionScores = {};
+		unsigned int m_ChosenAction = InvalidAction;
+		BehaviorState m_ActionState = Failure;
+
+		unsigned int m_TickCount = 0;
+		unsigned int m_TraceCapacity = 0;
+		unsigned int m_TracedCount = 0; //Updates traced since the trace was laid out
+		//Ring buffers of the traced Updates: their tick, chosen action, and a row of every action's score
+		std::vector<unsigned int> m_TraceTicks = {};
+		std::vector<unsigned int> m_TraceChosen = {};
+		std::vector<float> m_TraceScores = {};
+	};
+}
+#endif
@@ -2,10 +2,24 @@
 #include "Plugin.h"
 #include "IExamInterface.h"
 #include "Behaviors.h"
+#include "CombinedSteeringBehaviors.h"
 #include "EBehaviorTree.h"
+#include "EFiniteStateMachine.h"
+#include "EGoapPlanner.h"
+#include "EUtilityAI.h"
 
 using namespace Elite;
 
+//Set to 1 to run the exam tree as one inlined template type (ExamStaticTree in Behaviors.h)
+//instead of the compiled BehaviorTree built below
+#define USE_STATIC_BEHAVIOR_TREE 0
+//Set to 1 to decide with the finite state machine built below, over the same blackboard, conditionals and actions
+#define USE_FINITE_STATE_MACHINE 0
+//Set to 1 to decide with the utility AI built below, scoring the same actions
+#define USE_UTILITY_AI 0
+//Set to 1 to decide with the GOAP planner built below, planning sequences of the same actions towards goals
+#define USE_GOAP_PLANNER 0
+
 //Called only once, during initialization
 void Plugin::Initialize(IBaseInterface* pInterface, PluginInfo& info)
 {
@@ -53,107 +67,149 @@ void Plugin::Initialize(IBaseInterface* pInterface, PluginInfo& info)
 	pB->AddData("Steering", static_cast<ISteeringBehavior**>(&m_pSteeringBehaviour));
 	pB->AddData("Angular", static_cast<ISteeringBehavior**>(&m_pAngularBehaviour));
 
-	// other things
-	pB->AddData("Agent", static_cast<AgentInfo*>(&m_AgentInfo));
+	// perception, stored by value so published snapshots hold a consistent copy
+	pB->AddData("Agent", AgentInfo{});
 
-	pB->AddData("Houses", static_cast<vector<HouseInfo>*>(&m_VHouseInfo));
-	pB->AddData("Entities", static_cast<vector<EntityInfo>*>(&m_VEntityInfo));
+	pB->AddData("Houses", vector<HouseInfo>{});
+	pB->AddData("Entities", vector<EntityInfo>{});
+	pB->AddData("InventoryRevision", 0u);
 
 	pB->AddData("Interface", m_pInterface);
 
 	// empty stuff
-	pB->AddData("ClosestHouse", static_cast<HouseInfo*>(nullptr));
+	pB->AddData("ClosestHouse", static_cast<const HouseInfo*>(nullptr));
 	pB->AddData("ClosestEnemy", static_cast<EnemyInfo*>(nullptr));
 	pB->AddData("ClosestItem", static_cast<ItemInfo*>(nullptr));
 	pB->AddData("ClosestPurgeZone", static_cast<PurgeZoneInfo*>(nullptr));
 
-	// behavior tree
-	BehaviorTree* pBT = new BehaviorTree(pB,
-		new BehaviorSelector(
-			{
-				new BehaviorSequence(
-				{
-					new BehaviorConditional(shouldUseMedkit),
-					new BehaviorAction(UseMedkit)
-				}),
-				new BehaviorSequence(
-				{
-					new BehaviorConditional(shouldUseFood),
-					new BehaviorAction(UseFood)
-				}),
-				new BehaviorSequence(
-				{
-					new BehaviorConditional(InPurgeZone),
-					new BehaviorAction(ChangeToFlee)
-				}),
-				new BehaviorSequence(
-				{
-					new BehaviorConditional(LowStamina),
-					new BehaviorAction(StopRunning)
-				}),
-				new BehaviorSequence(
-				{
-				new BehaviorConditional(AgentBittenHasStamina),
-				new BehaviorAction(RunFlee)
-				}),
-				new BehaviorSequence(
-				{
-					new BehaviorConditional(InventoryFull),
-					new BehaviorSelector(
-					{
-						new BehaviorSequence(
-						{
-							new BehaviorConditional(InGrabRange),
-							new BehaviorAction(GrabItem)
-						}),
-						new BehaviorAction(SeekItems) // add seek to house
-					})
-				}),
-				new BehaviorSequence(
-				{
-					new BehaviorConditional(InsideHouse),
-					new BehaviorSelector(
-					{
-						new BehaviorAction(ScoutWander),
-						new BehaviorSequence(
-						{
-							new BehaviorConditional(ItemInFov),
-							new BehaviorAction(SeekItems)
-						}),
-					})
-				}),
-				new BehaviorSequence(
-				{
-					new BehaviorConditional(EnemyInFOV),
-					new BehaviorSelector(
-					{
-						new BehaviorSequence(
-						{
-							new BehaviorConditional(CanKillEnemy),
-							new BehaviorSelector(
-							{
-								new BehaviorSequence(
-								{
-									new BehaviorConditional(canHitEnemy),
-									new BehaviorAction(ShootClosestEnemy)
-								}),
-								new BehaviorAction(FaceToClosestEnemy)
-							})
-						}),
-						new BehaviorSequence(
-						{
-							new BehaviorConditional(HasStamina),
-							new BehaviorAction(RunFlee)
-						})
-					})
-				}),
-				new BehaviorAction(ScoutWander)
-			})
-	);
-
+	// resolve the keys the behaviors use once, so the tick doesn't look them up by name
+	ResolveBlackboardKeys(pB);
+
+	// behavior tree, the conditionals declare the keys they read and only re-evaluate when one of them changed
+#if USE_STATIC_BEHAVIOR_TREE
+	m_pBlackboard = pB;
+	m_pCurrentDecisionMaking = new ExamStaticTree::Tree(pB);
+#elif USE_FINITE_STATE_MACHINE
+	// the modes of the tree as states, each tick only the guards leaving the current mode are checked
+	FiniteStateMachine* pFSM = new FiniteStateMachine(pB);
+	const unsigned int explore = pFSM->AddState({ ScoutWander });
+	const unsigned int loot = pFSM->AddState({ SeekItems });
+	const unsigned int grab = pFSM->AddState({ GrabItem });
+	const unsigned int fight = pFSM->AddState({ FaceToClosestEnemy });
+	const unsigned int shoot = pFSM->AddState({ FaceToClosestEnemy, ShootClosestEnemy });
+	const unsigned int flee = pFSM->AddState({ RunFlee });
+	const unsigned int fleePurgeZone = pFSM->AddState({ ChangeToFlee });
+	const unsigned int rest = pFSM->AddState({ StopRunning, ScoutWander });
+	const unsigned int heal = pFSM->AddState({ UseMedkit });
+	const unsigned int eat = pFSM->AddState({ UseFood });
+
+	// same priorities as the tree's top selector
+	pFSM->AddAnyStateTransition(heal, { When(shouldUseMedkit) });
+	pFSM->AddAnyStateTransition(eat, { When(shouldUseFood) });
+	pFSM->AddAnyStateTransition(fleePurgeZone, { When(InPurgeZone) });
+	pFSM->AddAnyStateTransition(rest, { When(LowStamina) });
+	pFSM->AddAnyStateTransition(flee, { When(AgentBittenHasStamina) });
+
+	pFSM->AddTransition(explore, fight, { When(EnemyInFOV), When(CanKillEnemy) });
+	pFSM->AddTransition(explore, flee, { When(EnemyInFOV), When(HasStamina) });
+	pFSM->AddTransition(explore, loot, { When(ItemInFov), Unless(InventoryFull) });
+	pFSM->AddTransition(loot, grab, { When(InGrabRange) });
+	pFSM->AddTransition(loot, explore, { Unless(ItemInFov) });
+	pFSM->AddTransition(grab, explore, { Unless(InGrabRange) });
+	pFSM->AddTransition(fight, shoot, { When(canHitEnemy) });
+	pFSM->AddTransition(shoot, fight, {}); // one shot, then aim again, the machine has no cooldowns
+	pFSM->AddTransition(fight, flee, { Unless(CanKillEnemy) });
+	pFSM->AddTransition(fight, explore, { Unless(EnemyInFOV) });
+	pFSM->AddTransition(flee, explore, { Unless(EnemyInFOV), Unless(AgentBittenHasStamina) });
+	pFSM->AddTransition(fleePurgeZone, explore, { Unless(InPurgeZone) });
+	pFSM->AddTransition(rest, explore, { Unless(LowStamina) });
+	pFSM->AddTransition(heal, explore, { Unless(shouldUseMedkit) });
+	pFSM->AddTransition(eat, explore, { Unless(shouldUseFood) });
+	pFSM->Compile();
+
+	m_pBlackboard = pB;
+	m_pCurrentDecisionMaking = pFSM;
+#elif USE_UTILITY_AI
+	// the tree's actions scored by how much they are needed right now, the best one runs
+	UtilityAI* pUtility = new UtilityAI(pB);
+	const unsigned int health = pUtility->AddInput(AgentHealth, 0.f, 10.f);
+	const unsigned int stamina = pUtility->AddInput(AgentStamina, 0.f, 10.f);
+	const unsigned int enemyDistance = pUtility->AddInput(ClosestEnemyDistance, 0.f, 20.f);
+	const unsigned int itemDistance = pUtility->AddInput(ClosestItemDistance, 0.f, 20.f);
+	const unsigned int needsMedkit = pUtility->AddInput(ConditionInput<shouldUseMedkit>, 0.f, 1.f);
+	const unsigned int needsFood = pUtility->AddInput(ConditionInput<shouldUseFood>, 0.f, 1.f);
+	const unsigned int enemyInFov = pUtility->AddInput(ConditionInput<EnemyInFOV>, 0.f, 1.f);
+	const unsigned int itemInFov = pUtility->AddInput(ConditionInput<ItemInFov>, 0.f, 1.f);
+
+	const unsigned int rising = pUtility->AddCurve({ ResponseCurveType::Linear });
+	const unsigned int falling = pUtility->AddCurve({ ResponseCurveType::Linear, -1.f, 1.f, 0.f, 1.f });
+	const unsigned int fallingFast = pUtility->AddCurve({ ResponseCurveType::Polynomial, -1.f, 3.f, 1.f, 0.f }); // (1 - x)^3
+	const unsigned int close = pUtility->AddCurve({ ResponseCurveType::Logistic, 1.f, -10.f, 0.5f, 0.f });
+
+	const unsigned int useMedkit = pUtility->AddAction("UseMedkit", UseMedkit);
+	pUtility->AddConsideration(useMedkit, needsMedkit, rising);
+	pUtility->AddConsideration(useMedkit, health, fallingFast);
+	const unsigned int useFood = pUtility->AddAction("UseFood", UseFood, 0.9f);
+	pUtility->AddConsideration(useFood, needsFood, rising);
+	const unsigned int runFlee = pUtility->AddAction("RunFlee", RunFlee);
+	pUtility->AddConsideration(runFlee, enemyInFov, rising);
+	pUtility->AddConsideration(runFlee, enemyDistance, close);
+	pUtility->AddConsideration(runFlee, stamina, rising);
+	const unsigned int seekItems = pUtility->AddAction("SeekItems", SeekItems, 0.8f);
+	pUtility->AddConsideration(seekItems, itemInFov, rising);
+	pUtility->AddConsideration(seekItems, itemDistance, falling);
+	pUtility->AddAction("ScoutWander", ScoutWander, 0.2f); // always an option
+	pUtility->Compile();
+	pUtility->SetTraceCapacity(600);
+
+	m_pBlackboard = pB;
+	m_pCurrentDecisionMaking = pUtility;
+#elif USE_GOAP_PLANNER
+	// the tree's conditionals as facts and its actions with what they need and do, plans are searched per goal
+	GoapPlanner* pGoap = new GoapPlanner(pB);
+	const unsigned int inPurgeZone = pGoap->AddFact(InPurgeZone);
+	const unsigned int needsMedkit = pGoap->AddFact(shouldUseMedkit);
+	const unsigned int needsFood = pGoap->AddFact(shouldUseFood);
+	const unsigned int enemyInFov = pGoap->AddFact(EnemyInFOV);
+	const unsigned int hasStamina = pGoap->AddFact(HasStamina);
+	const unsigned int canKillEnemy = pGoap->AddFact(CanKillEnemy);
+	const unsigned int itemInFov = pGoap->AddFact(ItemInFov);
+	const unsigned int inGrabRange = pGoap->AddFact(InGrabRange);
+	const unsigned int inventoryFull = pGoap->AddFact(InventoryFull);
+
+	pGoap->AddAction("ChangeToFlee", ChangeToFlee, 1.f, { { inPurgeZone, true } }, { { inPurgeZone, false } });
+	pGoap->AddAction("UseMedkit", UseMedkit, 1.f, { { needsMedkit, true } }, { { needsMedkit, false } });
+	pGoap->AddAction("UseFood", UseFood, 1.f, { { needsFood, true } }, { { needsFood, false } });
+	pGoap->AddAction("ShootClosestEnemy", ShootClosestEnemy, 1.f, { { enemyInFov, true }, { canKillEnemy, true } }, { { enemyInFov, false } });
+	pGoap->AddAction("RunFlee", RunFlee, 2.f, { { enemyInFov, true }, { hasStamina, true } }, { { enemyInFov, false } });
+	pGoap->AddAction("SeekItems", SeekItems, 1.f, { { itemInFov, true } }, { { inGrabRange, true } });
+	pGoap->AddAction("GrabItem", GrabItem, 1.f, { { inGrabRange, true } }, { { inventoryFull, true } });
+	pGoap->AddAction("ScoutWander", ScoutWander, 5.f, {}, { { itemInFov, true } });
+
+	// same priorities as the tree's top selector
+	pGoap->AddGoal("EscapePurgeZone", { { inPurgeZone, false } });
+	pGoap->AddGoal("Heal", { { needsMedkit, false } });
+	pGoap->AddGoal("Eat", { { needsFood, false } });
+	pGoap->AddGoal("EscapeEnemy", { { enemyInFov, false } });
+	pGoap->AddGoal("Loot", { { inventoryFull, true } });
+	pGoap->SetIdleAction(ScoutWander);
+	pGoap->Compile();
+
+	m_pBlackboard = pB;
+	m_pCurrentDecisionMaking = pGoap;
+#else
+	BehaviorTree* pBT = new BehaviorTree(pB, CreateExamBehavior());
+
+	// not compiled: on this tree the flat array ticks slower than walking the nodes (Tests/ExamBehaviorTreeBenchmark.cpp)
+	pBT->SetDecisionInterval(1.f / 20.f); // decisions hold for a while, the selected steering keeps running in between
+
+	m_pBlackboard = pB;
 	m_pCurrentDecisionMaking = pBT;
+#endif
 	m_pSteeringBehaviour = m_pWander;
 	m_pAngularBehaviour = m_pScout;
+
+	m_PerfCounters.Open();
 }
 
 //Called only once
@@ -222,23 +278,83 @@ void Plugin::Update(float dt)
 	{
 		m_CanRun = false;
 	}
+	else if (m_pInterface->Input_IsKeyboardKeyUp(Elite::eScancode_B))
+	{
+		//Shows which blackboard keys the behaviors keep missing
+		m_pBlackboard->DumpAccessCounters(std::cout);
+		//and with the utility AI, every action's score over the last ticks, e.g. to plot in a spreadsheet
+		if (const Elite::UtilityAI* pUtility = dynamic_cast<const Elite::UtilityAI*>(m_pCurrentDecisionMaking))
+		{
+			std::ofstream trace("UtilityScoreTrace.csv");
+			pUtility->WriteScoreTrace(trace);
+		}
+	}
+#if ELITE_BT_PROFILER
+	else if (m_pInterface->Input_IsKeyboardKeyUp(Elite::eScancode_P))
+	{
+		//Per node timings of the tree so far, open the trace in chrome://tracing
+		if (Elite::BehaviorTree* pBT = dynamic_cast<Elite::BehaviorTree*>(m_pCurrentDecisionMaking))
+		{
+			pBT->GetProfiler().ExportCSV("BehaviorTreeProfile.csv");
+			pBT->GetProfiler().ExportChromeTrace("BehaviorTreeTrace.json");
+		}
+	}
+#endif
+}
+
+//Perception compare, to tell the blackboard only about what actually changed
+static bool IsSamePerception(const vector<HouseInfo>& vHouses, const vector<HouseInfo>& vOtherHouses)
+{
+	return std::equal(vHouses.begin(), vHouses.end(), vOtherHouses.begin(), vOtherHouses.end(),
+		[](const HouseInfo& house, const HouseInfo& other) { return house.Center == other.Center && house.Size == other.Size; });
+}
+
+static bool IsSamePerception(const vector<EntityInfo>& vEntities, const vector<EntityInfo>& vOtherEntities)
+{
+	return std::equal(vEntities.begin(), vEntities.end(), vOtherEntities.begin(), vOtherEntities.end(),
+		[](const EntityInfo& entity, const EntityInfo& other)
+		{ return entity.EntityHash == other.EntityHash && entity.Type == other.Type && entity.Location == other.Location; });
 }
 
 //Update
 //This function calculates the new SteeringOutput, called once per frame
 SteeringPlugin_Output Plugin::UpdateSteering(float dt)
 {
+	m_PerfCounters.BeginPhase(PerceptionPhase);
+
 	//Use the Interface (IAssignmentInterface) to 'interface' with the AI_Framework
 	m_AgentInfo = m_pInterface->Agent_GetInfo();
 
 	//auto nextTargetPos = m_Target; //To start you can use the mouse position as guidance
 
-	m_VHouseInfo = GetHousesInFOV();//uses m_pInterface->Fov_GetHouseByIndex(...)
-	m_VEntityInfo = GetEntitiesInFOV(); //uses m_pInterface->Fov_GetEntityByIndex(...)
-
+	GetHousesInFOV(m_VHouseInfo);//uses m_pInterface->Fov_GetHouseByIndex(...)
+	GetEntitiesInFOV(m_VEntityInfo); //uses m_pInterface->Fov_GetEntityByIndex(...)
+
+	// only write what changed, the conditionals observing the rest keep their last result
+	m_pBlackboard->TryChangeData(BlackboardKeys::Agent, m_AgentInfo);
+	const vector<HouseInfo>* pVHouseInfo = m_pBlackboard->TryGetDataPtr(BlackboardKeys::Houses);
+	if (pVHouseInfo == nullptr || !IsSamePerception(*pVHouseInfo, m_VHouseInfo))
+		m_pBlackboard->TryChangeData(BlackboardKeys::Houses, m_VHouseInfo);
+	const vector<EntityInfo>* pVEntityInfo = m_pBlackboard->TryGetDataPtr(BlackboardKeys::Entities);
+	if (pVEntityInfo == nullptr || !IsSamePerception(*pVEntityInfo, m_VEntityInfo))
+		m_pBlackboard->TryChangeData(BlackboardKeys::Entities, m_VEntityInfo);
+	if (m_PublishBlackboard)
+		m_pBlackboard->Publish(); //tick boundary, readers on other threads see this perception from now on
+	m_PerfCounters.EndPhase(PerceptionPhase);
+
+	m_PerfCounters.BeginPhase(DecisionPhase);
 	m_pCurrentDecisionMaking->Update(dt);
-	m_Steering.LinearVelocity = m_pSteeringBehaviour->CalculateSteering(dt, &m_AgentInfo).LinearVelocity;
-	m_Steering.AngularVelocity = m_pAngularBehaviour->CalculateSteering(dt, &m_AgentInfo).AngularVelocity;
+	m_PerfCounters.EndPhase(DecisionPhase);
+
+	m_PerfCounters.BeginPhase(SteeringPhase);
+	m_pBlackboard->TryGetData(BlackboardKeys::Agent, m_AgentInfo); //actions can change the run mode
+	m_Steering.AutoOrient = true; //Setting AutoOrientate to TRue overrides the AngularVelocity
+
+	// only calculate the channels that are used, with AutoOrient the angular one isn't
+	const unsigned int consumedChannels = m_Steering.AutoOrient ? ISteeringBehavior::LinearChannel : ISteeringBehavior::AllChannels;
+	m_SteeringEvaluationCount = CalculateChannelSteering(dt, &m_AgentInfo, m_pSteeringBehaviour, m_pAngularBehaviour, consumedChannels, m_Steering);
+	m_PerfCounters.EndPhase(SteeringPhase);
+	m_PerfCounters.EndTick(std::cout);
 
 	for (auto& e : m_VEntityInfo)
 	{
@@ -265,6 +381,7 @@ SteeringPlugin_Output Plugin::UpdateSteering(float dt)
 			//Once grabbed, you can add it to a specific inventory slot
 			//Slot must be empty
 			m_pInterface->Inventory_AddItem(0, item);
+			InvalidateInventoryConditions(m_pBlackboard);
 		}
 	}
 
@@ -272,12 +389,14 @@ SteeringPlugin_Output Plugin::UpdateSteering(float dt)
 	{
 		//Use an item (make sure there is an item at the given inventory slot)
 		m_pInterface->Inventory_UseItem(0);
+		InvalidateInventoryConditions(m_pBlackboard);
 	}
 
 	if (m_RemoveItem)
 	{
 		//Remove an item from a inventory slot
 		m_pInterface->Inventory_RemoveItem(0);
+		InvalidateInventoryConditions(m_pBlackboard);
 	}
 
 	////Simple Seek Behaviour (towards Target)
@@ -291,7 +410,6 @@ SteeringPlugin_Output Plugin::UpdateSteering(float dt)
 	//}
 
 	//steering.AngularVelocity = m_AngSpeed; //Rotate your character to inspect the world while walking
-	m_Steering.AutoOrient = true; //Setting AutoOrientate to TRue overrides the AngularVelocity
 
 	m_Steering.RunMode = m_CanRun; //If RunMode is True > MaxLinSpd is increased for a limited time (till your stamina runs out)
 
@@ -312,9 +430,9 @@ void Plugin::Render(float dt) const
 	m_pInterface->Draw_SolidCircle(m_Target, .7f, { 0,0 }, { 1, 0, 0 });
 }
 
-vector<HouseInfo> Plugin::GetHousesInFOV() const
+void Plugin::GetHousesInFOV(vector<HouseInfo>& vHousesInFOV) const
 {
-	vector<HouseInfo> vHousesInFOV = {};
+	vHousesInFOV.clear();
 
 	HouseInfo hi = {};
 	for (int i = 0;; ++i)
@@ -327,13 +445,11 @@ vector<HouseInfo> Plugin::GetHousesInFOV() const
 
 		break;
 	}
-
-	return vHousesInFOV;
 }
 
-vector<EntityInfo> Plugin::GetEntitiesInFOV() const
+void Plugin::GetEntitiesInFOV(vector<EntityInfo>& vEntitiesInFOV) const
 {
-	vector<EntityInfo> vEntitiesInFOV = {};
+	vEntitiesInFOV.clear();
 
 	EntityInfo ei = {};
 	for (int i = 0;; ++i)
@@ -346,6 +462,4 @@ vector<EntityInfo> Plugin::GetEntitiesInFOV() const
 
 		break;
 	}
-
-	return vEntitiesInFOV;
 }
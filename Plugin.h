@@ -4,6 +4,7 @@
 #include "EBlackboard.h"
 #include "EDecisionMaking.h"
 #include "SteeringBehaviors.h"
+#include "EPerformanceCounters.h"
 
 class ISteeringBehavior;
 class IBaseInterface;
@@ -25,11 +26,14 @@ public:
 	SteeringPlugin_Output UpdateSteering(float dt) override;
 	void Render(float dt) const override;
 
+	//Steering behaviors calculated by the last UpdateSteering, the channels nothing reads are skipped
+	unsigned int GetSteeringEvaluationCount() const { return m_SteeringEvaluationCount; }
+
 private:
 	//Interface, used to request data from/perform actions with the AI Framework
 	IExamInterface* m_pInterface = nullptr;
-	vector<HouseInfo> GetHousesInFOV() const;
-	vector<EntityInfo> GetEntitiesInFOV() const;
+	void GetHousesInFOV(vector<HouseInfo>& vHousesInFOV) const;
+	void GetEntitiesInFOV(vector<EntityInfo>& vEntitiesInFOV) const;
 	std::vector<HouseInfo> m_VHouseInfo;
 	std::vector<EntityInfo> m_VEntityInfo;
 
@@ -56,7 +60,14 @@ private:
 
 	ISteeringBehavior* m_pSteeringBehaviour = nullptr;
 	ISteeringBehavior* m_pAngularBehaviour = nullptr;
+	unsigned int m_SteeringEvaluationCount = 0; //Behaviors calculated by the last UpdateSteering
+	Elite::Blackboard* m_pBlackboard = nullptr; //Owned by the decision making
+	bool m_PublishBlackboard = false; //Set when something reads blackboard snapshots from another thread
 	Elite::IDecisionMaking* m_pCurrentDecisionMaking = nullptr;
+
+	// hardware counters per phase of UpdateSteering, only when built with ELITE_PERF_COUNTERS on Linux
+	enum ePerfPhase { PerceptionPhase, DecisionPhase, SteeringPhase };
+	Elite::PerfPhaseCounters m_PerfCounters{ { "perception", "decision", "steering" }, 600 };
 };
 
 
@@ -3,6 +3,163 @@
 
 //Includes
 #include "SteeringBehaviors.h"
+#include "EFastMath.h"
+#include <cfloat>
+
+#if defined(__AVX2__)
+#define ELITE_STEERING_AVX2 1
+#include <immintrin.h>
+#else
+#define ELITE_STEERING_AVX2 0
+#endif
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ELITE_STEERING_SSE 1
+#include <emmintrin.h>
+#else
+#define ELITE_STEERING_SSE 0
+#endif
+
+//BATCH HELPERS
+//*************
+//The batch kernels are written once against these lanes: one agent, four agents with SSE or eight with AVX2.
+//A mask keeps a value where it's set and zeroes it elsewhere.
+namespace
+{
+	struct ScalarLanes
+	{
+		using Value = float;
+		using Mask = bool;
+		static const size_t Width = 1;
+
+		static Value Load(const float* p) { return *p; }
+		static void Store(float* p, Value v) { *p = v; }
+		static Value Set(float f) { return f; }
+		static Value Add(Value a, Value b) { return a + b; }
+		static Value Sub(Value a, Value b) { return a - b; }
+		static Value Mul(Value a, Value b) { return a * b; }
+		static Value Div(Value a, Value b) { return a / b; }
+		static Value Sqrt(Value a) { return sqrtf(a); }
+		static Mask Greater(Value a, Value b) { return a > b; }
+		static Mask LessEqual(Value a, Value b) { return a <= b; }
+		static Value Keep(Mask mask, Value v) { return mask ? v : 0.f; }
+	};
+
+#if ELITE_STEERING_SSE
+	struct SseLanes
+	{
+		using Value = __m128;
+		using Mask = __m128;
+		static const size_t Width = 4;
+
+		static Value Load(const float* p) { return _mm_loadu_ps(p); }
+		static void Store(float* p, Value v) { _mm_storeu_ps(p, v); }
+		static Value Set(float f) { return _mm_set1_ps(f); }
+		static Value Add(Value a, Value b) { return _mm_add_ps(a, b); }
+		static Value Sub(Value a, Value b) { return _mm_sub_ps(a, b); }
+		static Value Mul(Value a, Value b) { return _mm_mul_ps(a, b); }
+		static Value Div(Value a, Value b) { return _mm_div_ps(a, b); }
+		static Value Sqrt(Value a) { return _mm_sqrt_ps(a); }
+		static Mask Greater(Value a, Value b) { return _mm_cmpgt_ps(a, b); }
+		static Mask LessEqual(Value a, Value b) { return _mm_cmple_ps(a, b); }
+		static Value Keep(Mask mask, Value v) { return _mm_and_ps(mask, v); }
+	};
+#endif
+
+#if ELITE_STEERING_AVX2
+	struct Avx2Lanes
+	{
+		using Value = __m256;
+		using Mask = __m256;
+		static const size_t Width = 8;
+
+		static Value Load(const float* p) { return _mm256_loadu_ps(p); }
+		static void Store(float* p, Value v) { _mm256_storeu_ps(p, v); }
+		static Value Set(float f) { return _mm256_set1_ps(f); }
+		static Value Add(Value a, Value b) { return _mm256_add_ps(a, b); }
+		static Value Sub(Value a, Value b) { return _mm256_sub_ps(a, b); }
+		static Value Mul(Value a, Value b) { return _mm256_mul_ps(a, b); }
+		static Value Div(Value a, Value b) { return _mm256_div_ps(a, b); }
+		static Value Sqrt(Value a) { return _mm256_sqrt_ps(a); }
+		static Mask Greater(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static Mask LessEqual(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		static Value Keep(Mask mask, Value v) { return _mm256_and_ps(mask, v); }
+	};
+#endif
+
+	//Runs the kernel over the whole batch, the widest lanes first and what's left one agent at a time
+	template<typename TKernel>
+	void RunSteeringBatch(const SteeringBatch& batch, const TKernel& kernel)
+	{
+		size_t i = 0;
+#if ELITE_STEERING_AVX2
+		for (; i + Avx2Lanes::Width <= batch.count; i += Avx2Lanes::Width)
+			kernel.template Run<Avx2Lanes>(batch, i);
+#endif
+#if ELITE_STEERING_SSE
+		for (; i + SseLanes::Width <= batch.count; i += SseLanes::Width)
+			kernel.template Run<SseLanes>(batch, i);
+#endif
+		for (; i < batch.count; ++i)
+			kernel.template Run<ScalarLanes>(batch, i);
+	}
+
+	//Writes (x, y) normalized and scaled, zero where it's too short to normalize like Vector2::Normalize
+	template<typename L>
+	void StoreScaledDirection(const SteeringBatch& batch, size_t i, typename L::Value x, typename L::Value y, typename L::Value length, typename L::Value scale)
+	{
+		const typename L::Value factor = L::Keep(L::Greater(length, L::Set(FLT_EPSILON)), L::Div(scale, length));
+		L::Store(batch.pLinearVelocityX + i, L::Mul(x, factor));
+		L::Store(batch.pLinearVelocityY + i, L::Mul(y, factor));
+	}
+
+	//Seek, Flee (sign -1) and Arrive (slowdown radius > 0)
+	struct SeekKernel
+	{
+		float sign;
+		float slowdownRadius;
+
+		template<typename L> void Run(const SteeringBatch& batch, size_t i) const
+		{
+			const typename L::Value x = L::Sub(L::Load(batch.pTargetX + i), L::Load(batch.pPositionX + i));
+			const typename L::Value y = L::Sub(L::Load(batch.pTargetY + i), L::Load(batch.pPositionY + i));
+			const typename L::Value length = L::Sqrt(L::Add(L::Mul(x, x), L::Mul(y, y)));
+			typename L::Value scale = L::Mul(L::Load(batch.pMaxSpeed + i), L::Set(sign));
+			if (slowdownRadius > 0.f)
+				scale = L::Mul(scale, L::Div(length, L::Set(slowdownRadius)));
+			StoreScaledDirection<L>(batch, i, x, y, length, scale);
+		}
+	};
+
+	//Pursuit and Evade (sign -1, only within the evade radius)
+	struct PursuitKernel
+	{
+		float sign;
+		float evadeRadius;
+
+		template<typename L> void Run(const SteeringBatch& batch, size_t i) const
+		{
+			const typename L::Value positionX = L::Load(batch.pPositionX + i);
+			const typename L::Value positionY = L::Load(batch.pPositionY + i);
+			const typename L::Value targetX = L::Load(batch.pTargetX + i);
+			const typename L::Value targetY = L::Load(batch.pTargetY + i);
+			const typename L::Value maxSpeed = L::Load(batch.pMaxSpeed + i);
+
+			//The further away, the further ahead the target is aimed at
+			const typename L::Value toTargetX = L::Sub(targetX, positionX);
+			const typename L::Value toTargetY = L::Sub(targetY, positionY);
+			const typename L::Value distance = L::Sqrt(L::Add(L::Mul(toTargetX, toTargetX), L::Mul(toTargetY, toTargetY)));
+			const typename L::Value pursuitRate = L::Div(distance, maxSpeed);
+			const typename L::Value x = L::Sub(L::Add(targetX, L::Mul(L::Load(batch.pTargetVelocityX + i), pursuitRate)), positionX);
+			const typename L::Value y = L::Sub(L::Add(targetY, L::Mul(L::Load(batch.pTargetVelocityY + i), pursuitRate)), positionY);
+			const typename L::Value length = L::Sqrt(L::Add(L::Mul(x, x), L::Mul(y, y)));
+
+			typename L::Value scale = L::Mul(maxSpeed, L::Set(sign));
+			if (evadeRadius >= 0.f)
+				scale = L::Keep(L::LessEqual(distance, L::Set(evadeRadius)), scale);
+			StoreScaledDirection<L>(batch, i, x, y, length, scale);
+		}
+	};
+}
 
 //SEEK
 //****
@@ -17,6 +174,11 @@ SteeringPlugin_Output Seek::CalculateSteering(float deltaT, AgentInfo* pAgent)
 	return steering;
 }
 
+void Seek::CalculateSteeringBatch(const SteeringBatch& batch) const
+{
+	RunSteeringBatch(batch, SeekKernel{ 1.f, 0.f });
+}
+
 //FLEE (base> SEEK)
 //****
 SteeringPlugin_Output Flee::CalculateSteering(float deltaT, AgentInfo* pAgent)
@@ -28,6 +190,11 @@ SteeringPlugin_Output Flee::CalculateSteering(float deltaT, AgentInfo* pAgent)
 	return steering;
 }
 
+void Flee::CalculateSteeringBatch(const SteeringBatch& batch) const
+{
+	RunSteeringBatch(batch, SeekKernel{ -1.f, 0.f });
+}
+
 //ARRIVE (base> SEEK)
 //******
 SteeringPlugin_Output Arrive::CalculateSteering(float deltaT, AgentInfo* pAgent)
@@ -40,6 +207,11 @@ SteeringPlugin_Output Arrive::CalculateSteering(float deltaT, AgentInfo* pAgent)
 	return steering;
 }
 
+void Arrive::CalculateSteeringBatch(const SteeringBatch& batch) const
+{
+	RunSteeringBatch(batch, SeekKernel{ 1.f, m_SlowdownRadius });
+}
+
 //FACE
 //****
 SteeringPlugin_Output Face::CalculateSteering(float deltaT, AgentInfo* pAgent)
@@ -48,7 +220,11 @@ SteeringPlugin_Output Face::CalculateSteering(float deltaT, AgentInfo* pAgent)
 
 	// calc the angle to face the target
 	const Elite::Vector2 targetVector = m_TargetPos - pAgent->Position;
+#if ELITE_FAST_TRIG
+	float angle = Elite::FastAtan2(targetVector.y, targetVector.x) - pAgent->Orientation;
+#else
 	float angle = atan2(targetVector.y, targetVector.x) - pAgent->Orientation;
+#endif
 	angle = Elite::ToDegrees(angle);
 	angle += 90.f;
 
@@ -63,7 +239,12 @@ SteeringPlugin_Output Wander::CalculateSteering(float deltaT, AgentInfo* pAgent)
 {
 	SteeringPlugin_Output steering = {};
 
+#if ELITE_FAST_TRIG
+	Elite::Vector2 Agentdirection{};
+	Elite::FastSinCos(pAgent->Orientation - b2_pi / 2.f, Agentdirection.y, Agentdirection.x);
+#else
 	Elite::Vector2 Agentdirection{ cos(pAgent->Orientation - b2_pi / 2.f), sin(pAgent->Orientation - b2_pi / 2.f) };
+#endif
 	m_WanderingCirPos = { pAgent->Position + (Agentdirection * (m_WanderCirRad + 1.f)) };
 
 	if (m_ChangeTime <= m_PassedTime)
@@ -71,8 +252,15 @@ SteeringPlugin_Output Wander::CalculateSteering(float deltaT, AgentInfo* pAgent)
 		m_LastFocusPointAngle = m_FocusPointAngle;
 		m_FocusPointAngle = ((Elite::randomFloat(m_WanderAngle)) - (m_WanderAngle / 2.f)) + m_LastFocusPointAngle;
 
+#if ELITE_FAST_TRIG
+		float focusSin = 0.f, focusCos = 0.f;
+		Elite::FastSinCos(m_FocusPointAngle, focusSin, focusCos);
+		m_FocusPoint = { (m_WanderCirRad * focusCos) + m_WanderingCirPos.x ,
+						(m_WanderCirRad * focusSin) + m_WanderingCirPos.y };
+#else
 		m_FocusPoint = { (m_WanderCirRad * cos(m_FocusPointAngle)) + m_WanderingCirPos.x ,
 						(m_WanderCirRad * sin(m_FocusPointAngle)) + m_WanderingCirPos.y };
+#endif
 		m_PassedTime = 0;
 	}
 	else
@@ -107,6 +295,11 @@ SteeringPlugin_Output Pursuit::CalculateSteering(float deltaT, AgentInfo* pAgent
 	return steering;
 }
 
+void Pursuit::CalculateSteeringBatch(const SteeringBatch& batch) const
+{
+	RunSteeringBatch(batch, PursuitKernel{ 1.f, -1.f });
+}
+
 //EVADE
 //*****
 SteeringPlugin_Output Evade::CalculateSteering(float deltaT, AgentInfo* pAgent)
@@ -122,6 +315,11 @@ SteeringPlugin_Output Evade::CalculateSteering(float deltaT, AgentInfo* pAgent)
 	return steering;
 }
 
+void Evade::CalculateSteeringBatch(const SteeringBatch& batch) const
+{
+	RunSteeringBatch(batch, PursuitKernel{ -1.f, m_EvadeRadius });
+}
+
 //SCOUT
 //*****
 SteeringPlugin_Output Scout::CalculateSteering(float deltaT, AgentInfo* pAgent)
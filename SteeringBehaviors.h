@@ -23,10 +23,29 @@ public:
 
 	virtual SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) = 0;
 
+	//Output channels a behavior writes, the rest of its output is always zero
+	enum Channel : unsigned int
+	{
+		LinearChannel = 1 << 0,
+		AngularChannel = 1 << 1,
+		AllChannels = LinearChannel | AngularChannel
+	};
+	virtual unsigned int GetOutputChannels() const { return AllChannels; }
+	//Whether calculating it is of any use to a caller that only reads 'channels'
+	bool ProducesAny(unsigned int channels) const { return (GetOutputChannels() & channels) != 0; }
+
 	//Seek Functions
 	void SetTargetPos(const Elite::Vector2& target) { m_TargetPos = target; }
+	const Elite::Vector2& GetTargetPos() const { return m_TargetPos; }
 	void SetTargetLinVel(Elite::Vector2 target) { m_TargetLinVel = target; }
 
+	//An output is usable when it steers by more than 'threshold', linearly or angularly.
+	//Behaviors that have nothing to do return an empty output, e.g. Evade outside its evade radius.
+	static bool IsValidSteering(const SteeringPlugin_Output& steering, float threshold)
+	{
+		return steering.LinearVelocity.MagnitudeSquared() > threshold * threshold || fabsf(steering.AngularVelocity) > threshold;
+	}
+
 	template<class T, typename std::enable_if<std::is_base_of<ISteeringBehavior, T>::value>::type* = nullptr>
 	T* As()
 	{
@@ -39,6 +58,25 @@ protected:
 };
 #pragma endregion
 
+#pragma region **STEERINGBATCH**
+//Many agents as structure of arrays, for the batch versions of the linear behaviors. They read the targets from here
+//instead of from the behavior and only write the linear velocities, four or eight agents at a time with SSE or AVX2.
+//Target velocities are only read by Pursuit and Evade.
+struct SteeringBatch
+{
+	const float* pPositionX = nullptr;
+	const float* pPositionY = nullptr;
+	const float* pTargetX = nullptr;
+	const float* pTargetY = nullptr;
+	const float* pTargetVelocityX = nullptr;
+	const float* pTargetVelocityY = nullptr;
+	const float* pMaxSpeed = nullptr;
+	float* pLinearVelocityX = nullptr;
+	float* pLinearVelocityY = nullptr;
+	size_t count = 0;
+};
+#pragma endregion
+
 ///////////////////////////////////////
 //SEEK
 //****
@@ -50,6 +88,8 @@ public:
 
 	//Seek Behaviour
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	void CalculateSteeringBatch(const SteeringBatch& batch) const;
+	unsigned int GetOutputChannels() const override { return LinearChannel; }
 };
 
 ///////////////////////////////////////
@@ -63,6 +103,7 @@ public:
 
 	//Seek Behavior
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	void CalculateSteeringBatch(const SteeringBatch& batch) const;
 };
 
 ///////////////////////////////////////
@@ -76,6 +117,7 @@ public:
 
 	//Seek Behavior
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	void CalculateSteeringBatch(const SteeringBatch& batch) const;
 
 	void SetSlowRadius(float slowRadius) { m_SlowdownRadius = slowRadius; };
 private:
@@ -93,6 +135,7 @@ public:
 
 	//Seek Behavior
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	unsigned int GetOutputChannels() const override { return AngularChannel; }
 };
 
 ///////////////////////////////////////
@@ -106,6 +149,7 @@ public:
 
 	//Seek Behavior
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	unsigned int GetOutputChannels() const override { return LinearChannel; }
 private:
 	float m_ChangeTime = 1.f;
 	float m_PassedTime = 0.f;
@@ -128,6 +172,8 @@ public:
 
 	//Seek Behavior
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	void CalculateSteeringBatch(const SteeringBatch& batch) const;
+	unsigned int GetOutputChannels() const override { return LinearChannel; }
 
 	void SetSlowRadius(float slowRadius) { m_SlowdownRadius = slowRadius; };
 private:
@@ -145,6 +191,7 @@ public:
 
 	//Seek Behavior
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	void CalculateSteeringBatch(const SteeringBatch& batch) const;
 
 	void SetEvadeRadius(float evadeRadius) { m_EvadeRadius = evadeRadius; };
 
@@ -163,6 +210,7 @@ public:
 
 	//Seek Behavior
 	SteeringPlugin_Output CalculateSteering(float deltaT, AgentInfo* pAgent) override;
+	unsigned int GetOutputChannels() const override { return AngularChannel; }
 
 	void SetEvadeRadius(float evadeRadius) { m_EvadeRadius = evadeRadius; };
 
@@ -0,0 +1,67 @@
+//Decision cost per agent of ExamBatchTree against a compiled BehaviorTree per agent running the same nodes,
+//for growing numbers of agents. Filling the batch's arrays from the perception is timed on its own.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BatchBehaviorTreeBenchmark.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp ../SteeringBehaviors.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BatchBehaviorTreeBenchmark.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp ../SteeringBehaviors.cpp
+//Needs the plugin's include paths, the behaviors are built on its precompiled header and the exam interface.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include <memory>
+#include "ExamAgentWorld.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const size_t TotalDecisions = 1 << 20; //Per measurement, spread over the agents
+
+	void Measure(size_t agentCount)
+	{
+		std::unique_ptr<Test::ExamAgent[]> pAgents(new Test::ExamAgent[agentCount]);
+		std::vector<Test::ExamPerception> perceptions(agentCount);
+		std::mt19937 random(11);
+		ExamBatchTree::Agents batch;
+		for (size_t i = 0; i < agentCount; ++i)
+		{
+			Test::CreateExamAgentTree(pAgents[i]);
+			Test::RandomizePerception(random, perceptions[i]);
+			Test::Perceive(pAgents[i], perceptions[i]);
+			batch.AddAgent(perceptions[i].agent, perceptions[i].entities, perceptions[i].fleeTarget);
+		}
+		ExamBatchTree::Tree batchTree;
+		ExamBatchTree::Build(batchTree);
+
+		const unsigned int tickCount = static_cast<unsigned int>((std::max)(TotalDecisions / agentCount, static_cast<size_t>(1)));
+		const double treesSeconds = Test::MeasureSeconds(tickCount, [&](unsigned int)
+			{
+				for (size_t i = 0; i < agentCount; ++i)
+					pAgents[i].pTree->Update(1.f / 60.f);
+			});
+		const double batchSeconds = Test::MeasureSeconds(tickCount, [&](unsigned int)
+			{
+				batchTree.Update(batch, agentCount);
+			});
+		const double fillSeconds = Test::MeasureSeconds(tickCount, [&](unsigned int)
+			{
+				batch.ClearInputs();
+				for (size_t i = 0; i < agentCount; ++i)
+					batch.AddAgent(perceptions[i].agent, perceptions[i].entities, perceptions[i].fleeTarget);
+			});
+
+		const double nsPerAgent = 1e9 / agentCount;
+		printf("%-8zu %14.1f %14.1f %14.1f %9.2fx \n", agentCount, treesSeconds * nsPerAgent, batchSeconds * nsPerAgent,
+			fillSeconds * nsPerAgent, treesSeconds / batchSeconds);
+		Test::KeepAlive(batch.Steering[0]);
+	}
+}
+
+int main()
+{
+	printf("ns per agent and tick \n");
+	printf("%-8s %14s %14s %14s %10s \n", "agents", "tree per agent", "batch tree", "batch inputs", "speedup");
+	for (size_t agentCount : { 1u, 64u, 1024u, 16384u })
+		Measure(agentCount);
+	return Test::Finish("BatchBehaviorTreeBenchmark");
+}
@@ -0,0 +1,87 @@
+//ExamBatchTree against the same nodes run by a BehaviorTree per agent: on random perceptions every agent
+//has to end up with the same steering, target and run mode either way.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BatchBehaviorTreeTest.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp ../SteeringBehaviors.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BatchBehaviorTreeTest.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp ../SteeringBehaviors.cpp
+//Needs the plugin's include paths, the behaviors are built on its precompiled header and the exam interface.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include <memory>
+#include "ExamAgentWorld.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const size_t AgentCount = 1000;
+	const unsigned int TickCount = 50;
+
+	//Steering the agent's tree selected, as the batch tree records it
+	ExamBatchTree::eSteering GetSelectedSteering(const Test::ExamAgent& agent)
+	{
+		if (agent.pSteering == &agent.flee)
+			return ExamBatchTree::eSteering::Flee;
+		if (agent.pSteering == &agent.seek)
+			return ExamBatchTree::eSteering::Seek;
+		return ExamBatchTree::eSteering::Wander;
+	}
+}
+
+int main()
+{
+	std::unique_ptr<Test::ExamAgent[]> pAgents(new Test::ExamAgent[AgentCount]);
+	for (size_t i = 0; i < AgentCount; ++i)
+		Test::CreateExamAgentTree(pAgents[i]);
+
+	ExamBatchTree::Agents batch;
+	ExamBatchTree::Tree batchTree;
+	ExamBatchTree::Build(batchTree);
+
+	std::mt19937 random(7);
+	Test::ExamPerception perception;
+	unsigned int mismatchCount = 0;
+	unsigned int decisionCounts[3] = {};
+	for (unsigned int tick = 0; tick < TickCount; ++tick)
+	{
+		batch.ClearInputs();
+		for (size_t i = 0; i < AgentCount; ++i)
+		{
+			Test::RandomizePerception(random, perception);
+			//The game runs as the last decision asked
+			perception.agent.RunMode = tick > 0 && batch.RunMode[i] != 0;
+			Test::Perceive(pAgents[i], perception);
+			pAgents[i].pTree->Update(1.f / 60.f);
+			batch.AddAgent(perception.agent, perception.entities, perception.fleeTarget);
+		}
+		batchTree.Update(batch, AgentCount);
+
+		for (size_t i = 0; i < AgentCount; ++i)
+		{
+			const Test::ExamAgent& agent = pAgents[i];
+			const ExamBatchTree::eSteering steering = GetSelectedSteering(agent);
+			const AgentInfo* pAgentInfo = agent.pTree->GetBlackboard()->TryGetDataPtr(BlackboardKeys::Agent);
+
+			bool isSame = steering == batch.Steering[i] && pAgentInfo->RunMode == (batch.RunMode[i] != 0);
+			if (steering != ExamBatchTree::eSteering::Wander)
+			{
+				const Vector2& target = agent.pSteering->GetTargetPos();
+				isSame = isSame && target.x == batch.TargetX[i] && target.y == batch.TargetY[i];
+			}
+			if (!isSame)
+			{
+				if (mismatchCount == 0)
+					printf("First mismatch: tick %u, agent %zu \n", tick, i);
+				++mismatchCount;
+			}
+			++decisionCounts[static_cast<int>(steering)];
+		}
+	}
+
+	ELITE_CHECK(mismatchCount == 0);
+	//Every branch was taken
+	ELITE_CHECK(decisionCounts[0] > 0 && decisionCounts[1] > 0 && decisionCounts[2] > 0);
+	printf("%zu agents, %u ticks: %u wander, %u flee, %u seek \n", AgentCount, TickCount, decisionCounts[0], decisionCounts[1], decisionCounts[2]);
+	return Test::Finish("BatchBehaviorTreeTest");
+}
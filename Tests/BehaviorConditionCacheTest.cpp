@@ -0,0 +1,128 @@
+//BehaviorConditionCache in the trees that own one: a check several conditionals share through a tag is done once per
+//Update, the others get the result it had, and the next Update does it again, so it sees what changed in between.
+//An action invalidating the tag has the next conditional do the check again within the same Update.
+//Pointer, compiled and static (EStaticBehaviorTree.h) trees alike.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BehaviorConditionCacheTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BehaviorConditionCacheTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the tree is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include "EBehaviorTree.h"
+#include "EStaticBehaviorTree.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int ThreatTag = 0;
+
+	bool g_IsThreatNear = false;
+	unsigned int g_CheckCount = 0; //Times the shared check was done
+	unsigned int g_FleeCount = 0;
+	unsigned int g_WanderCount = 0;
+
+	bool IsThreatNearCached(Blackboard* pBlackboard)
+	{
+		BehaviorConditionCache* pCache = nullptr;
+		pBlackboard->TryGetData("ConditionCache", pCache);
+		return pCache->Evaluate(ThreatTag, []()
+			{
+				++g_CheckCount;
+				return g_IsThreatNear;
+			});
+	}
+	bool IsSafe(Blackboard* pBlackboard) { return !IsThreatNearCached(pBlackboard); }
+
+	BehaviorState Flee(Blackboard*) { ++g_FleeCount; return Success; }
+	BehaviorState Wander(Blackboard*) { ++g_WanderCount; return Success; }
+	//Changes what the check looks at, as the exam's inventory actions do
+	BehaviorState ScareAway(Blackboard* pBlackboard)
+	{
+		g_IsThreatNear = true;
+		BehaviorConditionCache* pCache = nullptr;
+		pBlackboard->TryGetData("ConditionCache", pCache);
+		pCache->Invalidate(ThreatTag);
+		return Success;
+	}
+
+	//Both branches check for the threat, only the first one per Update does it
+	BehaviorTree* CreateTree(bool isCompiled)
+	{
+		BehaviorTree* pTree = new BehaviorTree(new Blackboard(), new BehaviorSelector(
+			{
+				new BehaviorSequence({ new BehaviorConditional(IsThreatNearCached), new BehaviorAction(Flee) }),
+				new BehaviorSequence({ new BehaviorConditional(IsSafe), new BehaviorAction(Wander) })
+			}));
+		if (isCompiled)
+			pTree->Compile();
+		return pTree;
+	}
+
+	//Wanders while safe, scares the threat off and checks again: the invalidated check is done twice in that Update
+	BehaviorTree* CreateInvalidatingTree(bool isCompiled)
+	{
+		BehaviorTree* pTree = new BehaviorTree(new Blackboard(), new BehaviorSequence(
+			{
+				new BehaviorConditional(IsSafe), new BehaviorAction(ScareAway), new BehaviorConditional(IsThreatNearCached), new BehaviorAction(Flee)
+			}));
+		if (isCompiled)
+			pTree->Compile();
+		return pTree;
+	}
+
+	namespace StaticTree
+	{
+		using namespace StaticBT;
+		using Root = Selector<
+			Sequence<Cond<IsThreatNearCached>, Act<Flee>>,
+			Sequence<Cond<IsSafe>, Act<Wander>>>;
+		using InvalidatingRoot = Sequence<Cond<IsSafe>, Act<ScareAway>, Cond<IsThreatNearCached>, Act<Flee>>;
+	}
+
+	template<typename TTree> void TestOncePerTick(TTree* pTree)
+	{
+		g_IsThreatNear = false;
+		g_CheckCount = 0;
+		g_FleeCount = 0;
+		g_WanderCount = 0;
+
+		for (unsigned int tick = 0; tick < 5; ++tick)
+			pTree->Update(1.f / 60.f);
+		ELITE_CHECK(g_CheckCount == 5 && g_WanderCount == 5 && g_FleeCount == 0);
+
+		//Changed between Updates: the next one checks again and sees it
+		g_IsThreatNear = true;
+		pTree->Update(1.f / 60.f);
+		ELITE_CHECK(g_CheckCount == 6 && g_FleeCount == 1 && g_WanderCount == 5);
+
+		BehaviorConditionCache* pCache = nullptr;
+		ELITE_CHECK(pTree->GetBlackboard()->TryGetData("ConditionCache", pCache));
+		ELITE_CHECK(pCache->GetEvaluationCount() == 6 && pCache->GetHitCount() == 5);
+		delete pTree;
+	}
+
+	template<typename TTree> void TestInvalidate(TTree* pTree)
+	{
+		g_IsThreatNear = false;
+		g_CheckCount = 0;
+		g_FleeCount = 0;
+
+		pTree->Update(1.f / 60.f);
+		ELITE_CHECK(g_CheckCount == 2 && g_FleeCount == 1);
+		delete pTree;
+	}
+}
+
+int main()
+{
+	TestOncePerTick(CreateTree(false));
+	TestOncePerTick(CreateTree(true));
+	TestOncePerTick(new StaticBT::Tree<StaticTree::Root>(new Blackboard()));
+	TestInvalidate(CreateInvalidatingTree(false));
+	TestInvalidate(CreateInvalidatingTree(true));
+	TestInvalidate(new StaticBT::Tree<StaticTree::InvalidatingRoot>(new Blackboard()));
+	return Test::Finish("BehaviorConditionCacheTest");
+}
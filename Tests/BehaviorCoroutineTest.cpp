@@ -0,0 +1,92 @@
+//BehaviorCoroutine in a BehaviorTree: a running coroutine action continues where it was while the tree keeps
+//ticking it, and is aborted, its frame given back to the pool, as soon as a higher priority branch takes over.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BehaviorCoroutineTest.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BehaviorCoroutineTest.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the tree is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include "EBehaviorCoroutine.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	bool g_IsThreatened = false;
+	unsigned int g_StartCount = 0; //Times the coroutine action was started
+	unsigned int g_Step = 0; //Steps the current run of it got through
+
+	bool IsThreatened(Blackboard*) { return g_IsThreatened; }
+	BehaviorState Escape(Blackboard*) { return Success; }
+
+	//Takes three ticks
+	BehaviorTask Loot(Blackboard*)
+	{
+		++g_StartCount;
+		for (g_Step = 1; g_Step < 3; ++g_Step)
+			co_await NextTick{};
+		co_return Success;
+	}
+
+	BehaviorTree* CreateTree(bool isCompiled)
+	{
+		BehaviorTree* pTree = new BehaviorTree(new Blackboard(),
+			new BehaviorSelector(
+				{
+					new BehaviorSequence({ new BehaviorConditional(IsThreatened), new BehaviorAction(Escape) }),
+					new BehaviorCoroutine(Loot)
+				}));
+		if (isCompiled)
+			pTree->Compile();
+		return pTree;
+	}
+
+	void TestPreemption(bool isCompiled)
+	{
+		BehaviorTree* pTree = CreateTree(isCompiled);
+		g_IsThreatened = false;
+		g_StartCount = 0;
+		const unsigned int usedBlocks = CoroutineFramePool::GetUsedBlockCount();
+
+		//Continues where it was while it is ticked
+		pTree->Update(0.1f);
+		pTree->Update(0.1f);
+		ELITE_CHECK(g_StartCount == 1 && g_Step == 2);
+		ELITE_CHECK(CoroutineFramePool::GetUsedBlockCount() == usedBlocks + 1);
+
+		//Preempted: aborted, the frame is back in the pool right away
+		g_IsThreatened = true;
+		pTree->Update(0.1f);
+		ELITE_CHECK(CoroutineFramePool::GetUsedBlockCount() == usedBlocks);
+
+		//Reached again: starts over instead of finishing the stale run
+		g_IsThreatened = false;
+		pTree->Update(0.1f);
+		ELITE_CHECK(g_StartCount == 2 && g_Step == 1);
+		pTree->Update(0.1f);
+		pTree->Update(0.1f);
+		ELITE_CHECK(g_StartCount == 2 && g_Step == 3);
+		ELITE_CHECK(CoroutineFramePool::GetUsedBlockCount() == usedBlocks);
+
+		//Skipped decisions don't count as preemption
+		pTree->SetDecisionInterval(1.f, 1.f);
+		pTree->Update(1.f);
+		ELITE_CHECK(g_StartCount == 3 && g_Step == 1);
+		pTree->Update(0.5f);
+		ELITE_CHECK(g_Step == 1 && CoroutineFramePool::GetUsedBlockCount() == usedBlocks + 1);
+		pTree->Update(0.5f);
+		ELITE_CHECK(g_StartCount == 3 && g_Step == 2);
+
+		delete pTree;
+		ELITE_CHECK(CoroutineFramePool::GetUsedBlockCount() == usedBlocks);
+	}
+}
+
+int main()
+{
+	TestPreemption(false);
+	TestPreemption(true);
+	return Test::Finish("BehaviorCoroutineTest");
+}
@@ -0,0 +1,155 @@
+//TimingWheel timers expiring on exactly the tick they were scheduled for, also the ones that start in a higher level
+//and cascade down, and the timed decorators on the tree's wheel: a cooldown that keeps its child from running until
+//it expired, also when that takes more ticks than the lower levels hold, a timeout that fails a child running too
+//long, and a rate limit that lets its child run so many times per window. Pointer, compiled and compiled resuming
+//the running path trees run them on the same ticks.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BehaviorDecoratorTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BehaviorDecoratorTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the tree is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "EBehaviorTree.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const float TickDuration = 1.f / 100.f; //The tree's wheel, every Update of it is one tick
+
+	unsigned int g_Tick = 0; //Update the tree is in, from 1
+	std::vector<unsigned int> g_Runs; //Ticks the decorated action ran in
+
+	BehaviorState SucceedAction(Blackboard*) { g_Runs.push_back(g_Tick); return Success; }
+	BehaviorState RunningAction(Blackboard*) { g_Runs.push_back(g_Tick); return Running; }
+	BehaviorState IdleAction(Blackboard*) { return Success; }
+
+	//Timers scheduled from 'startTick' on, every one of them has to expire on its own tick and no other
+	void TestWheelExpiry(uint64_t startTick, const std::vector<uint64_t>& delays)
+	{
+		TimingWheel wheel(1.f);
+		wheel.Advance(static_cast<float>(startTick));
+		ELITE_CHECK(wheel.GetTick() == startTick);
+
+		std::vector<TimingWheel::Timer> timers(delays.size());
+		uint64_t lastExpiry = 0;
+		for (size_t i = 0; i < delays.size(); ++i)
+		{
+			wheel.Schedule(timers[i], static_cast<float>(delays[i]));
+			lastExpiry = (std::max)(lastExpiry, startTick + delays[i]);
+		}
+
+		unsigned int mismatchCount = 0;
+		while (wheel.GetTick() < lastExpiry)
+		{
+			const unsigned int expiredCount = wheel.Advance(1.f);
+			unsigned int expectedCount = 0;
+			for (size_t i = 0; i < delays.size(); ++i)
+			{
+				const bool isDue = wheel.GetTick() >= startTick + delays[i];
+				expectedCount += wheel.GetTick() == startTick + delays[i] ? 1 : 0;
+				if (timers[i].IsPending() == isDue)
+					++mismatchCount;
+			}
+			if (expiredCount != expectedCount)
+				++mismatchCount;
+		}
+		ELITE_CHECK(mismatchCount == 0);
+	}
+
+	void TestWheel()
+	{
+		//Around the span of every level: 64 ticks, 4096 and 262144
+		const std::vector<uint64_t> delays = { 1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097, 8191, 262143, 262144, 262145 };
+		TestWheelExpiry(0, delays);
+		//Not lined up with any slot, the lower levels wrap at other times than the delays
+		TestWheelExpiry(37, delays);
+		TestWheelExpiry(4000, delays);
+
+		//Delays past what the wheel holds are clamped to the last tick it does
+		TimingWheel wheel(1.f);
+		TimingWheel::Timer timer;
+		wheel.Schedule(timer, 1e9f);
+		const float maxTicks = static_cast<float>((1u << (TimingWheel::SlotBits * TimingWheel::LevelCount)) - 1);
+		wheel.Advance(maxTicks - 1.f);
+		ELITE_CHECK(timer.IsPending());
+		ELITE_CHECK(wheel.Advance(1.f) == 1);
+		ELITE_CHECK(!timer.IsPending());
+
+		//Rescheduling moves a timer, cancelling unlinks it
+		wheel.Schedule(timer, 10.f);
+		wheel.Schedule(timer, 100.f);
+		ELITE_CHECK(wheel.Advance(99.f) == 0 && timer.IsPending());
+		ELITE_CHECK(wheel.Advance(1.f) == 1);
+		wheel.Schedule(timer, 5.f);
+		TimingWheel::Cancel(timer);
+		ELITE_CHECK(!timer.IsPending() && wheel.Advance(10.f) == 0);
+	}
+
+	//The decorator first in a selector with an idle action after it, that takes over whenever the decorator fails
+	BehaviorTree* CreateTree(IBehavior* pDecorator, unsigned int mode)
+	{
+		BehaviorTree* pTree = new BehaviorTree(new Blackboard(), new BehaviorSelector({ pDecorator, new BehaviorAction(IdleAction) }));
+		if (mode > 0)
+			pTree->Compile();
+		pTree->SetResumeRunningPath(mode == 2);
+		return pTree;
+	}
+
+	std::vector<unsigned int> RunTree(BehaviorTree* pTree, unsigned int tickCount)
+	{
+		g_Runs.clear();
+		for (g_Tick = 1; g_Tick <= tickCount; ++g_Tick)
+			pTree->Update(TickDuration);
+		delete pTree;
+		return g_Runs;
+	}
+
+	//Succeeding at tick 1 starts the cooldown, it expires on the tick 'cooldown' later
+	void TestCooldown(unsigned int mode)
+	{
+		const std::vector<unsigned int> runs = RunTree(CreateTree(new BehaviorCooldown(new BehaviorAction(SucceedAction), 0.5f), mode), 120);
+		ELITE_CHECK(runs == std::vector<unsigned int>({ 1, 51, 101 }));
+
+		//Longer than the lowest two levels hold, the timer cascades down twice
+		const std::vector<unsigned int> longRuns = RunTree(CreateTree(new BehaviorCooldown(new BehaviorAction(SucceedAction), 50.f), mode), 5001);
+		ELITE_CHECK(longRuns == std::vector<unsigned int>({ 1, 5001 }));
+	}
+
+	//The child keeps running, the timeout fails it at tick 21 and the next tick starts a fresh one
+	void TestTimeout(unsigned int mode)
+	{
+		const std::vector<unsigned int> runs = RunTree(CreateTree(new BehaviorTimeout(new BehaviorAction(RunningAction), 0.2f), mode), 45);
+		std::vector<unsigned int> expected = {};
+		for (unsigned int tick = 1; tick <= 45; ++tick)
+		{
+			if (tick != 21 && tick != 42)
+				expected.push_back(tick);
+		}
+		ELITE_CHECK(runs == expected);
+	}
+
+	//Three runs in every window of ten ticks, the window starts at the first run after the last one ended
+	void TestRateLimit(unsigned int mode)
+	{
+		const std::vector<unsigned int> runs = RunTree(CreateTree(new BehaviorRateLimit(new BehaviorAction(SucceedAction), 3, 0.1f), mode), 25);
+		ELITE_CHECK(runs == std::vector<unsigned int>({ 1, 2, 3, 11, 12, 13, 21, 22, 23 }));
+	}
+}
+
+int main()
+{
+	TestWheel();
+	//Pointer tree, compiled, compiled resuming the running path
+	for (unsigned int mode = 0; mode < 3; ++mode)
+	{
+		TestCooldown(mode);
+		TestTimeout(mode);
+		TestRateLimit(mode);
+	}
+	return Test::Finish("BehaviorDecoratorTest");
+}
@@ -0,0 +1,92 @@
+//A BehaviorConditional observing blackboard keys (ObserveKeys) is evaluated on the first tick and then only again on
+//ticks after one of its keys was written or reported changed with NotifyChanged, in between it returns the result it
+//had. Writes to keys it doesn't observe don't make it evaluate. Pointer and compiled trees alike.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BehaviorObservingConditionalTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BehaviorObservingConditionalTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the tree is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include "EBehaviorTree.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	unsigned int g_EvaluationCount = 0;
+	unsigned int g_ActionCount = 0;
+
+	//Reads the observed key only, as an observing conditional has to
+	bool IsHungry(Blackboard* pBlackboard)
+	{
+		++g_EvaluationCount;
+		float food = 0.f;
+		pBlackboard->TryGetData("Food", food);
+		return food < 5.f;
+	}
+
+	BehaviorState Eat(Blackboard*)
+	{
+		++g_ActionCount;
+		return Success;
+	}
+
+	void TestObserving(bool isCompiled)
+	{
+		g_EvaluationCount = 0;
+		g_ActionCount = 0;
+
+		Blackboard* pBlackboard = new Blackboard();
+		pBlackboard->AddData("Food", 1.f);
+		pBlackboard->AddData("Position", 0.f);
+		const BlackboardKey<float> food = pBlackboard->GetKey<float>("Food");
+		BehaviorTree tree(pBlackboard, new BehaviorSequence(
+			{
+				new BehaviorConditional(IsHungry, ObserveKeys(food)),
+				new BehaviorAction(Eat)
+			}));
+		if (isCompiled)
+			tree.Compile();
+		ELITE_CHECK(tree.IsCompiled() == isCompiled);
+
+		//Evaluated once, the result it remembered holds on the next ticks
+		for (unsigned int tick = 0; tick < 3; ++tick)
+			tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_EvaluationCount == 1 && g_ActionCount == 3);
+
+		//A key it doesn't observe changing doesn't matter
+		pBlackboard->TryChangeData("Position", 4.f);
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_EvaluationCount == 1 && g_ActionCount == 4);
+
+		//Its key written: evaluated again, once, the new result holds
+		pBlackboard->TryChangeData(food, 8.f);
+		tree.Update(1.f / 60.f);
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_EvaluationCount == 2 && g_ActionCount == 4);
+
+		//Also for a write of the same value, the blackboard doesn't compare
+		pBlackboard->TryChangeData(food, 8.f);
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_EvaluationCount == 3 && g_ActionCount == 4);
+
+		//Reported changed, as data behind a stored pointer is, evaluated again
+		pBlackboard->NotifyChanged(food);
+		tree.Update(1.f / 60.f);
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_EvaluationCount == 4 && g_ActionCount == 4);
+
+		pBlackboard->TryChangeData(food, 2.f);
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_EvaluationCount == 5 && g_ActionCount == 5);
+	}
+}
+
+int main()
+{
+	TestObserving(false);
+	TestObserving(true);
+	return Test::Finish("BehaviorObservingConditionalTest");
+}
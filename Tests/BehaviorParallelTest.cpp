@@ -0,0 +1,180 @@
+//BehaviorParallel on a thread pool against the same parallel without one: pure children writing the same blackboard
+//entries end every tick with the same blackboard and state either way, each having read what the tick started with.
+//Children that aren't pure, an action writing outside the blackboard or a timed decorator, keep the parallel off the
+//pool, they run one after the other on the updating thread.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BehaviorParallelTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BehaviorParallelTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the tree is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EBehaviorTree.h"
+#include "EThreadPool.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int ChildCount = 8;
+	const unsigned int TickCount = 500;
+
+	std::thread::id g_UpdatingThread = {};
+	unsigned int g_OffThreadRunCount = 0; //Impure actions that ran on another thread than the one updating
+
+	//Child i writes "Value" from what it read, and a key of its own. Every child writes "Value", the last one's write
+	//is the one that stays.
+	template<unsigned int Child> BehaviorState MixValue(Blackboard* pBlackboard)
+	{
+		unsigned int value = 0;
+		pBlackboard->TryGetData("Value", value);
+		//Some work, so the children overlap on the pool
+		for (unsigned int i = 0; i < 200; ++i)
+			value = value * 1664525u + 1013904223u + Child;
+		pBlackboard->TryChangeData("Value", value);
+		pBlackboard->TryChangeData("Child" + std::to_string(Child), value);
+		return value % 4 == 0 ? Failure : (value % 4 == 1 ? Running : Success);
+	}
+
+	template<unsigned int Child> bool IsInputBitSet(Blackboard* pBlackboard)
+	{
+		unsigned int input = 0;
+		pBlackboard->TryGetData("Input", input);
+		return ((input >> (Child % 4)) & 1) != 0;
+	}
+
+	//The parallel's state, 'Running' unless one of these ran after it
+	template<BehaviorState State> BehaviorState RecordState(Blackboard* pBlackboard)
+	{
+		pBlackboard->TryChangeData("State", static_cast<unsigned int>(State));
+		return State;
+	}
+
+	BehaviorState WriteOutside(Blackboard*)
+	{
+		if (std::this_thread::get_id() != g_UpdatingThread)
+			++g_OffThreadRunCount;
+		return Success;
+	}
+
+	template<unsigned int... Children> std::vector<IBehavior*> CreateChildren(std::integer_sequence<unsigned int, Children...>)
+	{
+		return { new BehaviorSequence({ new BehaviorConditional(IsInputBitSet<Children>), new BehaviorAction(MixValue<Children>, true) })... };
+	}
+
+	BehaviorTree* CreateTree(ThreadPool* pThreadPool, ParallelPolicy successPolicy)
+	{
+		Blackboard* pBlackboard = new Blackboard();
+		pBlackboard->AddData("Input", 0u);
+		pBlackboard->AddData("Value", 1u);
+		for (unsigned int i = 0; i < ChildCount; ++i)
+			pBlackboard->AddData("Child" + std::to_string(i), 0u);
+		pBlackboard->AddData("State", static_cast<unsigned int>(Running));
+		BehaviorParallel* pParallel = new BehaviorParallel(
+			CreateChildren(std::make_integer_sequence<unsigned int, ChildCount>{}), pThreadPool, successPolicy, ParallelPolicy::RequireAll);
+		return new BehaviorTree(pBlackboard, new BehaviorSelector(
+			{
+				new BehaviorSequence({ pParallel, new BehaviorAction(RecordState<Success>) }),
+				new BehaviorAction(RecordState<Failure>)
+			}));
+	}
+
+	//Everything the children write, and the parallel's state
+	std::vector<unsigned int> GetOutcome(BehaviorTree* pTree)
+	{
+		std::vector<unsigned int> outcome = {};
+		unsigned int value = 0;
+		pTree->GetBlackboard()->TryGetData("Value", value);
+		outcome.push_back(value);
+		for (unsigned int i = 0; i < ChildCount; ++i)
+		{
+			pTree->GetBlackboard()->TryGetData("Child" + std::to_string(i), value);
+			outcome.push_back(value);
+		}
+		pTree->GetBlackboard()->TryGetData("State", value);
+		pTree->GetBlackboard()->TryChangeData("State", static_cast<unsigned int>(Running));
+		outcome.push_back(value);
+		return outcome;
+	}
+
+	void TestPoolMatchesSerial(ThreadPool& pool, ParallelPolicy successPolicy)
+	{
+		BehaviorTree* pPoolTree = CreateTree(&pool, successPolicy);
+		BehaviorTree* pSerialTree = CreateTree(nullptr, successPolicy);
+
+		unsigned int mismatchCount = 0;
+		for (unsigned int tick = 0; tick < TickCount; ++tick)
+		{
+			pPoolTree->GetBlackboard()->TryChangeData("Input", tick * 7u);
+			pSerialTree->GetBlackboard()->TryChangeData("Input", tick * 7u);
+			pPoolTree->Update(1.f / 60.f);
+			pSerialTree->Update(1.f / 60.f);
+			if (GetOutcome(pPoolTree) != GetOutcome(pSerialTree))
+				++mismatchCount;
+		}
+		ELITE_CHECK(mismatchCount == 0);
+		delete pPoolTree;
+		delete pSerialTree;
+	}
+
+	//Every child reads the value the tick started with, not one another's writes
+	void TestChildrenReadTickStart(ThreadPool& pool)
+	{
+		BehaviorTree* pTree = CreateTree(&pool, ParallelPolicy::RequireAll);
+		pTree->GetBlackboard()->TryChangeData("Input", 0xFu); //Every child's conditional holds
+		pTree->Update(1.f / 60.f);
+
+		unsigned int lastValue = 0;
+		for (unsigned int i = 0; i < ChildCount; ++i)
+		{
+			unsigned int childValue = 0;
+			pTree->GetBlackboard()->TryGetData("Child" + std::to_string(i), childValue);
+			//Redo child i's mix from the start value
+			unsigned int value = 1;
+			for (unsigned int j = 0; j < 200; ++j)
+				value = value * 1664525u + 1013904223u + i;
+			ELITE_CHECK(childValue == value);
+			lastValue = value;
+		}
+		unsigned int value = 0;
+		ELITE_CHECK(pTree->GetBlackboard()->TryGetData("Value", value) && value == lastValue);
+		delete pTree;
+	}
+
+	void TestImpureChildren(ThreadPool& pool)
+	{
+		//Pure: conditionals, actions declared so, composites and untimed decorators of them
+		ELITE_CHECK(BehaviorConditional(IsInputBitSet<0>).IsPure());
+		ELITE_CHECK(BehaviorAction(MixValue<0>, true).IsPure());
+		ELITE_CHECK(!BehaviorAction(WriteOutside).IsPure());
+		ELITE_CHECK(BehaviorInverter(new BehaviorAction(MixValue<0>, true)).IsPure());
+		ELITE_CHECK(!BehaviorCooldown(new BehaviorAction(MixValue<0>, true), 1.f).IsPure());
+		ELITE_CHECK(!BehaviorSequence({ new BehaviorConditional(IsInputBitSet<0>), new BehaviorAction(WriteOutside) }).IsPure());
+
+		//The parallel warns and runs them on this thread, also the pure ones next to them
+		std::vector<IBehavior*> children = {};
+		for (unsigned int i = 0; i < ChildCount; ++i)
+			children.push_back(new BehaviorAction(WriteOutside));
+		children.push_back(new BehaviorCooldown(new BehaviorAction(WriteOutside, true), 0.1f));
+		BehaviorTree* pTree = new BehaviorTree(new Blackboard(), new BehaviorParallel(children, &pool));
+		for (unsigned int tick = 0; tick < 100; ++tick)
+			pTree->Update(1.f / 60.f);
+		ELITE_CHECK(g_OffThreadRunCount == 0);
+		delete pTree;
+	}
+}
+
+int main()
+{
+	g_UpdatingThread = std::this_thread::get_id();
+	ThreadPool pool(4);
+	TestPoolMatchesSerial(pool, ParallelPolicy::RequireAll);
+	TestPoolMatchesSerial(pool, ParallelPolicy::RequireOne);
+	TestChildrenReadTickStart(pool);
+	TestImpureChildren(pool);
+	return Test::Finish("BehaviorParallelTest");
+}
@@ -0,0 +1,128 @@
+//A compiled BehaviorTree with a budget against the same tree without one, on random trees: a decision suspended
+//when the budget runs out has to continue at the node it stopped before, so over the Updates it takes it runs the same
+//leaves in the same order with the same results as the unbudgeted tree does in one. The budget is counted in leaves,
+//which suspends on the same nodes every run, unlike a time.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BehaviorTimeBudgetTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BehaviorTimeBudgetTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the tree is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include <vector>
+#include "EBehaviorTree.h"
+#include "RandomBehaviorTree.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int TreeCount = 300;
+	const unsigned int TickCount = 64;
+	const unsigned int InputInterval = 5; //Ticks between changes of the observed input
+
+	unsigned int g_SuspendCount = 0;
+	unsigned int g_OverBudgetCount = 0; //Updates that ran more leaves than the budget
+
+	//Runs a tree for all ticks, the leaves it ran are appended to 'trace' with a marker after every finished decision.
+	//A suspended decision is continued within the same tick, those Updates don't advance the tree's time.
+	void RunTree(BehaviorTree& tree, unsigned int seed, unsigned int leafBudget, std::vector<unsigned int>& trace)
+	{
+		Test::RandomTreeScript& script = Test::GetRandomTreeScript();
+		script.seed = seed;
+		script.pTrace = &trace;
+		for (unsigned int tick = 0; tick < TickCount; ++tick)
+		{
+			script.tick = tick;
+			if (tick % InputInterval == 0)
+				tree.GetBlackboard()->TryChangeData(Test::GetRandomTreeInputName(), tick / InputInterval);
+
+			float deltaTime = 1.f / 60.f;
+			do
+			{
+				const size_t traceSize = trace.size();
+				tree.Update(deltaTime);
+				deltaTime = 0.f;
+				if (leafBudget > 0 && trace.size() - traceSize > leafBudget)
+					++g_OverBudgetCount;
+				if (tree.IsSuspended())
+					++g_SuspendCount;
+			} while (tree.IsSuspended());
+			trace.push_back(0xFFFFFFFF);
+		}
+		script.pTrace = nullptr;
+	}
+
+	//'resumeRunningPath' continues the running nodes, whose guards are checked without suspending, so the budget
+	//only holds without it
+	void TestLeafBudget(unsigned int leafBudget, bool resumeRunningPath)
+	{
+		unsigned int mismatchCount = 0;
+		g_SuspendCount = 0;
+		g_OverBudgetCount = 0;
+		for (unsigned int seed = 1; seed <= TreeCount; ++seed)
+		{
+			const unsigned int leafCount = 4 + seed % 60;
+			BehaviorTree* pTree = Test::CreateRandomBehaviorTree(seed, leafCount, true);
+			BehaviorTree* pBudgetedTree = Test::CreateRandomBehaviorTree(seed, leafCount, true);
+			pTree->SetResumeRunningPath(resumeRunningPath);
+			pBudgetedTree->SetResumeRunningPath(resumeRunningPath);
+			pBudgetedTree->SetLeafBudget(leafBudget);
+
+			std::vector<unsigned int> trace = {};
+			std::vector<unsigned int> budgetedTrace = {};
+			RunTree(*pTree, seed, 0, trace);
+			RunTree(*pBudgetedTree, seed, leafBudget, budgetedTrace);
+			if (trace != budgetedTrace)
+			{
+				if (mismatchCount == 0)
+					printf("First mismatch: seed %u, %u leaves, budget %u \n", seed, leafCount, leafBudget);
+				++mismatchCount;
+			}
+
+			delete pTree;
+			delete pBudgetedTree;
+		}
+
+		ELITE_CHECK(mismatchCount == 0);
+		ELITE_CHECK(g_SuspendCount > 0);
+		if (!resumeRunningPath)
+			ELITE_CHECK(g_OverBudgetCount == 0);
+	}
+
+	unsigned int g_RunCount = 0;
+	BehaviorState CountedAction(Blackboard*) { ++g_RunCount; return Success; }
+
+	//A sequence of three, with a budget of two: the next Update runs the third leaf only, the first two aren't run again
+	void TestContinuesAtNode()
+	{
+		BehaviorTree tree(new Blackboard(), new BehaviorSequence(
+			{
+				new BehaviorAction(CountedAction), new BehaviorAction(CountedAction), new BehaviorAction(CountedAction)
+			}));
+		tree.Compile();
+		tree.SetLeafBudget(2);
+
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(tree.IsSuspended() && g_RunCount == 2);
+		tree.Update(0.f);
+		ELITE_CHECK(!tree.IsSuspended() && g_RunCount == 3);
+
+		//Off again, one Update decides
+		tree.SetLeafBudget(0);
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(!tree.IsSuspended() && g_RunCount == 6);
+	}
+}
+
+int main()
+{
+	for (unsigned int leafBudget : { 1u, 2u, 5u })
+	{
+		TestLeafBudget(leafBudget, false);
+		TestLeafBudget(leafBudget, true);
+	}
+	TestContinuesAtNode();
+	return Test::Finish("BehaviorTimeBudgetTest");
+}
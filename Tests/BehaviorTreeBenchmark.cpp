@@ -0,0 +1,56 @@
+//Ticks per second of the compiled BehaviorTree against the pointer tree, on random trees of growing size.
+//The leaves are the scripted ones of RandomBehaviorTree.h, a few instructions each, so this is mostly the walk.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BehaviorTreeBenchmark.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BehaviorTreeBenchmark.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the tree is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include "EBehaviorTree.h"
+#include "RandomBehaviorTree.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int TreeCount = 16; //Per size, averaged
+	const unsigned int TickCount = 20000;
+	const unsigned int InputInterval = 5;
+
+	//Seconds per tick over all trees of this size, 'nodeCount' gets their average number of nodes
+	double MeasureTick(unsigned int leafCount, bool isCompiled, size_t& nodeCount)
+	{
+		double seconds = 0.0;
+		nodeCount = 0;
+		for (unsigned int seed = 1; seed <= TreeCount; ++seed)
+		{
+			BehaviorTree* pTree = Test::CreateRandomBehaviorTree(seed, leafCount, isCompiled);
+			nodeCount += pTree->GetDefinition()->GetBehaviors().size() / TreeCount;
+			Test::GetRandomTreeScript().seed = seed;
+			seconds += Test::MeasureSeconds(TickCount, [&](unsigned int tick)
+				{
+					Test::GetRandomTreeScript().tick = tick;
+					if (tick % InputInterval == 0)
+						pTree->GetBlackboard()->TryChangeData(Test::GetRandomTreeInputName(), tick / InputInterval);
+					pTree->Update(1.f / 60.f);
+				}, 3);
+			delete pTree;
+		}
+		return seconds / TreeCount;
+	}
+}
+
+int main()
+{
+	printf("%-8s %16s %16s %8s \n", "nodes", "pointer tick/s", "compiled tick/s", "speedup");
+	for (unsigned int leafCount : { 8u, 32u, 128u, 512u })
+	{
+		size_t nodeCount = 0;
+		const double pointerSeconds = MeasureTick(leafCount, false, nodeCount);
+		const double compiledSeconds = MeasureTick(leafCount, true, nodeCount);
+		printf("%-8zu %16.0f %16.0f %7.2fx \n", nodeCount, 1.0 / pointerSeconds, 1.0 / compiledSeconds, pointerSeconds / compiledSeconds);
+	}
+	return Test::Finish("BehaviorTreeBenchmark");
+}
@@ -0,0 +1,151 @@
+//The compiled BehaviorTree against the pointer tree it was compiled from, on random trees: both have to
+//run the same leaves in the same order with the same results, tick after tick. A compiled tree resuming its running
+//path against the same tree running from the root, on random trees it can resume exactly, and a higher-priority
+//branch or a failing guard taking over from the running node it resumes.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BehaviorTreeCompileTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BehaviorTreeCompileTest.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the tree is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include <vector>
+#include "EBehaviorTree.h"
+#include "RandomBehaviorTree.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int TreeCount = 500;
+	const unsigned int TickCount = 64;
+	const unsigned int InputInterval = 5; //Ticks between changes of the observed input
+
+	unsigned int g_ResumedTickCount = 0; //Ticks a tree started at its running node
+
+	//Runs a tree for all ticks, the leaves it ran are appended to 'trace' with a marker between ticks
+	void RunTree(BehaviorTree& tree, unsigned int seed, std::vector<unsigned int>& trace)
+	{
+		Test::RandomTreeScript& script = Test::GetRandomTreeScript();
+		script.seed = seed;
+		script.pTrace = &trace;
+		for (unsigned int tick = 0; tick < TickCount; ++tick)
+		{
+			script.tick = tick;
+			if (tick % InputInterval == 0)
+				tree.GetBlackboard()->TryChangeData(Test::GetRandomTreeInputName(), tick / InputInterval);
+			if (tree.HasRunningPath())
+				++g_ResumedTickCount;
+			tree.Update(1.f / 60.f);
+			trace.push_back(0xFFFFFFFF);
+		}
+		script.pTrace = nullptr;
+	}
+
+	void TestResumeRunningPath()
+	{
+		unsigned int mismatchCount = 0;
+		g_ResumedTickCount = 0;
+		for (unsigned int seed = 1; seed <= TreeCount; ++seed)
+		{
+			const unsigned int leafCount = 4 + seed % 60;
+			BehaviorTree* pRootTree = Test::CreateRandomBehaviorTree(seed, leafCount, true, true);
+			BehaviorTree* pResumingTree = Test::CreateRandomBehaviorTree(seed, leafCount, true, true);
+			pResumingTree->SetResumeRunningPath(true);
+
+			std::vector<unsigned int> rootTrace = {};
+			std::vector<unsigned int> resumingTrace = {};
+			RunTree(*pRootTree, seed, rootTrace);
+			RunTree(*pResumingTree, seed, resumingTrace);
+			if (rootTrace != resumingTrace)
+			{
+				if (mismatchCount == 0)
+					printf("First resume mismatch: seed %u, %u leaves \n", seed, leafCount);
+				++mismatchCount;
+			}
+
+			delete pRootTree;
+			delete pResumingTree;
+		}
+		ELITE_CHECK(mismatchCount == 0);
+		ELITE_CHECK(g_ResumedTickCount > 0);
+		printf("%u random trees, %u ticks resumed \n", TreeCount, g_ResumedTickCount);
+	}
+
+	bool g_IsThreatened = false;
+	bool g_IsPathClear = true;
+	unsigned int g_FleeCount = 0;
+	unsigned int g_WalkCount = 0;
+
+	bool IsThreatened(Blackboard*) { return g_IsThreatened; }
+	bool IsPathClear(Blackboard*) { return g_IsPathClear; }
+	BehaviorState Flee(Blackboard*) { ++g_FleeCount; return Success; }
+	BehaviorState Walk(Blackboard*) { ++g_WalkCount; return Running; }
+
+	//Walking keeps running until the threat's branch ahead of it holds or the guard in its own sequence fails
+	void TestResumePreemption()
+	{
+		BehaviorTree tree(new Blackboard(), new BehaviorSelector(
+			{
+				new BehaviorSequence({ new BehaviorConditional(IsThreatened), new BehaviorAction(Flee) }),
+				new BehaviorSequence({ new BehaviorConditional(IsPathClear), new BehaviorAction(Walk) })
+			}));
+		tree.Compile();
+		tree.SetResumeRunningPath(true);
+
+		tree.Update(1.f / 60.f);
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_WalkCount == 2 && g_FleeCount == 0);
+
+		//The higher-priority branch takes over, the running walk isn't continued
+		g_IsThreatened = true;
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_WalkCount == 2 && g_FleeCount == 1);
+
+		//Nothing running after the flee, the next tick starts at the root
+		g_IsThreatened = false;
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_WalkCount == 3 && g_FleeCount == 1);
+
+		//The guard ahead of the running walk fails it, nothing else runs
+		g_IsPathClear = false;
+		tree.Update(1.f / 60.f);
+		ELITE_CHECK(g_WalkCount == 3 && g_FleeCount == 1);
+	}
+}
+
+int main()
+{
+	unsigned int mismatchCount = 0;
+	size_t leafRunCount = 0;
+	for (unsigned int seed = 1; seed <= TreeCount; ++seed)
+	{
+		const unsigned int leafCount = 4 + seed % 60;
+		BehaviorTree* pPointerTree = Test::CreateRandomBehaviorTree(seed, leafCount, false);
+		BehaviorTree* pCompiledTree = Test::CreateRandomBehaviorTree(seed, leafCount, true);
+		ELITE_CHECK(!pPointerTree->IsCompiled() && pCompiledTree->IsCompiled());
+
+		std::vector<unsigned int> pointerTrace = {};
+		std::vector<unsigned int> compiledTrace = {};
+		RunTree(*pPointerTree, seed, pointerTrace);
+		RunTree(*pCompiledTree, seed, compiledTrace);
+		if (pointerTrace != compiledTrace)
+		{
+			if (mismatchCount == 0)
+				printf("First mismatch: seed %u, %u leaves \n", seed, leafCount);
+			++mismatchCount;
+		}
+		leafRunCount += pointerTrace.size() - TickCount;
+
+		delete pPointerTree;
+		delete pCompiledTree;
+	}
+
+	ELITE_CHECK(mismatchCount == 0);
+	printf("%u random trees, %zu leaf runs compared \n", TreeCount, leafRunCount);
+
+	TestResumeRunningPath();
+	TestResumePreemption();
+	return Test::Finish("BehaviorTreeCompileTest");
+}
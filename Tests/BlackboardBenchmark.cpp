@@ -0,0 +1,187 @@
+//Blackboard access cost: the arena blackboard by name and by key, against the map of heap allocated
+//fields read through dynamic_cast it replaced (LegacyBlackboard below, as it was).
+//Build: cl /std:c++20 /O2 /EHsc /I.. BlackboardBenchmark.cpp
+//       g++ -std=c++20 -O2 -I.. BlackboardBenchmark.cpp
+
+//=== General Includes ===
+#include <cstdio>
+#include <string>
+#include <typeinfo>
+#include "EBlackboard.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+//-----------------------------------------------------------------
+// LEGACY BLACKBOARD
+//-----------------------------------------------------------------
+namespace
+{
+	class ILegacyField
+	{
+	public:
+		ILegacyField() = default;
+		virtual ~ILegacyField() = default;
+	};
+
+	template<typename T>
+	class LegacyField : public ILegacyField
+	{
+	public:
+		explicit LegacyField(T data) : m_Data(data)
+		{}
+		T GetData() { return m_Data; };
+		void SetData(T data) { m_Data = data; }
+
+	private:
+		T m_Data;
+	};
+
+	class LegacyBlackboard final
+	{
+	public:
+		LegacyBlackboard() = default;
+		~LegacyBlackboard()
+		{
+			for (auto el : m_BlackboardData)
+				delete(el.second);
+		}
+
+		template<typename T> bool AddData(const std::string& name, T data)
+		{
+			auto it = m_BlackboardData.find(name);
+			if (it == m_BlackboardData.end())
+			{
+				m_BlackboardData[name] = new LegacyField<T>(data);
+				return true;
+			}
+			return false;
+		}
+
+		template<typename T> bool ChangeData(const std::string& name, T data)
+		{
+			auto it = m_BlackboardData.find(name);
+			if (it != m_BlackboardData.end())
+			{
+				LegacyField<T>* p = dynamic_cast<LegacyField<T>*>(m_BlackboardData[name]);
+				if (p)
+				{
+					p->SetData(data);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		template<typename T> bool GetData(const std::string& name, T& data)
+		{
+			LegacyField<T>* p = dynamic_cast<LegacyField<T>*>(m_BlackboardData[name]);
+			if (p != nullptr)
+			{
+				data = p->GetData();
+				return true;
+			}
+			return false;
+		}
+
+	private:
+		std::unordered_map<std::string, ILegacyField*> m_BlackboardData;
+	};
+
+	//Stand-ins for AgentInfo and the FOV entities, about the same size
+	struct Agent
+	{
+		float health, stamina, fovRange, fovAngle, maxLinearSpeed, maxAngularSpeed, size, orientation;
+		float positionX, positionY, velocityX, velocityY;
+		bool isBitten, isInHouse, runMode;
+	};
+
+	struct Entity
+	{
+		int type;
+		float locationX, locationY;
+		int hash;
+	};
+
+	const unsigned int CallCount = 1000000;
+
+	template<typename TBlackboard> void AddExamData(TBlackboard& blackboard)
+	{
+		blackboard.AddData("Agent", Agent{});
+		blackboard.AddData("Entities", std::vector<Entity>(16, Entity{ 1, 2.f, 3.f, 4 }));
+		blackboard.AddData("Stamina", 5.f);
+		//The other entries the exam plugin keeps, so the map is as full as there
+		const char* names[] = { "fleeTarget", "ItemTarget", "EnemyTarget", "houseTarget", "Target", "Seek", "Wander", "Flee",
+			"Arrive", "Face", "Evade", "Pursuit", "Scout", "Steering", "Angular", "Houses", "Interface", "ClosestHouse" };
+		for (const char* pName : names)
+			blackboard.AddData(pName, static_cast<void*>(nullptr));
+	}
+
+	//Negative times are accesses the blackboard doesn't have
+	void PrintRow(const char* pAccess, double legacySeconds, double nameSeconds, double keySeconds)
+	{
+		printf("%-32s", pAccess);
+		for (double seconds : { legacySeconds, nameSeconds, keySeconds })
+		{
+			if (seconds < 0.0)
+				printf(" %10s", "-");
+			else
+				printf(" %10.2f", seconds * 1e9);
+		}
+		printf(" \n");
+	}
+}
+
+int main()
+{
+	LegacyBlackboard legacy;
+	AddExamData(legacy);
+	Blackboard blackboard;
+	AddExamData(blackboard);
+	const BlackboardKey<float> staminaKey = blackboard.GetKey<float>("Stamina");
+	const BlackboardKey<Agent> agentKey = blackboard.GetKey<Agent>("Agent");
+	const BlackboardKey<std::vector<Entity>> entitiesKey = blackboard.GetKey<std::vector<Entity>>("Entities");
+
+	//Same data either way
+	float legacyStamina = 0.f;
+	float stamina = 0.f;
+	std::vector<Entity> legacyEntities;
+	ELITE_CHECK(legacy.GetData("Stamina", legacyStamina) && blackboard.GetData(staminaKey, stamina) && legacyStamina == stamina);
+	ELITE_CHECK(legacy.GetData("Entities", legacyEntities) && legacyEntities.size() == blackboard.GetDataPtr(entitiesKey)->size());
+
+	printf("ns per access                    %10s %10s %10s \n", "legacy", "by name", "by key");
+
+	float sum = 0.f;
+	PrintRow("read float",
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { float value = 0.f; legacy.GetData("Stamina", value); sum += value; }),
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { float value = 0.f; blackboard.TryGetData("Stamina", value); sum += value; }),
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { float value = 0.f; blackboard.TryGetData(staminaKey, value); sum += value; }));
+
+	PrintRow("write float",
+		Test::MeasureSeconds(CallCount, [&](unsigned int i) { legacy.ChangeData("Stamina", static_cast<float>(i)); }),
+		Test::MeasureSeconds(CallCount, [&](unsigned int i) { blackboard.TryChangeData("Stamina", static_cast<float>(i)); }),
+		Test::MeasureSeconds(CallCount, [&](unsigned int i) { blackboard.TryChangeData(staminaKey, static_cast<float>(i)); }));
+
+	PrintRow("read agent (copy)",
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { Agent agent{}; legacy.GetData("Agent", agent); sum += agent.health; }),
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { Agent agent{}; blackboard.TryGetData("Agent", agent); sum += agent.health; }),
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { Agent agent{}; blackboard.TryGetData(agentKey, agent); sum += agent.health; }));
+
+	PrintRow("read agent (in place)",
+		-1.0,
+		-1.0,
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { sum += blackboard.TryGetDataPtr(agentKey)->health; }));
+
+	PrintRow("read 16 entities (copy)",
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { std::vector<Entity> entities; legacy.GetData("Entities", entities); sum += entities[0].locationX; }),
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { std::vector<Entity> entities; blackboard.TryGetData("Entities", entities); sum += entities[0].locationX; }),
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { std::vector<Entity> entities; blackboard.TryGetData(entitiesKey, entities); sum += entities[0].locationX; }));
+
+	PrintRow("read 16 entities (in place)",
+		-1.0,
+		-1.0,
+		Test::MeasureSeconds(CallCount, [&](unsigned int) { sum += (*blackboard.TryGetDataPtr(entitiesKey))[0].locationX; }));
+
+	Test::KeepAlive(sum);
+	return Test::Finish("BlackboardBenchmark");
+}
@@ -0,0 +1,109 @@
+//Blackboard::Publish on the writing thread while another thread acquires and reads snapshots.
+//Every snapshot a reader gets has to be one whole tick: the values written in the same tick agree,
+//and versions never go back.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BlackboardSnapshotTest.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BlackboardSnapshotTest.cpp
+//Run it under -fsanitize=thread as well, it has to come out clean. With libstdc++ 12 ThreadSanitizer flags one read
+//inside std::atomic<std::shared_ptr>::load itself, which releases its lock bit relaxed; that report is the library's.
+
+//=== General Includes ===
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "EBlackboard.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int TickCount = 20000;
+
+	//Written together every tick, so both fields always hold the tick they were written in
+	struct Perception
+	{
+		unsigned int tick;
+		unsigned int tickCopy;
+	};
+}
+
+int main()
+{
+	Blackboard blackboard;
+	blackboard.AddData("Perception", Perception{ 0, 0 });
+	blackboard.AddData("Entities", std::vector<unsigned int>{});
+	blackboard.AddData("Tick", 0u);
+	const BlackboardKey<Perception> perceptionKey = blackboard.GetKey<Perception>("Perception");
+	const BlackboardKey<std::vector<unsigned int>> entitiesKey = blackboard.GetKey<std::vector<unsigned int>>("Entities");
+	const BlackboardKey<unsigned int> tickKey = blackboard.GetKey<unsigned int>("Tick");
+
+	ELITE_CHECK(blackboard.AcquireSnapshot() == nullptr);
+
+	std::atomic<bool> isWriting{ true };
+	std::atomic<unsigned int> tornCount{ 0 };
+	std::atomic<unsigned int> readCount{ 0 };
+	std::atomic<unsigned int> lastReadTick{ 0 };
+	std::thread reader([&]()
+		{
+			unsigned int lastVersion = 0;
+			while (isWriting.load(std::memory_order_relaxed))
+			{
+				const std::shared_ptr<const BlackboardSnapshot> pSnapshot = blackboard.AcquireSnapshot();
+				if (pSnapshot == nullptr)
+					continue;
+
+				Perception perception{};
+				unsigned int tick = 0;
+				const std::vector<unsigned int>* pEntities = pSnapshot->TryGetDataPtr(entitiesKey);
+				if (!pSnapshot->TryGetData(perceptionKey, perception) || !pSnapshot->TryGetData(tickKey, tick) || pEntities == nullptr)
+				{
+					++tornCount;
+					continue;
+				}
+
+				//A tick writes as many entities as its number, each holding the tick
+				bool isWhole = perception.tick == tick && perception.tickCopy == tick && pEntities->size() == tick % 64
+					&& pSnapshot->GetVersion() >= lastVersion;
+				for (unsigned int entity : *pEntities)
+					isWhole = isWhole && entity == tick;
+				if (!isWhole)
+					++tornCount;
+
+				lastVersion = pSnapshot->GetVersion();
+				lastReadTick = tick;
+				++readCount;
+			}
+		});
+
+	std::vector<unsigned int> entities;
+	for (unsigned int tick = 1; tick <= TickCount; ++tick)
+	{
+		entities.assign(tick % 64, tick);
+		blackboard.TryChangeData(perceptionKey, Perception{ tick, tick });
+		blackboard.TryChangeData(entitiesKey, entities);
+		blackboard.TryChangeData(tickKey, tick);
+		blackboard.Publish();
+	}
+	//Let the reader see the last tick before stopping it
+	while (lastReadTick.load() != TickCount && readCount.load() < TickCount * 100)
+		std::this_thread::yield();
+	isWriting = false;
+	reader.join();
+
+	ELITE_CHECK(tornCount.load() == 0);
+	ELITE_CHECK(readCount.load() > 0);
+	ELITE_CHECK(blackboard.GetPublishedVersion() == TickCount);
+
+	//Snapshots that were handed out stay as they were while the blackboard moves on
+	const std::shared_ptr<const BlackboardSnapshot> pHeld = blackboard.AcquireSnapshot();
+	ELITE_CHECK(pHeld != nullptr && pHeld->GetVersion() == TickCount);
+	blackboard.TryChangeData(tickKey, TickCount + 1);
+	blackboard.Publish();
+	unsigned int heldTick = 0;
+	ELITE_CHECK(pHeld->TryGetData(tickKey, heldTick) && heldTick == TickCount);
+	ELITE_CHECK(blackboard.AcquireSnapshot()->GetVersion() == TickCount + 1);
+
+	printf("%u snapshots read while publishing %u ticks \n", readCount.load(), TickCount);
+	return Test::Finish("BlackboardSnapshotTest");
+}
@@ -0,0 +1,72 @@
+//Deferred blackboard writes: inside a DeferWritesScope the thread reads its own pending writes, while
+//the blackboard and every other thread keep seeing the old data until the log is applied.
+//Build: cl /std:c++20 /O2 /EHsc /I.. BlackboardWriteLogTest.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. BlackboardWriteLogTest.cpp
+
+//=== General Includes ===
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "EBlackboard.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+int main()
+{
+	Blackboard blackboard;
+	blackboard.AddData("Stamina", 5.f);
+	blackboard.AddData("Entities", std::vector<int>{ 1, 2, 3 });
+	const BlackboardKey<float> staminaKey = blackboard.GetKey<float>("Stamina");
+	const BlackboardKey<std::vector<int>> entitiesKey = blackboard.GetKey<std::vector<int>>("Entities");
+
+	BlackboardWriteLog log;
+	{
+		Blackboard::DeferWritesScope scope(&log);
+
+		//Nothing pending yet, reads go to the blackboard
+		float stamina = 0.f;
+		ELITE_CHECK(blackboard.TryGetData(staminaKey, stamina) && stamina == 5.f);
+
+		//The latest pending write is read back, by key, by name and in place
+		ELITE_CHECK(blackboard.TryChangeData(staminaKey, 4.f));
+		ELITE_CHECK(blackboard.TryChangeData("Stamina", 3.f));
+		ELITE_CHECK(blackboard.TryGetData(staminaKey, stamina) && stamina == 3.f);
+		ELITE_CHECK(blackboard.TryGetData("Stamina", stamina) && stamina == 3.f);
+		ELITE_CHECK(blackboard.TryChangeData(entitiesKey, std::vector<int>{ 4 }));
+		const std::vector<int>* pEntities = blackboard.TryGetDataPtr(entitiesKey);
+		ELITE_CHECK(pEntities != nullptr && pEntities->size() == 1 && (*pEntities)[0] == 4);
+
+		//Another thread, not deferring, still sees the blackboard as it was
+		float otherStamina = 0.f;
+		size_t otherEntityCount = 0;
+		std::thread other([&]()
+			{
+				blackboard.TryGetData(staminaKey, otherStamina);
+				otherEntityCount = blackboard.TryGetDataPtr(entitiesKey)->size();
+			});
+		other.join();
+		ELITE_CHECK(otherStamina == 5.f && otherEntityCount == 3);
+
+		//A nested scope reads its own log only
+		BlackboardWriteLog nestedLog;
+		{
+			Blackboard::DeferWritesScope nestedScope(&nestedLog);
+			ELITE_CHECK(blackboard.TryGetData(staminaKey, stamina) && stamina == 5.f);
+			ELITE_CHECK(blackboard.TryChangeData(staminaKey, 2.f));
+			ELITE_CHECK(blackboard.TryGetData(staminaKey, stamina) && stamina == 2.f);
+		}
+		//Applied inside the outer scope, the write moves on to its log
+		blackboard.ApplyWriteLog(nestedLog);
+		ELITE_CHECK(blackboard.TryGetData(staminaKey, stamina) && stamina == 2.f);
+	}
+
+	//Out of the scope the blackboard is unchanged until the log is applied
+	float stamina = 0.f;
+	ELITE_CHECK(blackboard.TryGetData(staminaKey, stamina) && stamina == 5.f);
+	blackboard.ApplyWriteLog(log);
+	ELITE_CHECK(blackboard.TryGetData(staminaKey, stamina) && stamina == 2.f);
+	ELITE_CHECK(blackboard.TryGetDataPtr(entitiesKey)->size() == 1);
+
+	return Test::Finish("BlackboardWriteLogTest");
+}
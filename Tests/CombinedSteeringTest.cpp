@@ -0,0 +1,224 @@
+//StaticBlendedSteering against the BlendedSteering of virtual calls it stands in for: the same blend of the same
+//behaviors and weights, zero weights included, on random agents, and members with weight 0 not evaluated by either.
+//PrioritySteering falling through behaviors with nothing to do, e.g. Evade outside its radius, to the first one that
+//steers, and not evaluating the ones after it. CalculateChannelSteering skipping the behaviors whose channels the
+//caller doesn't read or that don't write them, like the plugin's angular pass under AutoOrient.
+//Build: cl /std:c++20 /O2 /EHsc /I.. CombinedSteeringTest.cpp ../CombinedSteeringBehaviors.cpp ../SteeringBehaviors.cpp
+//       g++ -std=c++20 -O2 -I.. CombinedSteeringTest.cpp ../CombinedSteeringBehaviors.cpp ../SteeringBehaviors.cpp
+//Needs the plugin's include paths, the behaviors are built on its precompiled header and the exam interface.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "CombinedSteeringBehaviors.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int AgentCount = 1000;
+
+	//Steers by a fixed output on the channels it's given, and counts how often it was asked to
+	class CountingSteering final : public ISteeringBehavior
+	{
+	public:
+		CountingSteering(const SteeringPlugin_Output& output, unsigned int channels)
+			:m_Output(output),
+			m_Channels(channels)
+		{}
+
+		SteeringPlugin_Output CalculateSteering(float, AgentInfo*) override
+		{
+			++m_CalculationCount;
+			return m_Output;
+		}
+		unsigned int GetOutputChannels() const override { return m_Channels; }
+		unsigned int GetCalculationCount() const { return m_CalculationCount; }
+
+	private:
+		SteeringPlugin_Output m_Output = {};
+		unsigned int m_Channels = AllChannels;
+		unsigned int m_CalculationCount = 0;
+	};
+
+	SteeringPlugin_Output MakeSteering(float x, float y, float angular)
+	{
+		SteeringPlugin_Output steering = {};
+		steering.LinearVelocity = { x, y };
+		steering.AngularVelocity = angular;
+		return steering;
+	}
+
+	AgentInfo MakeRandomAgent(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> position(-100.f, 100.f);
+		std::uniform_real_distribution<float> angle(-3.f, 3.f);
+		AgentInfo agent = {};
+		agent.Position = { position(random), position(random) };
+		agent.Orientation = angle(random);
+		agent.MaxLinearSpeed = 10.f;
+		agent.MaxAngularSpeed = 5.f;
+		return agent;
+	}
+
+	bool IsSameSteering(const SteeringPlugin_Output& a, const SteeringPlugin_Output& b)
+	{
+		const float tolerance = 1e-5f;
+		return fabsf(a.LinearVelocity.x - b.LinearVelocity.x) <= tolerance * (std::max)(fabsf(b.LinearVelocity.x), 1.f)
+			&& fabsf(a.LinearVelocity.y - b.LinearVelocity.y) <= tolerance * (std::max)(fabsf(b.LinearVelocity.y), 1.f)
+			&& fabsf(a.AngularVelocity - b.AngularVelocity) <= tolerance * (std::max)(fabsf(b.AngularVelocity), 1.f);
+	}
+
+	void TestStaticBlendedSteering()
+	{
+		std::mt19937 random(22);
+		std::uniform_real_distribution<float> position(-100.f, 100.f);
+		std::uniform_real_distribution<float> weight(0.f, 2.f);
+
+		Seek seek;
+		Arrive arrive;
+		arrive.SetSlowRadius(15.f);
+		Face face;
+		Pursuit pursuit;
+		BlendedSteering blended({ { &seek, 1.f }, { &arrive, 1.f }, { &face, 1.f }, { &pursuit, 1.f } });
+		StaticBlendedSteering<Seek, Arrive, Face, Pursuit> staticBlended(&seek, &arrive, &face, &pursuit);
+		ELITE_CHECK(staticBlended.GetOutputChannels() == blended.GetOutputChannels());
+
+		for (unsigned int i = 0; i < AgentCount; ++i)
+		{
+			//Every member gets its own target, one in four weights is 0 and every so often all of them are
+			for (ISteeringBehavior* pBehavior : { static_cast<ISteeringBehavior*>(&seek), static_cast<ISteeringBehavior*>(&arrive),
+				static_cast<ISteeringBehavior*>(&face), static_cast<ISteeringBehavior*>(&pursuit) })
+			{
+				pBehavior->SetTargetPos({ position(random), position(random) });
+				pBehavior->SetTargetLinVel({ position(random) / 10.f, position(random) / 10.f });
+			}
+			for (size_t member = 0; member < 4; ++member)
+			{
+				const float memberWeight = i % 50 == 0 || random() % 4 == 0 ? 0.f : weight(random);
+				blended.GetWeightedBehaviorsRef()[member].weight = memberWeight;
+				staticBlended.SetWeight(member, memberWeight);
+			}
+
+			AgentInfo agent = MakeRandomAgent(random);
+			ELITE_CHECK(IsSameSteering(staticBlended.CalculateSteering(1.f / 60.f, &agent), blended.CalculateSteering(1.f / 60.f, &agent)));
+		}
+	}
+
+	//Members with weight 0 add nothing to the blend and aren't calculated
+	void TestZeroWeightsSkipped()
+	{
+		CountingSteering first(MakeSteering(1.f, 0.f, 2.f), ISteeringBehavior::AllChannels);
+		CountingSteering second(MakeSteering(0.f, 3.f, 0.f), ISteeringBehavior::LinearChannel);
+		BlendedSteering blended({ { &first, 0.f }, { &second, 1.f } });
+		StaticBlendedSteering<CountingSteering, CountingSteering> staticBlended(&first, &second);
+		staticBlended.SetWeights({ 0.f, 1.f });
+
+		AgentInfo agent = {};
+		const SteeringPlugin_Output expected = MakeSteering(0.f, 3.f, 0.f);
+		ELITE_CHECK(IsSameSteering(blended.CalculateSteering(1.f / 60.f, &agent), expected));
+		ELITE_CHECK(IsSameSteering(staticBlended.CalculateSteering(1.f / 60.f, &agent), expected));
+		ELITE_CHECK(first.GetCalculationCount() == 0);
+		ELITE_CHECK(second.GetCalculationCount() == 2);
+
+		//Nothing weighs in: no steering at all
+		staticBlended.SetWeights({ 0.f, 0.f });
+		ELITE_CHECK(IsSameSteering(staticBlended.CalculateSteering(1.f / 60.f, &agent), SteeringPlugin_Output{}));
+		ELITE_CHECK(second.GetCalculationCount() == 2);
+	}
+
+	//Evade is out of range and returns no steering, the Seek after it wins and the last behavior isn't evaluated
+	void TestPriorityFallThrough()
+	{
+		Evade evade;
+		evade.SetEvadeRadius(10.f);
+		evade.SetTargetPos({ 50.f, 0.f });
+		Seek seek;
+		seek.SetTargetPos({ 0.f, 20.f });
+		CountingSteering last(MakeSteering(-1.f, -1.f, 0.f), ISteeringBehavior::LinearChannel);
+		PrioritySteering priority({ &evade, &seek, &last });
+
+		AgentInfo agent = {};
+		agent.MaxLinearSpeed = 10.f;
+		ELITE_CHECK(IsSameSteering(priority.CalculateSteering(1.f / 60.f, &agent), MakeSteering(0.f, 10.f, 0.f)));
+		ELITE_CHECK(priority.GetEvaluationCount(0) == 1);
+		ELITE_CHECK(priority.GetEvaluationCount(1) == 1);
+		ELITE_CHECK(priority.GetEvaluationCount(2) == 0);
+		ELITE_CHECK(last.GetCalculationCount() == 0);
+		ELITE_CHECK(priority.GetSkippedCount() == 1);
+
+		//In range Evade steers away itself, nothing after it is evaluated
+		evade.SetTargetPos({ 5.f, 0.f });
+		ELITE_CHECK(IsSameSteering(priority.CalculateSteering(1.f / 60.f, &agent), MakeSteering(-10.f, 0.f, 0.f)));
+		ELITE_CHECK(priority.GetEvaluationCount(0) == 2);
+		ELITE_CHECK(priority.GetEvaluationCount(1) == 1);
+		ELITE_CHECK(priority.GetSkippedCount() == 3);
+		ELITE_CHECK(priority.GetCalculationCount() == 2);
+	}
+
+	//Outputs below the validity threshold count as nothing to do, when no behavior steers the last one's output is returned
+	void TestPriorityNothingValid()
+	{
+		CountingSteering tiny(MakeSteering(1e-4f, 0.f, 0.f), ISteeringBehavior::LinearChannel);
+		CountingSteering none(SteeringPlugin_Output{}, ISteeringBehavior::AllChannels);
+		CountingSteering last(MakeSteering(0.f, 0.f, 1e-4f), ISteeringBehavior::AngularChannel);
+		PrioritySteering priority({ &tiny, &none, &last });
+
+		AgentInfo agent = {};
+		ELITE_CHECK(IsSameSteering(priority.CalculateSteering(1.f / 60.f, &agent), MakeSteering(0.f, 0.f, 1e-4f)));
+		ELITE_CHECK(tiny.GetCalculationCount() == 1 && none.GetCalculationCount() == 1 && last.GetCalculationCount() == 1);
+		ELITE_CHECK(priority.GetSkippedCount() == 0);
+
+		//A lower threshold makes the first output usable
+		priority.SetValidityThreshold(1e-5f);
+		priority.ResetCounts();
+		ELITE_CHECK(IsSameSteering(priority.CalculateSteering(1.f / 60.f, &agent), MakeSteering(1e-4f, 0.f, 0.f)));
+		ELITE_CHECK(priority.GetEvaluationCount(0) == 1 && priority.GetEvaluationCount(1) == 0 && priority.GetEvaluationCount(2) == 0);
+		ELITE_CHECK(priority.GetSkippedCount() == 2);
+	}
+
+	void TestChannelSteering()
+	{
+		CountingSteering linear(MakeSteering(3.f, 4.f, 0.f), ISteeringBehavior::LinearChannel);
+		CountingSteering angular(MakeSteering(0.f, 0.f, 2.f), ISteeringBehavior::AngularChannel);
+		AgentInfo agent = {};
+		SteeringPlugin_Output steering = MakeSteering(9.f, 9.f, 9.f);
+
+		//Both channels read: both behaviors calculated
+		ELITE_CHECK(CalculateChannelSteering(1.f / 60.f, &agent, &linear, &angular, ISteeringBehavior::AllChannels, steering) == 2);
+		ELITE_CHECK(IsSameSteering(steering, MakeSteering(3.f, 4.f, 2.f)));
+
+		//Only the linear channel read, as under AutoOrient: the angular pass is skipped and its channel is zero
+		ELITE_CHECK(CalculateChannelSteering(1.f / 60.f, &agent, &linear, &angular, ISteeringBehavior::LinearChannel, steering) == 1);
+		ELITE_CHECK(IsSameSteering(steering, MakeSteering(3.f, 4.f, 0.f)));
+		ELITE_CHECK(linear.GetCalculationCount() == 2);
+		ELITE_CHECK(angular.GetCalculationCount() == 1);
+
+		//Behaviors that don't write the channel they'd be calculated for aren't either, Face doesn't steer linearly
+		Face face;
+		ELITE_CHECK(!face.ProducesAny(ISteeringBehavior::LinearChannel));
+		ELITE_CHECK(CalculateChannelSteering(1.f / 60.f, &agent, &face, &linear, ISteeringBehavior::AllChannels, steering) == 0);
+		ELITE_CHECK(IsSameSteering(steering, SteeringPlugin_Output{}));
+		ELITE_CHECK(linear.GetCalculationCount() == 2);
+
+		//Combined behaviors write what their members do
+		PrioritySteering priority({ &linear, &angular });
+		ELITE_CHECK(priority.GetOutputChannels() == ISteeringBehavior::AllChannels);
+		StaticBlendedSteering<CountingSteering> blended(&linear);
+		ELITE_CHECK(blended.GetOutputChannels() == ISteeringBehavior::LinearChannel);
+		ELITE_CHECK(CalculateChannelSteering(1.f / 60.f, &agent, &linear, &blended, ISteeringBehavior::AllChannels, steering) == 1);
+	}
+}
+
+int main()
+{
+	TestStaticBlendedSteering();
+	TestZeroWeightsSkipped();
+	TestPriorityFallThrough();
+	TestPriorityNothingValid();
+	TestChannelSteering();
+	return Test::Finish("CombinedSteeringTest");
+}
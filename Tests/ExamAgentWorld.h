@@ -0,0 +1,151 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// ExamAgentWorld.h: Random perceptions for many exam agents, each deciding with its own BehaviorTree
+// of the survival nodes ExamBatchTree batches, for the tests and benchmarks of the batch tree, or with
+// the plugin's whole tree.
+/*=============================================================================*/
+#ifndef ELITE_TEST_EXAM_AGENT_WORLD
+#define ELITE_TEST_EXAM_AGENT_WORLD
+
+//--- Includes ---
+#include <random>
+#include <vector>
+#include "Behaviors.h"
+
+namespace Elite
+{
+	namespace Test
+	{
+		//One agent of the plugin: its steering behaviors, the slots its tree selects them into, and the tree
+		struct ExamAgent
+		{
+			Seek seek = {};
+			Flee flee = {};
+			Wander wander = {};
+			Scout scout = {};
+			Arrive arrive = {};
+			Face face = {};
+			Evade evade = {};
+			Pursuit pursuit = {};
+			ISteeringBehavior* pSteering = nullptr;
+			ISteeringBehavior* pAngular = nullptr;
+			BehaviorTree* pTree = nullptr;
+
+			ExamAgent() = default;
+			~ExamAgent() { delete pTree; }
+			ExamAgent(const ExamAgent& other) = delete;
+			ExamAgent& operator=(const ExamAgent& other) = delete;
+		};
+
+		//Blackboard laid out as Plugin::Initialize does, so the keys resolve to the same slots for every agent
+		inline void CreateExamAgentTree(ExamAgent& agent)
+		{
+			Blackboard* pBlackboard = new Blackboard();
+			pBlackboard->AddData("fleeTarget", Vector2{});
+			pBlackboard->AddData("ItemTarget", EntityInfo{});
+			pBlackboard->AddData("EnemyTarget", EntityInfo{});
+			pBlackboard->AddData("Seek", &agent.seek);
+			pBlackboard->AddData("Wander", &agent.wander);
+			pBlackboard->AddData("Flee", &agent.flee);
+			pBlackboard->AddData("Scout", &agent.scout);
+			pBlackboard->AddData("Steering", &agent.pSteering);
+			pBlackboard->AddData("Angular", &agent.pAngular);
+			pBlackboard->AddData("Agent", AgentInfo{});
+			pBlackboard->AddData("Entities", vector<EntityInfo>{});
+			ResolveBlackboardKeys(pBlackboard);
+
+			agent.pSteering = &agent.wander;
+			agent.pTree = new BehaviorTree(pBlackboard,
+				new BehaviorSelector(
+					{
+						new BehaviorSequence({ new BehaviorConditional(LowStamina), new BehaviorAction(StopRunning) }),
+						new BehaviorSequence({ new BehaviorConditional(AgentBittenHasStamina), new BehaviorAction(RunFlee) }),
+						new BehaviorSequence(
+						{
+							new BehaviorConditional(EnemyInFOV),
+							new BehaviorSequence({ new BehaviorConditional(HasStamina), new BehaviorAction(RunFlee) })
+						}),
+						new BehaviorSequence({ new BehaviorConditional(ItemInFov), new BehaviorAction(SeekItems) }),
+						new BehaviorAction(ScoutWander)
+					}));
+			agent.pTree->Compile();
+		}
+
+		//Blackboard laid out as all of Plugin::Initialize, for the plugin's whole tree (CreateExamBehavior) with the keys
+		//resolved. There is no exam interface, the nodes that need one fail.
+		inline Blackboard* CreateExamBlackboard(ExamAgent& agent)
+		{
+			Blackboard* pBlackboard = new Blackboard();
+			pBlackboard->AddData("fleeTarget", Vector2{});
+			pBlackboard->AddData("ItemTarget", EntityInfo{});
+			pBlackboard->AddData("EnemyTarget", EntityInfo{});
+			pBlackboard->AddData("houseTarget", HouseInfo{});
+			pBlackboard->AddData("Target", Vector2{});
+			pBlackboard->AddData("Seek", &agent.seek);
+			pBlackboard->AddData("Wander", &agent.wander);
+			pBlackboard->AddData("Flee", &agent.flee);
+			pBlackboard->AddData("Arrive", &agent.arrive);
+			pBlackboard->AddData("Face", &agent.face);
+			pBlackboard->AddData("Evade", &agent.evade);
+			pBlackboard->AddData("Pursuit", &agent.pursuit);
+			pBlackboard->AddData("Scout", &agent.scout);
+			pBlackboard->AddData("Steering", &agent.pSteering);
+			pBlackboard->AddData("Angular", &agent.pAngular);
+			pBlackboard->AddData("Agent", AgentInfo{});
+			pBlackboard->AddData("Houses", vector<HouseInfo>{});
+			pBlackboard->AddData("Entities", vector<EntityInfo>{});
+			pBlackboard->AddData("InventoryRevision", 0u);
+			pBlackboard->AddData("ClosestHouse", static_cast<const HouseInfo*>(nullptr));
+			pBlackboard->AddData("ClosestEnemy", static_cast<EnemyInfo*>(nullptr));
+			pBlackboard->AddData("ClosestItem", static_cast<ItemInfo*>(nullptr));
+			pBlackboard->AddData("ClosestPurgeZone", static_cast<PurgeZoneInfo*>(nullptr));
+			ResolveBlackboardKeys(pBlackboard);
+
+			agent.pSteering = &agent.wander;
+			agent.pAngular = &agent.scout;
+			return pBlackboard;
+		}
+
+		//What one agent perceives in a tick
+		struct ExamPerception
+		{
+			AgentInfo agent = {};
+			vector<EntityInfo> entities = {};
+			Vector2 fleeTarget = {};
+		};
+
+		//Every input the batch tree reads is varied, with enough low stamina, bites, enemies and items for every branch
+		inline void RandomizePerception(std::mt19937& random, ExamPerception& perception)
+		{
+			std::uniform_real_distribution<float> position(-50.f, 50.f);
+			std::uniform_real_distribution<float> chance(0.f, 1.f);
+			std::uniform_int_distribution<int> entityCount(0, 6);
+			std::uniform_int_distribution<int> entityType(0, 2);
+
+			perception.agent.Health = 10.f * chance(random);
+			perception.agent.Stamina = chance(random) < 0.2f ? 0.05f : 10.f * chance(random);
+			perception.agent.Bitten = chance(random) < 0.3f;
+			perception.agent.Position = Vector2{ position(random), position(random) };
+			perception.fleeTarget = Vector2{ position(random), position(random) };
+
+			perception.entities.resize(entityCount(random));
+			for (EntityInfo& entity : perception.entities)
+			{
+				entity.Type = static_cast<eEntityType>(entityType(random));
+				entity.Location = Vector2{ position(random), position(random) };
+			}
+		}
+
+		//Hands the perception to a tree's blackboard as the plugin does each tick
+		inline void Perceive(Blackboard* pBlackboard, const ExamPerception& perception)
+		{
+			pBlackboard->TryChangeData(BlackboardKeys::Agent, perception.agent);
+			pBlackboard->TryChangeData(BlackboardKeys::Entities, perception.entities);
+			pBlackboard->TryChangeData(BlackboardKeys::FleeTarget, perception.fleeTarget);
+		}
+		inline void Perceive(ExamAgent& agent, const ExamPerception& perception)
+		{ Perceive(agent.pTree->GetBlackboard(), perception); }
+	}
+}
+#endif
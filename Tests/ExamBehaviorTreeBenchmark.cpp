@@ -0,0 +1,56 @@
+//Ticks per second of the plugin's tree (CreateExamBehavior) as a pointer tree and compiled, for agents deciding on
+//random perceptions. Every agent perceives something new each tick, as the plugin's agent does.
+//Build: cl /std:c++20 /O2 /EHsc /I.. ExamBehaviorTreeBenchmark.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp ../SteeringBehaviors.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. ExamBehaviorTreeBenchmark.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp ../SteeringBehaviors.cpp
+//Needs the plugin's include paths, the behaviors are built on its precompiled header and the exam interface.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include "ExamAgentWorld.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int AgentCount = 64;
+	const unsigned int PerceptionCount = 256; //Drawn up front, so the measurement is the tree and not the random numbers
+	const unsigned int TickCount = 2000;
+
+	//Seconds per agent tick
+	double MeasureTick(bool isCompiled, const std::vector<Test::ExamPerception>& perceptions)
+	{
+		Test::ExamAgent agents[AgentCount];
+		for (Test::ExamAgent& agent : agents)
+		{
+			agent.pTree = new BehaviorTree(Test::CreateExamBlackboard(agent), CreateExamBehavior());
+			if (isCompiled)
+				agent.pTree->Compile();
+		}
+
+		const double seconds = Test::MeasureSeconds(TickCount, [&](unsigned int tick)
+			{
+				for (unsigned int i = 0; i < AgentCount; ++i)
+				{
+					Test::Perceive(agents[i], perceptions[(tick * 7 + i) % PerceptionCount]);
+					agents[i].pTree->Update(1.f / 60.f);
+				}
+			}, 3);
+		return seconds / AgentCount;
+	}
+}
+
+int main()
+{
+	std::mt19937 random(5);
+	std::vector<Test::ExamPerception> perceptions(PerceptionCount);
+	for (Test::ExamPerception& perception : perceptions)
+		Test::RandomizePerception(random, perception);
+
+	const double pointerSeconds = MeasureTick(false, perceptions);
+	const double compiledSeconds = MeasureTick(true, perceptions);
+	printf("%-8s %16s %16s %8s \n", "tree", "pointer tick/s", "compiled tick/s", "speedup");
+	printf("%-8s %16.0f %16.0f %7.2fx \n", "exam", 1.0 / pointerSeconds, 1.0 / compiledSeconds, pointerSeconds / compiledSeconds);
+	return Test::Finish("ExamBehaviorTreeBenchmark");
+}
@@ -0,0 +1,114 @@
+//Cost per angle of FastSinCos and FastAtan2, one at a time and in batches (SSE where compiled in), against std::sin
+//and std::cos, and std::atan2, with the largest error each makes over the measured inputs.
+//Build: cl /std:c++20 /O2 /EHsc /I.. FastMathBenchmark.cpp
+//       g++ -std=c++20 -O2 -I.. FastMathBenchmark.cpp
+
+//=== General Includes ===
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "EFastMath.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const size_t AngleCount = 4096;
+	const unsigned int CallCount = 2000;
+
+	//Largest difference to the double precision results
+	float GetMaxError(const std::vector<float>& values, const std::vector<double>& expected)
+	{
+		double maxError = 0.0;
+		for (size_t i = 0; i < values.size(); ++i)
+			maxError = (std::max)(maxError, std::fabs(values[i] - expected[i]));
+		return static_cast<float>(maxError);
+	}
+
+	void PrintRow(const char* pFunction, double seconds, double libmSeconds, float maxError)
+	{
+		printf("%-20s %10.2f %9.2fx %12.2e \n", pFunction, seconds * 1e9 / AngleCount, libmSeconds / seconds, maxError);
+	}
+}
+
+int main()
+{
+	std::mt19937 random(25);
+	std::uniform_real_distribution<float> angle(-4.f * FastMath::Pi, 4.f * FastMath::Pi);
+	std::uniform_real_distribution<float> coordinate(-100.f, 100.f);
+	std::vector<float> angles(AngleCount);
+	std::vector<float> y(AngleCount);
+	std::vector<float> x(AngleCount);
+	std::vector<double> expectedSin(AngleCount);
+	std::vector<double> expectedCos(AngleCount);
+	std::vector<double> expectedAtan2(AngleCount);
+	for (size_t i = 0; i < AngleCount; ++i)
+	{
+		angles[i] = angle(random);
+		y[i] = coordinate(random);
+		x[i] = coordinate(random);
+		expectedSin[i] = std::sin(static_cast<double>(angles[i]));
+		expectedCos[i] = std::cos(static_cast<double>(angles[i]));
+		expectedAtan2[i] = std::atan2(static_cast<double>(y[i]), static_cast<double>(x[i]));
+	}
+	std::vector<float> sin(AngleCount);
+	std::vector<float> cos(AngleCount);
+	std::vector<float> atan2(AngleCount);
+
+#if ELITE_FAST_MATH_SSE
+	printf("batches: SSE \n");
+#else
+	printf("batches: scalar \n");
+#endif
+	printf("%-20s %10s %10s %12s \n", "ns per angle", "time", "vs libm", "max error");
+
+	//sin and cos
+	const double libmSinCosSeconds = Test::MeasureSeconds(CallCount, [&](unsigned int)
+		{
+			for (size_t i = 0; i < AngleCount; ++i)
+			{
+				sin[i] = std::sin(angles[i]);
+				cos[i] = std::cos(angles[i]);
+			}
+		});
+	PrintRow("std::sin, std::cos", libmSinCosSeconds, libmSinCosSeconds, (std::max)(GetMaxError(sin, expectedSin), GetMaxError(cos, expectedCos)));
+
+	const double sinCosSeconds = Test::MeasureSeconds(CallCount, [&](unsigned int)
+		{
+			for (size_t i = 0; i < AngleCount; ++i)
+				FastSinCos(angles[i], sin[i], cos[i]);
+		});
+	PrintRow("FastSinCos", sinCosSeconds, libmSinCosSeconds, (std::max)(GetMaxError(sin, expectedSin), GetMaxError(cos, expectedCos)));
+
+	const double sinCosBatchSeconds = Test::MeasureSeconds(CallCount, [&](unsigned int)
+		{
+			FastSinCos(angles.data(), sin.data(), cos.data(), AngleCount);
+		});
+	PrintRow("FastSinCos (batch)", sinCosBatchSeconds, libmSinCosSeconds, (std::max)(GetMaxError(sin, expectedSin), GetMaxError(cos, expectedCos)));
+
+	//atan2
+	const double libmAtan2Seconds = Test::MeasureSeconds(CallCount, [&](unsigned int)
+		{
+			for (size_t i = 0; i < AngleCount; ++i)
+				atan2[i] = std::atan2(y[i], x[i]);
+		});
+	PrintRow("std::atan2", libmAtan2Seconds, libmAtan2Seconds, GetMaxError(atan2, expectedAtan2));
+
+	const double atan2Seconds = Test::MeasureSeconds(CallCount, [&](unsigned int)
+		{
+			for (size_t i = 0; i < AngleCount; ++i)
+				atan2[i] = FastAtan2(y[i], x[i]);
+		});
+	PrintRow("FastAtan2", atan2Seconds, libmAtan2Seconds, GetMaxError(atan2, expectedAtan2));
+
+	const double atan2BatchSeconds = Test::MeasureSeconds(CallCount, [&](unsigned int)
+		{
+			FastAtan2(y.data(), x.data(), atan2.data(), AngleCount);
+		});
+	PrintRow("FastAtan2 (batch)", atan2BatchSeconds, libmAtan2Seconds, GetMaxError(atan2, expectedAtan2));
+
+	Test::KeepAlive(sin[AngleCount / 2] + cos[AngleCount / 2] + atan2[AngleCount / 2]);
+	return Test::Finish("FastMathBenchmark");
+}
@@ -0,0 +1,161 @@
+//FastSin, FastCos, FastSinCos and FastAtan2, one at a time and in batches (SSE where compiled in), against std::sin,
+//std::cos and std::atan2 in double precision: the error bounds of EFastMath.h, the signed zeros of atan2, and angles
+//far from 0 up to the largest floats, which have to come out as a sine and cosine still.
+//Build: cl /std:c++20 /O2 /EHsc /I.. FastMathTest.cpp
+//       g++ -std=c++20 -O2 -I.. FastMathTest.cpp
+
+//=== General Includes ===
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "EFastMath.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const float SinCosBound = 2.2e-7f; //Within a few turns of 0
+	const float Atan2Bound = 2.0e-6f;
+	const float SinCosBoundAtMillion = 3.5e-2f; //Around 1e6 radians
+
+	//Largest error of the scalar and the batch versions over 'angles'
+	void GetSinCosError(const std::vector<float>& angles, float& scalarError, float& batchError)
+	{
+		std::vector<float> sin(angles.size());
+		std::vector<float> cos(angles.size());
+		FastSinCos(angles.data(), sin.data(), cos.data(), angles.size());
+
+		scalarError = 0.f;
+		batchError = 0.f;
+		for (size_t i = 0; i < angles.size(); ++i)
+		{
+			const double expectedSin = std::sin(static_cast<double>(angles[i]));
+			const double expectedCos = std::cos(static_cast<double>(angles[i]));
+			float scalarSin = 0.f;
+			float scalarCos = 0.f;
+			FastSinCos(angles[i], scalarSin, scalarCos);
+			scalarError = (std::max)(scalarError, static_cast<float>((std::max)(std::fabs(scalarSin - expectedSin), std::fabs(scalarCos - expectedCos))));
+			scalarError = (std::max)(scalarError, static_cast<float>(std::fabs(FastSin(angles[i]) - expectedSin)));
+			scalarError = (std::max)(scalarError, static_cast<float>(std::fabs(FastCos(angles[i]) - expectedCos)));
+			batchError = (std::max)(batchError, static_cast<float>((std::max)(std::fabs(sin[i] - expectedSin), std::fabs(cos[i] - expectedCos))));
+		}
+	}
+
+	void TestSinCos()
+	{
+		//Densely over four turns either way
+		std::vector<float> angles;
+		for (float angle = -8.f * FastMath::Pi; angle <= 8.f * FastMath::Pi; angle += 1e-4f)
+			angles.push_back(angle);
+		float scalarError = 0.f;
+		float batchError = 0.f;
+		GetSinCosError(angles, scalarError, batchError);
+		printf("sin/cos within 4 turns: max error %.2e scalar, %.2e batch \n", scalarError, batchError);
+		ELITE_CHECK(scalarError <= SinCosBound);
+		ELITE_CHECK(batchError <= SinCosBound);
+
+		//Around 1e6 radians
+		angles.clear();
+		for (float angle = 1e6f; angle < 1e6f + 100.f; angle += 1.f / 16.f)
+			angles.push_back(angle);
+		GetSinCosError(angles, scalarError, batchError);
+		printf("sin/cos around 1e6: max error %.2e scalar, %.2e batch \n", scalarError, batchError);
+		ELITE_CHECK(scalarError <= SinCosBoundAtMillion);
+		ELITE_CHECK(batchError <= SinCosBoundAtMillion);
+
+		//Beyond FastMath::WholeTurns turns, up to the largest float: meaningless, but a sine and cosine nonetheless
+		angles.clear();
+		for (float angle = 1e9f; angle < FLT_MAX / 2.f; angle *= 3.7f)
+		{
+			angles.push_back(angle);
+			angles.push_back(-angle);
+		}
+		angles.push_back(FLT_MAX);
+		angles.push_back(-FLT_MAX);
+		std::vector<float> sin(angles.size());
+		std::vector<float> cos(angles.size());
+		FastSinCos(angles.data(), sin.data(), cos.data(), angles.size());
+		for (size_t i = 0; i < angles.size(); ++i)
+		{
+			float scalarSin = 0.f;
+			float scalarCos = 0.f;
+			FastSinCos(angles[i], scalarSin, scalarCos);
+			for (float value : { scalarSin, scalarCos, sin[i], cos[i] })
+				ELITE_CHECK(std::fabs(value) <= 1.f + SinCosBound);
+		}
+
+		//Infinity and NaN give NaN
+		const float invalidAngles[4] = { INFINITY, -INFINITY, NAN, 0.f };
+		float invalidSin[4] = {};
+		float invalidCos[4] = {};
+		FastSinCos(invalidAngles, invalidSin, invalidCos, 4);
+		for (size_t i = 0; i < 3; ++i)
+		{
+			ELITE_CHECK(std::isnan(FastSin(invalidAngles[i])) && std::isnan(FastCos(invalidAngles[i])));
+			ELITE_CHECK(std::isnan(invalidSin[i]) && std::isnan(invalidCos[i]));
+		}
+	}
+
+	void TestAtan2()
+	{
+		//Every combination of signed zeros first, so the SSE version gets them as one group of four
+		std::vector<float> y;
+		std::vector<float> x;
+		for (float zeroY : { 0.f, -0.f })
+		{
+			for (float zeroX : { 0.f, -0.f })
+			{
+				y.push_back(zeroY);
+				x.push_back(zeroX);
+			}
+		}
+		//Points on circles of a few radii, every direction, and the axes
+		for (float radius : { 1e-30f, 1e-3f, 1.f, 1e3f, 1e30f })
+		{
+			for (float angle = -FastMath::Pi; angle <= FastMath::Pi; angle += 1e-4f)
+			{
+				y.push_back(radius * static_cast<float>(std::sin(angle)));
+				x.push_back(radius * static_cast<float>(std::cos(angle)));
+			}
+			for (float axisY : { -radius, 0.f, radius })
+			{
+				for (float axisX : { -radius, 0.f, radius })
+				{
+					y.push_back(axisY);
+					x.push_back(axisX);
+				}
+			}
+		}
+
+		std::vector<float> angles(y.size());
+		FastAtan2(y.data(), x.data(), angles.data(), y.size());
+		float scalarError = 0.f;
+		float batchError = 0.f;
+		for (size_t i = 0; i < y.size(); ++i)
+		{
+			const double expected = std::atan2(static_cast<double>(y[i]), static_cast<double>(x[i]));
+			scalarError = (std::max)(scalarError, static_cast<float>(std::fabs(FastAtan2(y[i], x[i]) - expected)));
+			batchError = (std::max)(batchError, static_cast<float>(std::fabs(angles[i] - expected)));
+		}
+		printf("atan2: max error %.2e scalar, %.2e batch \n", scalarError, batchError);
+		ELITE_CHECK(scalarError <= Atan2Bound);
+		ELITE_CHECK(batchError <= Atan2Bound);
+
+		//The signs of zero results match too
+		for (size_t i = 0; i < 4; ++i)
+		{
+			const float expected = std::atan2(y[i], x[i]);
+			ELITE_CHECK(std::signbit(FastAtan2(y[i], x[i])) == std::signbit(expected));
+			ELITE_CHECK(std::signbit(angles[i]) == std::signbit(expected));
+		}
+	}
+}
+
+int main()
+{
+	TestSinCos();
+	TestAtan2();
+	return Test::Finish("FastMathTest");
+}
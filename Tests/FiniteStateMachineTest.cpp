@@ -0,0 +1,108 @@
+//FiniteStateMachine with overlapping any state transitions: they take priority in the order they were added, like the
+//children of the tree's top selector. While the machine is in a state whose any state guards hold, one added after
+//it doesn't pull it away, and one added before it still does.
+//Build: cl /std:c++20 /O2 /EHsc /I.. FiniteStateMachineTest.cpp ../EFiniteStateMachine.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. FiniteStateMachineTest.cpp ../EFiniteStateMachine.cpp
+//Needs the plugin's include paths, the machine is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include "EFiniteStateMachine.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	bool g_IsUrgent = false; //Guards the state added first
+	bool g_IsTired = false; //Guards the one added after it
+	unsigned int g_LastActionState = 0xFFFFFFFF; //State whose action ran last
+
+	bool IsUrgent(Blackboard*) { return g_IsUrgent; }
+	bool IsTired(Blackboard*) { return g_IsTired; }
+
+	template<unsigned int State> BehaviorState RunState(Blackboard*)
+	{
+		g_LastActionState = State;
+		return Success;
+	}
+
+	const unsigned int Explore = 0;
+	const unsigned int Urgent = 1;
+	const unsigned int Rest = 2;
+
+	//Explore, and the two states any state can go to, each leaving to explore once its guard no longer holds
+	FiniteStateMachine* CreateMachine()
+	{
+		FiniteStateMachine* pFSM = new FiniteStateMachine(new Blackboard());
+		pFSM->AddState({ RunState<Explore> });
+		pFSM->AddState({ RunState<Urgent> });
+		pFSM->AddState({ RunState<Rest> });
+
+		pFSM->AddAnyStateTransition(Urgent, { When(IsUrgent) });
+		pFSM->AddAnyStateTransition(Rest, { When(IsTired) });
+		pFSM->AddTransition(Urgent, Explore, { Unless(IsUrgent) });
+		pFSM->AddTransition(Rest, Explore, { Unless(IsTired) });
+		pFSM->Compile();
+		return pFSM;
+	}
+
+	//Ticks the machine and checks the state it ends in ran its action
+	void Tick(FiniteStateMachine* pFSM, unsigned int expectedState)
+	{
+		pFSM->Update(1.f / 60.f);
+		ELITE_CHECK(pFSM->GetCurrentState() == expectedState);
+		ELITE_CHECK(g_LastActionState == expectedState);
+	}
+
+	//Both guards hold: the first one added wins and keeps winning, the machine doesn't flip between the two
+	void TestBothGuardsHold()
+	{
+		FiniteStateMachine* pFSM = CreateMachine();
+		g_IsUrgent = true;
+		g_IsTired = true;
+		for (unsigned int tick = 0; tick < 10; ++tick)
+			Tick(pFSM, Urgent);
+		ELITE_CHECK(pFSM->GetTransitionCount() == 1);
+
+		//Also when it got to the lower priority state first
+		pFSM->SetState(Rest);
+		for (unsigned int tick = 0; tick < 10; ++tick)
+			Tick(pFSM, Urgent);
+		ELITE_CHECK(pFSM->GetTransitionCount() == 2);
+		delete pFSM;
+	}
+
+	//The state added later holds the machine until the earlier one's guard holds too, and takes over when that one's stops
+	void TestPriorityChanges()
+	{
+		FiniteStateMachine* pFSM = CreateMachine();
+		g_IsUrgent = false;
+		g_IsTired = true;
+		Tick(pFSM, Rest);
+		Tick(pFSM, Rest);
+
+		g_IsUrgent = true;
+		Tick(pFSM, Urgent);
+		Tick(pFSM, Urgent);
+
+		//The state's own guard stopped holding, the next any state transition is taken right away
+		g_IsUrgent = false;
+		Tick(pFSM, Rest);
+
+		//Neither holds, the state's own transition leaves it
+		g_IsTired = false;
+		Tick(pFSM, Explore);
+		Tick(pFSM, Explore);
+		ELITE_CHECK(pFSM->GetTransitionCount() == 4);
+		delete pFSM;
+	}
+}
+
+int main()
+{
+	TestBothGuardsHold();
+	TestPriorityChanges();
+	return Test::Finish("FiniteStateMachineTest");
+}
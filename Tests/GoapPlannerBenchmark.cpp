@@ -0,0 +1,106 @@
+//Microseconds per GoapPlanner::Plan, searched and from the plan cache, on the plugin's planner (its facts, actions and
+//goals as built in Plugin.cpp) and on a world where a plan can take searching a thousand states, from every
+//combination of their facts.
+//Build: cl /std:c++20 /O2 /EHsc /I.. GoapPlannerBenchmark.cpp ../EGoapPlanner.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. GoapPlannerBenchmark.cpp ../EGoapPlanner.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the planner is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "EGoapPlanner.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int CallCount = 20000;
+
+	//Plugin.cpp's planner, without the conditionals and actions, planning doesn't run them
+	unsigned int BuildExamPlanner(GoapPlanner& goap)
+	{
+		const unsigned int inPurgeZone = goap.AddFact(nullptr);
+		const unsigned int needsMedkit = goap.AddFact(nullptr);
+		const unsigned int needsFood = goap.AddFact(nullptr);
+		const unsigned int enemyInFov = goap.AddFact(nullptr);
+		const unsigned int hasStamina = goap.AddFact(nullptr);
+		const unsigned int canKillEnemy = goap.AddFact(nullptr);
+		const unsigned int itemInFov = goap.AddFact(nullptr);
+		const unsigned int inGrabRange = goap.AddFact(nullptr);
+		const unsigned int inventoryFull = goap.AddFact(nullptr);
+
+		goap.AddAction("ChangeToFlee", nullptr, 1.f, { { inPurgeZone, true } }, { { inPurgeZone, false } });
+		goap.AddAction("UseMedkit", nullptr, 1.f, { { needsMedkit, true } }, { { needsMedkit, false } });
+		goap.AddAction("UseFood", nullptr, 1.f, { { needsFood, true } }, { { needsFood, false } });
+		goap.AddAction("ShootClosestEnemy", nullptr, 1.f, { { enemyInFov, true }, { canKillEnemy, true } }, { { enemyInFov, false } });
+		goap.AddAction("RunFlee", nullptr, 2.f, { { enemyInFov, true }, { hasStamina, true } }, { { enemyInFov, false } });
+		goap.AddAction("SeekItems", nullptr, 1.f, { { itemInFov, true } }, { { inGrabRange, true } });
+		goap.AddAction("GrabItem", nullptr, 1.f, { { inGrabRange, true } }, { { inventoryFull, true } });
+		goap.AddAction("ScoutWander", nullptr, 5.f, {}, { { itemInFov, true } });
+
+		goap.AddGoal("EscapePurgeZone", { { inPurgeZone, false } });
+		goap.AddGoal("Heal", { { needsMedkit, false } });
+		goap.AddGoal("Eat", { { needsFood, false } });
+		goap.AddGoal("EscapeEnemy", { { enemyInFov, false } });
+		goap.AddGoal("Loot", { { inventoryFull, true } });
+		goap.Compile();
+		return 9;
+	}
+
+	//Ten facts set by one action each and a goal that needs all of them, 1024 states to search
+	unsigned int BuildWideWorldPlanner(GoapPlanner& goap)
+	{
+		std::vector<GoapFact> allFacts;
+		for (unsigned int i = 0; i < 10; ++i)
+		{
+			const unsigned int fact = goap.AddFact(nullptr);
+			goap.AddAction("Set" + std::to_string(i), nullptr, 1.f, {}, { { fact, true } });
+			allFacts.push_back({ fact, true });
+		}
+		const unsigned int done = goap.AddFact(nullptr);
+		goap.AddAction("Finish", nullptr, 1.f, allFacts, { { done, true } });
+		goap.AddGoal("Done", { { done, true } });
+		goap.Compile();
+		return 10; //From nothing set the search goes through all 1024 states, with everything set it's one action
+	}
+
+	//Plans every goal from each world state in turn: more situations than the plan cache holds, so every call searches.
+	//Then every goal from one world state, found in the cache after the first call.
+	void Measure(const char* pName, unsigned int(*fpBuild)(GoapPlanner&), unsigned int goalCount)
+	{
+		GoapPlanner goap(new Blackboard());
+		const unsigned int factCount = fpBuild(goap);
+		const unsigned int stateCount = 1u << factCount;
+		unsigned int plan[GoapPlanner::MaxPlanLength] = {};
+		unsigned int planLength = 0;
+		unsigned int planLengths = 0;
+
+		const double searchSeconds = Test::MeasureSeconds(CallCount, [&](unsigned int i)
+			{
+				goap.Plan(static_cast<uint64_t>((i / goalCount) % stateCount), i % goalCount, plan, planLength);
+				planLengths += planLength;
+			});
+		const unsigned int searchCount = goap.GetSearchCount();
+
+		const double cachedSeconds = Test::MeasureSeconds(CallCount, [&](unsigned int i)
+			{
+				goap.Plan(0, i % goalCount, plan, planLength);
+				planLengths += planLength;
+			});
+
+		printf("%-12s %10.3f %10.3f %10u \n", pName, searchSeconds * 1e6, cachedSeconds * 1e6, searchCount);
+		Test::KeepAlive(planLengths);
+	}
+}
+
+int main()
+{
+	printf("us per plan \n");
+	printf("%-12s %10s %10s %10s \n", "planner", "searched", "cached", "searches");
+	Measure("exam", BuildExamPlanner, 5);
+	Measure("wide world", BuildWideWorldPlanner, 1);
+	return Test::Finish("GoapPlannerBenchmark");
+}
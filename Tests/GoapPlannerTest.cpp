@@ -0,0 +1,228 @@
+//GoapPlanner on a small crafting world: the cheapest plans, a plan followed over the ticks and dropped when its next
+//action's precondition flips, the plan cache (hit on the same relevant facts, missed when one of them flips, not
+//missed on a fact nothing looks at), and the search node limit on a world with more states than it allows.
+//Build: cl /std:c++20 /O2 /EHsc /I.. GoapPlannerTest.cpp ../EGoapPlanner.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. GoapPlannerTest.cpp ../EGoapPlanner.cpp ../EBehaviorTree.cpp ../ETimingWheel.cpp
+//Needs the plugin's include paths, the planner is built on its precompiled header.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "EGoapPlanner.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	//The world the facts are sensed from and the actions change
+	bool g_HasAxe = false;
+	bool g_HasWood = false;
+	bool g_HasFire = false;
+	bool g_IsRaining = false; //Sensed, but no precondition or goal looks at it
+	std::vector<std::string> g_RanActions;
+
+	bool HasAxe(Blackboard*) { return g_HasAxe; }
+	bool HasWood(Blackboard*) { return g_HasWood; }
+	bool HasFire(Blackboard*) { return g_HasFire; }
+	bool IsRaining(Blackboard*) { return g_IsRaining; }
+
+	BehaviorState GetAxe(Blackboard*) { g_RanActions.push_back("GetAxe"); g_HasAxe = true; return Success; }
+	BehaviorState ChopWood(Blackboard*) { g_RanActions.push_back("ChopWood"); g_HasWood = true; return Success; }
+	BehaviorState GatherWood(Blackboard*) { g_RanActions.push_back("GatherWood"); g_HasWood = true; return Success; }
+	BehaviorState MakeFire(Blackboard*) { g_RanActions.push_back("MakeFire"); g_HasWood = false; g_HasFire = true; return Success; }
+	BehaviorState Idle(Blackboard*) { g_RanActions.push_back("Idle"); return Success; }
+
+	void ResetWorld()
+	{
+		g_HasAxe = false;
+		g_HasWood = false;
+		g_HasFire = false;
+		g_IsRaining = false;
+		g_RanActions.clear();
+	}
+
+	struct CraftingPlanner
+	{
+		GoapPlanner* pGoap = nullptr;
+		unsigned int hasAxe = 0;
+		unsigned int hasWood = 0;
+		unsigned int hasFire = 0;
+		unsigned int isRaining = 0;
+		unsigned int getAxe = 0;
+		unsigned int chopWood = 0;
+		unsigned int gatherWood = 0;
+		unsigned int makeFire = 0;
+		unsigned int makeFireGoal = 0;
+	};
+
+	//Chopping wood with an axe costs 3 in all, gathering it by hand 5
+	CraftingPlanner CreateCraftingPlanner()
+	{
+		CraftingPlanner planner;
+		planner.pGoap = new GoapPlanner(new Blackboard());
+		GoapPlanner* pGoap = planner.pGoap;
+		planner.hasAxe = pGoap->AddFact(HasAxe);
+		planner.hasWood = pGoap->AddFact(HasWood);
+		planner.hasFire = pGoap->AddFact(HasFire);
+		planner.isRaining = pGoap->AddFact(IsRaining);
+
+		planner.getAxe = pGoap->AddAction("GetAxe", GetAxe, 2.f, {}, { { planner.hasAxe, true } });
+		planner.chopWood = pGoap->AddAction("ChopWood", ChopWood, 1.f, { { planner.hasAxe, true } }, { { planner.hasWood, true } });
+		planner.gatherWood = pGoap->AddAction("GatherWood", GatherWood, 5.f, {}, { { planner.hasWood, true } });
+		planner.makeFire = pGoap->AddAction("MakeFire", MakeFire, 1.f, { { planner.hasWood, true } }, { { planner.hasWood, false }, { planner.hasFire, true } });
+		planner.makeFireGoal = pGoap->AddGoal("MakeFire", { { planner.hasFire, true } });
+		pGoap->SetIdleAction(Idle);
+		pGoap->Compile();
+		return planner;
+	}
+
+	bool IsPlan(const unsigned int* pPlan, unsigned int planLength, const std::vector<unsigned int>& expected)
+	{
+		return planLength == expected.size() && std::equal(expected.begin(), expected.end(), pPlan);
+	}
+
+	//The cheapest plan from a few starting states
+	void TestPlans()
+	{
+		CraftingPlanner planner = CreateCraftingPlanner();
+		GoapPlanner* pGoap = planner.pGoap;
+		const uint64_t axe = 1ULL << planner.hasAxe;
+		const uint64_t wood = 1ULL << planner.hasWood;
+		const uint64_t fire = 1ULL << planner.hasFire;
+		unsigned int plan[GoapPlanner::MaxPlanLength] = {};
+		unsigned int planLength = 0;
+
+		ELITE_CHECK(pGoap->Plan(0, planner.makeFireGoal, plan, planLength));
+		ELITE_CHECK(IsPlan(plan, planLength, { planner.getAxe, planner.chopWood, planner.makeFire }));
+		ELITE_CHECK(pGoap->Plan(axe, planner.makeFireGoal, plan, planLength));
+		ELITE_CHECK(IsPlan(plan, planLength, { planner.chopWood, planner.makeFire }));
+		ELITE_CHECK(pGoap->Plan(wood, planner.makeFireGoal, plan, planLength));
+		ELITE_CHECK(IsPlan(plan, planLength, { planner.makeFire }));
+
+		//A met goal needs no actions
+		ELITE_CHECK(pGoap->Plan(fire, planner.makeFireGoal, plan, planLength));
+		ELITE_CHECK(planLength == 0);
+
+		//A goal no action leads to
+		const unsigned int noRainGoal = pGoap->AddGoal("StopRain", { { planner.isRaining, false } });
+		ELITE_CHECK(!pGoap->Plan(1ULL << planner.isRaining, noRainGoal, plan, planLength));
+		ELITE_CHECK(planLength == 0);
+		delete pGoap;
+	}
+
+	//Update follows the plan tick after tick without searching again, and drops it once the next action can't run
+	void TestPlanFollowing()
+	{
+		ResetWorld();
+		CraftingPlanner planner = CreateCraftingPlanner();
+		GoapPlanner* pGoap = planner.pGoap;
+
+		pGoap->Update(0.1f);
+		ELITE_CHECK(pGoap->GetSearchCount() == 1);
+		ELITE_CHECK(pGoap->GetCurrentGoal() == planner.makeFireGoal);
+		pGoap->Update(0.1f);
+		//The axe breaks: chopping can't run any more, the rest of the plan is dropped
+		g_HasAxe = false;
+		g_HasWood = false;
+		pGoap->Update(0.1f);
+		//Back where it started, the plan comes from the cache
+		ELITE_CHECK(pGoap->GetSearchCount() == 1);
+		ELITE_CHECK(pGoap->GetCacheHitCount() == 1);
+		pGoap->Update(0.1f);
+		pGoap->Update(0.1f);
+		//The fire is lit, nothing left to do
+		pGoap->Update(0.1f);
+		ELITE_CHECK(pGoap->GetCurrentAction() == GoapPlanner::InvalidIndex);
+		ELITE_CHECK(pGoap->GetSearchCount() == 1);
+
+		const std::vector<std::string> expected = { "GetAxe", "ChopWood", "GetAxe", "ChopWood", "MakeFire", "Idle" };
+		ELITE_CHECK(g_RanActions == expected);
+		delete pGoap;
+	}
+
+	//Plans are cached by goal and the facts any precondition or goal looks at
+	void TestPlanCache()
+	{
+		CraftingPlanner planner = CreateCraftingPlanner();
+		GoapPlanner* pGoap = planner.pGoap;
+		const uint64_t axe = 1ULL << planner.hasAxe;
+		const uint64_t rain = 1ULL << planner.isRaining;
+		unsigned int plan[GoapPlanner::MaxPlanLength] = {};
+		unsigned int planLength = 0;
+
+		pGoap->Plan(0, planner.makeFireGoal, plan, planLength);
+		ELITE_CHECK(pGoap->GetSearchCount() == 1 && pGoap->GetCacheHitCount() == 0);
+		pGoap->Plan(0, planner.makeFireGoal, plan, planLength);
+		ELITE_CHECK(pGoap->GetSearchCount() == 1 && pGoap->GetCacheHitCount() == 1);
+
+		//A fact nothing looks at can't change the plan
+		pGoap->Plan(rain, planner.makeFireGoal, plan, planLength);
+		ELITE_CHECK(pGoap->GetSearchCount() == 1 && pGoap->GetCacheHitCount() == 2);
+		ELITE_CHECK(IsPlan(plan, planLength, { planner.getAxe, planner.chopWood, planner.makeFire }));
+
+		//A precondition's fact flipped: searched again, to a different plan
+		pGoap->Plan(axe, planner.makeFireGoal, plan, planLength);
+		ELITE_CHECK(pGoap->GetSearchCount() == 2 && pGoap->GetCacheHitCount() == 2);
+		ELITE_CHECK(IsPlan(plan, planLength, { planner.chopWood, planner.makeFire }));
+
+		//Both stay cached, until more situations than the cache holds push them out
+		pGoap->Plan(0, planner.makeFireGoal, plan, planLength);
+		pGoap->Plan(axe, planner.makeFireGoal, plan, planLength);
+		ELITE_CHECK(pGoap->GetSearchCount() == 2 && pGoap->GetCacheHitCount() == 4);
+
+		//Goals without a plan are cached as well
+		const unsigned int noRainGoal = pGoap->AddGoal("StopRain", { { planner.isRaining, false } });
+		pGoap->Compile();
+		const unsigned int searchCount = pGoap->GetSearchCount();
+		ELITE_CHECK(!pGoap->Plan(rain, noRainGoal, plan, planLength));
+		ELITE_CHECK(!pGoap->Plan(rain, noRainGoal, plan, planLength));
+		ELITE_CHECK(pGoap->GetSearchCount() == searchCount + 1);
+		delete pGoap;
+	}
+
+	//Independent facts, one action each, and a goal that needs all of them: every combination of facts is a state the
+	//search can get to before it finds the goal
+	bool PlanAllFacts(unsigned int factCount, unsigned int& planLength)
+	{
+		GoapPlanner goap(new Blackboard());
+		std::vector<GoapFact> allFacts;
+		for (unsigned int i = 0; i < factCount; ++i)
+		{
+			const unsigned int fact = goap.AddFact(nullptr);
+			goap.AddAction("Set" + std::to_string(i), nullptr, 1.f, {}, { { fact, true } });
+			allFacts.push_back({ fact, true });
+		}
+		const unsigned int done = goap.AddFact(nullptr);
+		goap.AddAction("Finish", nullptr, 1.f, allFacts, { { done, true } });
+		const unsigned int goal = goap.AddGoal("Done", { { done, true } });
+		goap.Compile();
+
+		unsigned int plan[GoapPlanner::MaxPlanLength] = {};
+		return goap.Plan(0, goal, plan, planLength);
+	}
+
+	void TestSearchNodeLimit()
+	{
+		//1024 states fit in the search nodes
+		unsigned int planLength = 0;
+		ELITE_CHECK(PlanAllFacts(10, planLength));
+		ELITE_CHECK(planLength == 11);
+
+		//16384 don't: the search gives up instead of growing its storage, though the plan would be 15 actions long
+		ELITE_CHECK(!PlanAllFacts(14, planLength));
+		ELITE_CHECK(planLength == 0);
+	}
+}
+
+int main()
+{
+	TestPlans();
+	TestPlanFollowing();
+	TestPlanCache();
+	TestSearchNodeLimit();
+	return Test::Finish("GoapPlannerTest");
+}
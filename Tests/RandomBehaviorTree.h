@@ -0,0 +1,193 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// RandomBehaviorTree.h: Random behavior trees for the tests and benchmarks of the BehaviorTree.
+// The leaves are plain functions, so a compiled tree calls them directly, and their results follow
+// a script that is the same for every tree: a tree built twice from the same seed makes the same
+// decisions, compiled or not, and records the leaves it ran in the trace.
+/*=============================================================================*/
+#ifndef ELITE_TEST_RANDOM_BEHAVIOR_TREE
+#define ELITE_TEST_RANDOM_BEHAVIOR_TREE
+
+//--- Includes ---
+#include <random>
+#include <utility>
+#include <vector>
+#include "EBehaviorTree.h"
+
+namespace Elite
+{
+	namespace Test
+	{
+		const unsigned int RandomLeafCount = 64;
+
+		//The tick the leaves answer for, and the leaves that ran in it, set by whoever updates the trees
+		struct RandomTreeScript
+		{
+			unsigned int tick = 0;
+			unsigned int seed = 0;
+			std::vector<unsigned int>* pTrace = nullptr;
+		};
+
+		inline RandomTreeScript& GetRandomTreeScript()
+		{
+			static RandomTreeScript script = {};
+			return script;
+		}
+
+		//Blackboard key the observing conditionals read, the driver changes it every few ticks
+		inline const char* GetRandomTreeInputName() { return "Input"; }
+
+		//Same answer for the same leaf, tick and seed
+		inline unsigned int HashLeaf(unsigned int leaf, unsigned int tick)
+		{
+			unsigned int hash = (leaf + 1) * 0x9E3779B1u ^ (tick + 1) * 0x85EBCA77u ^ GetRandomTreeScript().seed;
+			hash ^= hash >> 15;
+			hash *= 0x2C1B3C6Du;
+			hash ^= hash >> 12;
+			return hash;
+		}
+
+		inline void TraceLeaf(unsigned int leaf, unsigned int result)
+		{
+			if (GetRandomTreeScript().pTrace != nullptr)
+				GetRandomTreeScript().pTrace->push_back((leaf << 2) | result);
+		}
+
+		template<unsigned int Leaf> bool RandomConditional(Blackboard*)
+		{
+			const bool result = (HashLeaf(Leaf, GetRandomTreeScript().tick) & 1) != 0;
+			TraceLeaf(Leaf, result ? 1 : 0);
+			return result;
+		}
+
+		//Only depends on the blackboard, as an observing conditional has to
+		template<unsigned int Leaf> bool RandomObservingConditional(Blackboard* pBlackboard)
+		{
+			unsigned int input = 0;
+			pBlackboard->TryGetData(GetRandomTreeInputName(), input);
+			const bool result = (HashLeaf(Leaf, input) & 1) != 0;
+			TraceLeaf(Leaf, result ? 1 : 0);
+			return result;
+		}
+
+		template<unsigned int Leaf> BehaviorState RandomAction(Blackboard*)
+		{
+			const BehaviorState result = static_cast<BehaviorState>(HashLeaf(Leaf, GetRandomTreeScript().tick) % 3);
+			TraceLeaf(Leaf, static_cast<unsigned int>(result));
+			return result;
+		}
+
+		template<unsigned int... Leaves> std::vector<bool(*)(Blackboard*)> GetRandomConditionals(std::integer_sequence<unsigned int, Leaves...>)
+		{ return { &RandomConditional<Leaves>... }; }
+		template<unsigned int... Leaves> std::vector<bool(*)(Blackboard*)> GetRandomObservingConditionals(std::integer_sequence<unsigned int, Leaves...>)
+		{ return { &RandomObservingConditional<Leaves>... }; }
+		template<unsigned int... Leaves> std::vector<BehaviorState(*)(Blackboard*)> GetRandomActions(std::integer_sequence<unsigned int, Leaves...>)
+		{ return { &RandomAction<Leaves>... }; }
+
+		//Builds a random tree of every composite and decorator the compiler flattens. The timed decorators' delays are
+		//a few ticks of the tree's wheel, so they expire within a run. 'leafCount' is roughly the number of leaves,
+		//the same seed builds the same tree.
+		//With 'isResumeExact' every child of a sequence ahead of its last one is a plain conditional, the only children a
+		//tree resuming its running path skips, so it decides exactly as the same tree running from the root.
+		class RandomBehaviorTreeBuilder final
+		{
+		public:
+			explicit RandomBehaviorTreeBuilder(unsigned int seed, bool isResumeExact = false)
+				: m_Random(seed)
+				, m_IsResumeExact(isResumeExact)
+				, m_Conditionals(GetRandomConditionals(std::make_integer_sequence<unsigned int, RandomLeafCount>{}))
+				, m_ObservingConditionals(GetRandomObservingConditionals(std::make_integer_sequence<unsigned int, RandomLeafCount>{}))
+				, m_Actions(GetRandomActions(std::make_integer_sequence<unsigned int, RandomLeafCount>{}))
+			{}
+
+			//The blackboard needs the input before the tree is built, the observing conditionals resolve it
+			IBehavior* Build(Blackboard* pBlackboard, unsigned int leafCount)
+			{
+				m_InputSlot = pBlackboard->GetKey<unsigned int>(GetRandomTreeInputName()).GetIndex();
+				m_LeafBudget = leafCount;
+				return BuildComposite(0);
+			}
+
+		private:
+			IBehavior* BuildComposite(unsigned int depth)
+			{
+				const unsigned int type = Pick(5);
+				const unsigned int childCount = 2 + Pick(4);
+				std::vector<IBehavior*> children = {};
+				for (unsigned int i = 0; i < childCount; ++i)
+				{
+					if (m_IsResumeExact && type == 1 && i + 1 < childCount)
+					{
+						children.push_back(BuildLeaf(true));
+						continue;
+					}
+
+					const bool isLeaf = depth >= 8 || m_LeafBudget <= childCount || Pick(4) == 0;
+					IBehavior* pChild = isLeaf ? BuildLeaf() : BuildComposite(depth + 1);
+					if (Pick(4) == 0)
+						pChild = BuildDecorator(pChild);
+					children.push_back(pChild);
+				}
+
+				switch (type)
+				{
+				case 0: return new BehaviorSelector(children);
+				case 1: return new BehaviorSequence(children);
+				case 2: return new BehaviorPartialSequence(children);
+				case 3: return new BehaviorMemorySelector(children);
+				default: return new BehaviorMemorySequence(children);
+				}
+			}
+
+			IBehavior* BuildDecorator(IBehavior* pChild)
+			{
+				switch (Pick(6))
+				{
+				case 0: return new BehaviorCooldown(pChild, 0.05f * (1 + Pick(4)));
+				case 1: return new BehaviorTimeout(pChild, 0.05f * (1 + Pick(4)));
+				case 2: return new BehaviorRateLimit(pChild, 1 + Pick(3), 0.05f * (1 + Pick(4)));
+				case 3: return new BehaviorRepeater(pChild, Pick(3));
+				default: return new BehaviorInverter(pChild);
+				}
+			}
+
+			IBehavior* BuildLeaf(bool isConditional = false)
+			{
+				if (m_LeafBudget > 0)
+					--m_LeafBudget;
+				const unsigned int leaf = Pick(RandomLeafCount);
+				switch (Pick(isConditional ? 2 : 3))
+				{
+				case 0: return new BehaviorConditional(m_Conditionals[leaf]);
+				case 1: return new BehaviorConditional(m_ObservingConditionals[leaf], std::vector<unsigned int>{ m_InputSlot });
+				default: return new BehaviorAction(m_Actions[leaf]);
+				}
+			}
+
+			unsigned int Pick(unsigned int count)
+			{ return std::uniform_int_distribution<unsigned int>(0, count - 1)(m_Random); }
+
+			std::mt19937 m_Random;
+			bool m_IsResumeExact = false;
+			std::vector<bool(*)(Blackboard*)> m_Conditionals;
+			std::vector<bool(*)(Blackboard*)> m_ObservingConditionals;
+			std::vector<BehaviorState(*)(Blackboard*)> m_Actions;
+			unsigned int m_InputSlot = 0;
+			unsigned int m_LeafBudget = 0;
+		};
+
+		//A tree of its own blackboard with the input added, built from 'seed'
+		inline BehaviorTree* CreateRandomBehaviorTree(unsigned int seed, unsigned int leafCount, bool isCompiled, bool isResumeExact = false)
+		{
+			Blackboard* pBlackboard = new Blackboard();
+			pBlackboard->AddData(GetRandomTreeInputName(), 0u);
+			RandomBehaviorTreeBuilder builder(seed, isResumeExact);
+			BehaviorTree* pTree = new BehaviorTree(pBlackboard, builder.Build(pBlackboard, leafCount));
+			if (isCompiled)
+				pTree->Compile();
+			return pTree;
+		}
+	}
+}
+#endif
@@ -0,0 +1,167 @@
+//Several BehaviorTrees running one BehaviorTreeDefinition: a cooldown and a coroutine action keep their state per tree,
+//one agent's running action continues while another's is aborted, and one agent's cooldown doesn't hold back another.
+//The plugin's exam tree is shareable, agents deciding with one definition of it each decide on their own perception.
+//Build: cl /std:c++20 /O2 /EHsc /I.. SharedBehaviorTreeDefinitionTest.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp ../SteeringBehaviors.cpp
+//       g++ -std=c++20 -O2 -pthread -I.. SharedBehaviorTreeDefinitionTest.cpp ../EBehaviorTree.cpp ../EBehaviorCoroutine.cpp ../ETimingWheel.cpp ../SteeringBehaviors.cpp
+//Needs the plugin's include paths, the behaviors are built on its precompiled header and the exam interface.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include <memory>
+#include "ExamAgentWorld.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const unsigned int AgentCount = 2;
+
+	unsigned int g_EscapeCounts[AgentCount] = {}; //Per agent, the one in its blackboard's "Id"
+	unsigned int g_LootStartCounts[AgentCount] = {};
+	unsigned int g_LootSteps[AgentCount] = {}; //Steps the agent's current loot got through
+
+	unsigned int GetId(Blackboard* pBlackboard)
+	{
+		unsigned int id = 0;
+		pBlackboard->TryGetData("Id", id);
+		return id;
+	}
+
+	bool IsThreatened(Blackboard* pBlackboard)
+	{
+		bool isThreatened = false;
+		pBlackboard->TryGetData("Threat", isThreatened);
+		return isThreatened;
+	}
+
+	BehaviorState Escape(Blackboard* pBlackboard)
+	{
+		++g_EscapeCounts[GetId(pBlackboard)];
+		return Success;
+	}
+
+	//Takes three ticks
+	BehaviorTask Loot(Blackboard* pBlackboard)
+	{
+		const unsigned int id = GetId(pBlackboard);
+		++g_LootStartCounts[id];
+		for (g_LootSteps[id] = 1; g_LootSteps[id] < 3; ++g_LootSteps[id])
+			co_await NextTick{};
+		co_return Success;
+	}
+
+	//Escapes when threatened, at most once a second, loots otherwise
+	std::shared_ptr<const BehaviorTreeDefinition> CreateDefinition()
+	{
+		return std::make_shared<const BehaviorTreeDefinition>(
+			new BehaviorSelector(
+				{
+					new BehaviorSequence({ new BehaviorConditional(IsThreatened), new BehaviorCooldown(new BehaviorAction(Escape), 1.f) }),
+					new BehaviorCoroutine(Loot)
+				}));
+	}
+
+	BehaviorTree* CreateAgentTree(const std::shared_ptr<const BehaviorTreeDefinition>& pDefinition, unsigned int id)
+	{
+		Blackboard* pBlackboard = new Blackboard();
+		pBlackboard->AddData("Id", id);
+		pBlackboard->AddData("Threat", false);
+		return new BehaviorTree(pBlackboard, pDefinition);
+	}
+
+	void TestIndependentState()
+	{
+		const std::shared_ptr<const BehaviorTreeDefinition> pDefinition = CreateDefinition();
+		ELITE_CHECK(pDefinition->IsShareable());
+		ELITE_CHECK(pDefinition->GetDecoratorCount() == 1 && pDefinition->GetInstanceCount() == 1);
+
+		const unsigned int usedBlocks = CoroutineFramePool::GetUsedBlockCount();
+		BehaviorTree* pTrees[AgentCount] = { CreateAgentTree(pDefinition, 0), CreateAgentTree(pDefinition, 1) };
+		auto tick = [&pTrees]()
+			{
+				for (BehaviorTree* pTree : pTrees)
+					pTree->Update(0.1f);
+			};
+
+		//Both start looting, each in a frame of its own
+		tick();
+		ELITE_CHECK(g_LootStartCounts[0] == 1 && g_LootStartCounts[1] == 1);
+		ELITE_CHECK(CoroutineFramePool::GetUsedBlockCount() == usedBlocks + 2);
+
+		//The second one escapes, its loot is aborted, the first one's continues
+		pTrees[1]->GetBlackboard()->TryChangeData("Threat", true);
+		tick();
+		ELITE_CHECK(g_EscapeCounts[0] == 0 && g_EscapeCounts[1] == 1);
+		ELITE_CHECK(g_LootSteps[0] == 2);
+		ELITE_CHECK(CoroutineFramePool::GetUsedBlockCount() == usedBlocks + 1);
+
+		//Its cooldown keeps it from escaping again, it loots from the start. The first one finished its loot.
+		tick();
+		ELITE_CHECK(g_EscapeCounts[1] == 1);
+		ELITE_CHECK(g_LootStartCounts[0] == 1 && g_LootSteps[0] == 3);
+		ELITE_CHECK(g_LootStartCounts[1] == 2 && g_LootSteps[1] == 1);
+
+		//The second one's cooldown doesn't hold back the first one
+		pTrees[0]->GetBlackboard()->TryChangeData("Threat", true);
+		tick();
+		ELITE_CHECK(g_EscapeCounts[0] == 1 && g_EscapeCounts[1] == 1);
+		ELITE_CHECK(g_LootSteps[1] == 2);
+
+		//Deleting a tree gives its running action's frame back, the definition goes with the last tree
+		delete pTrees[1];
+		ELITE_CHECK(CoroutineFramePool::GetUsedBlockCount() == usedBlocks);
+		delete pTrees[0];
+	}
+
+	//One tired, one bitten with stamina left and one with nothing going on, on the same definition
+	void TestExamTree()
+	{
+		const unsigned int examAgentCount = 3;
+		Test::ExamAgent agents[examAgentCount];
+		Blackboard* pBlackboards[examAgentCount] = {};
+		for (unsigned int i = 0; i < examAgentCount; ++i)
+			pBlackboards[i] = Test::CreateExamBlackboard(agents[i]);
+
+		//The conditionals resolve the keys they observe when built, after the blackboard is laid out
+		const std::shared_ptr<const BehaviorTreeDefinition> pDefinition = std::make_shared<const BehaviorTreeDefinition>(CreateExamBehavior());
+		ELITE_CHECK(pDefinition->IsShareable());
+		ELITE_CHECK(pDefinition->GetDecoratorCount() == 3 && pDefinition->GetInstanceCount() == 1);
+
+		AgentInfo perceptions[examAgentCount] = {};
+		perceptions[0].Stamina = 0.f;
+		perceptions[0].RunMode = true;
+		perceptions[1].Stamina = 5.f;
+		perceptions[1].Bitten = true;
+		perceptions[2].Stamina = 5.f;
+		perceptions[2].RunMode = true;
+		for (unsigned int i = 0; i < examAgentCount; ++i)
+		{
+			agents[i].pTree = new BehaviorTree(pBlackboards[i], pDefinition);
+			agents[i].pSteering = nullptr;
+			agents[i].pAngular = nullptr;
+			pBlackboards[i]->TryChangeData(BlackboardKeys::Agent, perceptions[i]);
+			pBlackboards[i]->TryChangeData(BlackboardKeys::FleeTarget, Vector2{ 10.f, 0.f });
+			agents[i].pTree->Update(0.1f);
+		}
+
+		AgentInfo agent = {};
+		//Tired: stops running, no steering chosen
+		ELITE_CHECK(pBlackboards[0]->TryGetData(BlackboardKeys::Agent, agent) && !agent.RunMode);
+		ELITE_CHECK(agents[0].pSteering == nullptr);
+		//Bitten: runs away from the flee target
+		ELITE_CHECK(pBlackboards[1]->TryGetData(BlackboardKeys::Agent, agent) && agent.RunMode);
+		ELITE_CHECK(agents[1].pSteering == &agents[1].flee);
+		//Nothing to do: wanders and scouts, the run mode stays as it was
+		ELITE_CHECK(pBlackboards[2]->TryGetData(BlackboardKeys::Agent, agent) && agent.RunMode);
+		ELITE_CHECK(agents[2].pSteering == &agents[2].wander && agents[2].pAngular == &agents[2].scout);
+	}
+}
+
+int main()
+{
+	TestIndependentState();
+	TestExamTree();
+	return Test::Finish("SharedBehaviorTreeDefinitionTest");
+}
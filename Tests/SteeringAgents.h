@@ -0,0 +1,102 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// SteeringAgents.h: Random agents as the structure of arrays the batch steering behaviors read, for the
+// tests and benchmarks of CalculateSteeringBatch. The lanes a batch runs on follow from its size: batches
+// of one agent run the scalar lanes, of four the SSE lanes and of eight the AVX2 lanes, when compiled in.
+/*=============================================================================*/
+#ifndef ELITE_TEST_STEERING_AGENTS
+#define ELITE_TEST_STEERING_AGENTS
+
+//--- Includes ---
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "SteeringBehaviors.h"
+
+namespace Elite
+{
+	namespace Test
+	{
+		struct SteeringAgents
+		{
+			std::vector<float> PositionX = {};
+			std::vector<float> PositionY = {};
+			std::vector<float> TargetX = {};
+			std::vector<float> TargetY = {};
+			std::vector<float> TargetVelocityX = {};
+			std::vector<float> TargetVelocityY = {};
+			std::vector<float> MaxSpeed = {};
+			std::vector<float> LinearVelocityX = {};
+			std::vector<float> LinearVelocityY = {};
+
+			size_t GetCount() const
+			{ return PositionX.size(); }
+
+			//Agents [first, first + count)
+			SteeringBatch GetBatch(size_t first, size_t count)
+			{
+				SteeringBatch batch = {};
+				batch.pPositionX = PositionX.data() + first;
+				batch.pPositionY = PositionY.data() + first;
+				batch.pTargetX = TargetX.data() + first;
+				batch.pTargetY = TargetY.data() + first;
+				batch.pTargetVelocityX = TargetVelocityX.data() + first;
+				batch.pTargetVelocityY = TargetVelocityY.data() + first;
+				batch.pMaxSpeed = MaxSpeed.data() + first;
+				batch.pLinearVelocityX = LinearVelocityX.data() + first;
+				batch.pLinearVelocityY = LinearVelocityY.data() + first;
+				batch.count = count;
+				return batch;
+			}
+		};
+
+		//Every eighth agent stands on its target, where the direction can't be normalized
+		inline void RandomizeSteeringAgents(std::mt19937& random, SteeringAgents& agents, size_t count)
+		{
+			std::uniform_real_distribution<float> position(-100.f, 100.f);
+			std::uniform_real_distribution<float> velocity(-10.f, 10.f);
+			std::uniform_real_distribution<float> maxSpeed(1.f, 15.f);
+
+			for (std::vector<float>* pArray : { &agents.PositionX, &agents.PositionY, &agents.TargetX, &agents.TargetY, &agents.TargetVelocityX,
+				&agents.TargetVelocityY, &agents.MaxSpeed, &agents.LinearVelocityX, &agents.LinearVelocityY })
+				pArray->assign(count, 0.f);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				agents.PositionX[i] = position(random);
+				agents.PositionY[i] = position(random);
+				const bool isOnTarget = random() % 8 == 0;
+				agents.TargetX[i] = isOnTarget ? agents.PositionX[i] : position(random);
+				agents.TargetY[i] = isOnTarget ? agents.PositionY[i] : position(random);
+				agents.TargetVelocityX[i] = velocity(random);
+				agents.TargetVelocityY[i] = velocity(random);
+				agents.MaxSpeed[i] = maxSpeed(random);
+			}
+		}
+
+		//CalculateSteering of every agent in turn, with its target set on the behavior, as the plugin does for one agent
+		template<typename TBehavior> void CalculateSteeringOneByOne(TBehavior& behavior, SteeringAgents& agents)
+		{
+			AgentInfo agent = {};
+			for (size_t i = 0; i < agents.GetCount(); ++i)
+			{
+				agent.Position = Vector2{ agents.PositionX[i], agents.PositionY[i] };
+				agent.MaxLinearSpeed = agents.MaxSpeed[i];
+				behavior.SetTargetPos(Vector2{ agents.TargetX[i], agents.TargetY[i] });
+				behavior.SetTargetLinVel(Vector2{ agents.TargetVelocityX[i], agents.TargetVelocityY[i] });
+				const SteeringPlugin_Output steering = behavior.CalculateSteering(0.f, &agent);
+				agents.LinearVelocityX[i] = steering.LinearVelocity.x;
+				agents.LinearVelocityY[i] = steering.LinearVelocity.y;
+			}
+		}
+
+		//CalculateSteeringBatch over all agents in batches of 'batchSize'
+		template<typename TBehavior> void CalculateSteeringInBatches(const TBehavior& behavior, SteeringAgents& agents, size_t batchSize)
+		{
+			for (size_t first = 0; first < agents.GetCount(); first += batchSize)
+				behavior.CalculateSteeringBatch(agents.GetBatch(first, (std::min)(batchSize, agents.GetCount() - first)));
+		}
+	}
+}
+#endif
@@ -0,0 +1,71 @@
+//Steering cost per agent of Seek, Flee, Arrive, Pursuit and Evade: CalculateSteering one agent at a time against
+//CalculateSteeringBatch on each kind of lanes. Batches of one run the scalar lanes, of four the SSE lanes and of eight
+//the AVX2 lanes, the whole batch runs the widest lanes compiled in.
+//Build: cl /std:c++20 /O2 /EHsc /I.. SteeringBatchBenchmark.cpp ../SteeringBehaviors.cpp
+//       g++ -std=c++20 -O2 -I.. SteeringBatchBenchmark.cpp ../SteeringBehaviors.cpp
+//Build it with /arch:AVX2 or -mavx2 as well, only then are the AVX2 lanes compiled in.
+//Needs the plugin's include paths, the behaviors are built on its precompiled header and the exam interface.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cstdio>
+#include "SteeringAgents.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const size_t TotalAgents = 1 << 21; //Per measurement, spread over the ticks
+
+	template<typename TBehavior> void Measure(const char* pName, TBehavior& behavior, Test::SteeringAgents& agents)
+	{
+		const size_t agentCount = agents.GetCount();
+		const unsigned int tickCount = static_cast<unsigned int>((std::max)(TotalAgents / agentCount, static_cast<size_t>(1)));
+		const double nsPerAgent = 1e9 / agentCount;
+
+		const double oneByOneSeconds = Test::MeasureSeconds(tickCount, [&](unsigned int) { Test::CalculateSteeringOneByOne(behavior, agents); });
+		printf("%-8s %-8zu %10.2f", pName, agentCount, oneByOneSeconds * nsPerAgent);
+		for (size_t batchSize : { static_cast<size_t>(1), static_cast<size_t>(4), static_cast<size_t>(8), agentCount })
+		{
+			const double batchSeconds = Test::MeasureSeconds(tickCount, [&](unsigned int) { Test::CalculateSteeringInBatches(behavior, agents, batchSize); });
+			printf(" %10.2f", batchSeconds * nsPerAgent);
+		}
+		printf(" \n");
+		Test::KeepAlive(agents.LinearVelocityX[agentCount / 2]);
+	}
+}
+
+int main()
+{
+#if defined(__AVX2__)
+	printf("lanes: scalar, SSE, AVX2 \n");
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+	printf("lanes: scalar, SSE (batches of 8 and the whole batch run SSE) \n");
+#else
+	printf("lanes: scalar (every batch runs the scalar lanes) \n");
+#endif
+	printf("ns per agent \n");
+	printf("%-8s %-8s %10s %10s %10s %10s %10s \n", "behavior", "agents", "one by one", "batch 1", "batch 4", "batch 8", "batch all");
+
+	Seek seek;
+	Flee flee;
+	Arrive arrive;
+	arrive.SetSlowRadius(15.f);
+	Pursuit pursuit;
+	Evade evade;
+	evade.SetEvadeRadius(60.f);
+
+	std::mt19937 random(23);
+	for (size_t agentCount : { 10000u, 100000u })
+	{
+		Test::SteeringAgents agents;
+		Test::RandomizeSteeringAgents(random, agents, agentCount);
+		Measure("Seek", seek, agents);
+		Measure("Flee", flee, agents);
+		Measure("Arrive", arrive, agents);
+		Measure("Pursuit", pursuit, agents);
+		Measure("Evade", evade, agents);
+	}
+	return Test::Finish("SteeringBatchBenchmark");
+}
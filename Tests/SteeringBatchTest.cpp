@@ -0,0 +1,82 @@
+//CalculateSteeringBatch of Seek, Flee, Arrive, Pursuit and Evade against their CalculateSteering one agent at a time,
+//over 10007 agents on every kind of lanes: batches of one run the scalar lanes, of four the SSE lanes and of eight the
+//AVX2 lanes, the whole batch runs the widest lanes with the rest on the narrower ones.
+//Build: cl /std:c++20 /O2 /EHsc /I.. SteeringBatchTest.cpp ../SteeringBehaviors.cpp
+//       g++ -std=c++20 -O2 -I.. SteeringBatchTest.cpp ../SteeringBehaviors.cpp
+//Build it with /arch:AVX2 or -mavx2 as well, only then are the AVX2 lanes compiled in.
+//Needs the plugin's include paths, the behaviors are built on its precompiled header and the exam interface.
+
+//=== General Includes ===
+#include "stdafx.h"
+#include <cmath>
+#include <cstdio>
+#include "SteeringAgents.h"
+#include "TestUtilities.h"
+
+using namespace Elite;
+
+namespace
+{
+	const size_t AgentCount = 10007; //Not a multiple of four or eight, so every run of the whole batch ends on narrower lanes
+
+	//Largest difference to the expected velocities, relative to their size where they're larger than one
+	float GetMaxError(const Test::SteeringAgents& agents, const std::vector<float>& expectedX, const std::vector<float>& expectedY)
+	{
+		float maxError = 0.f;
+		for (size_t i = 0; i < agents.GetCount(); ++i)
+		{
+			const float errorX = fabsf(agents.LinearVelocityX[i] - expectedX[i]) / (std::max)(fabsf(expectedX[i]), 1.f);
+			const float errorY = fabsf(agents.LinearVelocityY[i] - expectedY[i]) / (std::max)(fabsf(expectedY[i]), 1.f);
+			maxError = (std::max)(maxError, (std::max)(errorX, errorY));
+		}
+		return maxError;
+	}
+
+	template<typename TBehavior> void TestBehavior(const char* pName, TBehavior& behavior, Test::SteeringAgents& agents)
+	{
+		Test::CalculateSteeringOneByOne(behavior, agents);
+		const std::vector<float> expectedX = agents.LinearVelocityX;
+		const std::vector<float> expectedY = agents.LinearVelocityY;
+
+		for (size_t batchSize : { static_cast<size_t>(1), static_cast<size_t>(4), static_cast<size_t>(8), AgentCount })
+		{
+			std::fill(agents.LinearVelocityX.begin(), agents.LinearVelocityX.end(), NAN);
+			std::fill(agents.LinearVelocityY.begin(), agents.LinearVelocityY.end(), NAN);
+			Test::CalculateSteeringInBatches(behavior, agents, batchSize);
+
+			const float maxError = GetMaxError(agents, expectedX, expectedY);
+			printf("%-8s batches of %-6zu max relative error %.2e \n", pName, batchSize, maxError);
+			ELITE_CHECK(maxError <= 1e-5f); //Also fails on NaN, where an agent wasn't written
+		}
+	}
+}
+
+int main()
+{
+#if defined(__AVX2__)
+	printf("lanes: scalar, SSE, AVX2 \n");
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+	printf("lanes: scalar, SSE (build with AVX2 enabled for the AVX2 lanes) \n");
+#else
+	printf("lanes: scalar \n");
+#endif
+
+	std::mt19937 random(21);
+	Test::SteeringAgents agents;
+	Test::RandomizeSteeringAgents(random, agents, AgentCount);
+
+	Seek seek;
+	Flee flee;
+	Arrive arrive;
+	arrive.SetSlowRadius(15.f);
+	Pursuit pursuit;
+	Evade evade;
+	evade.SetEvadeRadius(60.f); //About half the agents are within it
+	TestBehavior("Seek", seek, agents);
+	TestBehavior("Flee", flee, agents);
+	TestBehavior("Arrive", arrive, agents);
+	TestBehavior("Pursuit", pursuit, agents);
+	TestBehavior("Evade", evade, agents);
+
+	return Test::Finish("SteeringBatchTest");
+}
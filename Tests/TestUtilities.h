@@ -0,0 +1,73 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+/*=============================================================================*/
+// TestUtilities.h: Checks and timing shared by the test and benchmark programs in this folder.
+// Every program is a single translation unit with its own main, built next to the plugin with
+// the same include paths (see the build line at the top of each). Tests return non-zero when
+// a check failed, benchmarks print their timings.
+/*=============================================================================*/
+#ifndef ELITE_TEST_UTILITIES
+#define ELITE_TEST_UTILITIES
+
+//--- Includes ---
+#include <chrono>
+#include <cstdio>
+
+namespace Elite
+{
+	namespace Test
+	{
+		inline unsigned int& GetFailureCount()
+		{
+			static unsigned int failureCount = 0;
+			return failureCount;
+		}
+
+		inline bool Check(bool condition, const char* pExpression, const char* pFile, int line)
+		{
+			if (!condition)
+			{
+				printf("FAILED: %s (%s:%d) \n", pExpression, pFile, line);
+				++GetFailureCount();
+			}
+			return condition;
+		}
+
+		//Exit code of a test program
+		inline int Finish(const char* pName)
+		{
+			if (GetFailureCount() == 0)
+				printf("%s: all checks passed \n", pName);
+			else
+				printf("%s: %u checks failed \n", pName, GetFailureCount());
+			return GetFailureCount() == 0 ? 0 : 1;
+		}
+
+		//Keeps the compiler from dropping work whose result is otherwise unused, for numbers and pointers
+		template<typename T> void KeepAlive(T value)
+		{
+			static volatile T sink = {};
+			sink = value;
+			(void)sink;
+		}
+
+		//Seconds one call of 'function' takes, the best of 'repeatCount' runs of 'callCount' calls
+		template<typename TFunction> double MeasureSeconds(unsigned int callCount, TFunction function, unsigned int repeatCount = 5)
+		{
+			double best = 0.0;
+			for (unsigned int repeat = 0; repeat < repeatCount; ++repeat)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				for (unsigned int i = 0; i < callCount; ++i)
+					function(i);
+				const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / callCount;
+				if (repeat == 0 || seconds < best)
+					best = seconds;
+			}
+			return best;
+		}
+	}
+}
+
+#define ELITE_CHECK(condition) Elite::Test::Check((condition), #condition, __FILE__, __LINE__)
+#endif